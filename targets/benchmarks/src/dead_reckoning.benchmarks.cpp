@@ -0,0 +1,23 @@
+#include <benchmark/benchmark.h>
+
+#include "TT/dead_reckoning.h"
+
+/// Dead reckons a store in which the second argument is the percentage of rotating body frame entities
+static void BM_AdvanceDeadReckoning(benchmark::State& state) {
+    tt::EntityStore store;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        tt::rpr_fom::PhysicalEntity entity;
+        entity.Spatial.DeadReckoningAlgorithm = i % 100 < state.range(1)
+            ? tt::rpr_fom::DeadReckoningAlgorithmEnum8::DRM_RVB
+            : tt::rpr_fom::DeadReckoningAlgorithmEnum8::DRM_FVW;
+        entity.Spatial.SpatialRVW.VelocityVector = {100, 0, 0};
+        entity.Spatial.SpatialRVW.AngularVelocity = {0, 0, 0.1f};
+        store.add(entity);
+    }
+
+    for (auto _ : state) {
+        tt::advanceDeadReckoning(store, 0.01);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AdvanceDeadReckoning)->ArgsProduct({{1000, 100000}, {0, 10}});
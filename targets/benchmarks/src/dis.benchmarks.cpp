@@ -0,0 +1,27 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "TT/dis.h"
+
+static void BM_DisDecodeEntityState(benchmark::State& state) {
+    constexpr size_t pduCount = 1024;
+    std::vector<uint8_t> pdus(pduCount * tt::dis::entityStatePduSize);
+    tt::dis::EntityState entityState;
+    for (size_t i = 0; i < pduCount; ++i) {
+        entityState.entity.EntityIdentifier.EntityNumber = static_cast<uint16_t>(i);
+        tt::dis::encodeEntityState(entityState, pdus.data() + i * tt::dis::entityStatePduSize,
+                                   tt::dis::entityStatePduSize);
+    }
+
+    std::vector<tt::dis::EntityState> decoded(pduCount);
+    for (auto _ : state) {
+        for (size_t i = 0; i < pduCount; ++i) {
+            tt::dis::decodeEntityState(pdus.data() + i * tt::dis::entityStatePduSize, tt::dis::entityStatePduSize,
+                                       decoded[i]);
+        }
+        benchmark::DoNotOptimize(decoded.data());
+    }
+    state.SetItemsProcessed(state.iterations() * pduCount);
+}
+BENCHMARK(BM_DisDecodeEntityState);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "TT/geodesy.h"
+
+namespace {
+    /// Positions of entities spread over the globe, in the column layout of EntityStore
+    struct Positions {
+        explicit Positions(const size_t count) :
+            latitudes(count), longitudes(count), altitudes(count), x(count), y(count), z(count) {
+            std::mt19937 generator(1);
+            std::uniform_real_distribution<double> latitudeDistribution(-M_PI_2, M_PI_2);
+            std::uniform_real_distribution<double> longitudeDistribution(-M_PI, M_PI);
+            std::uniform_real_distribution<double> altitudeDistribution(0, 15000);
+            for (size_t i = 0; i < count; ++i) {
+                latitudes[i] = latitudeDistribution(generator);
+                longitudes[i] = longitudeDistribution(generator);
+                altitudes[i] = altitudeDistribution(generator);
+            }
+            tt::math::geodeticToEcef(latitudes.data(), longitudes.data(), altitudes.data(), count, x.data(), y.data(),
+                                     z.data());
+        }
+
+        std::vector<double> latitudes;
+
+        std::vector<double> longitudes;
+
+        std::vector<double> altitudes;
+
+        std::vector<double> x;
+
+        std::vector<double> y;
+
+        std::vector<double> z;
+    };
+}
+
+static void BM_GeodeticToEcef(benchmark::State& state) {
+    const size_t count = state.range(0);
+    Positions positions(count);
+    for (auto _ : state) {
+        tt::math::geodeticToEcef(positions.latitudes.data(), positions.longitudes.data(), positions.altitudes.data(),
+                                 count, positions.x.data(), positions.y.data(), positions.z.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GeodeticToEcef)->Range(1000, 100000);
+
+static void BM_EcefToGeodetic(benchmark::State& state) {
+    const size_t count = state.range(0);
+    Positions positions(count);
+    for (auto _ : state) {
+        tt::math::ecefToGeodetic(positions.x.data(), positions.y.data(), positions.z.data(), count,
+                                 positions.latitudes.data(), positions.longitudes.data(), positions.altitudes.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EcefToGeodetic)->Range(1000, 100000);
@@ -0,0 +1,142 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "TT/model_radar.h"
+#include "TT/model_spatial_index.h"
+
+namespace {
+    /// Scatters entities uniformly in a cube around the ownship, roughly a quarter of them within radar range
+    void addEntities(tt::simship::EnvironmentChannel& environmentChannel, const int64_t count) {
+        std::mt19937 random(42);
+        std::uniform_real_distribution<double> coordinate(-20000, 20000);
+        const auto entities = environmentChannel.physicalEntities.getWriteHandle();
+        for (int64_t i = 0; i < count; ++i) {
+            tt::rpr_fom::PhysicalEntity entity;
+            entity.Spatial.SpatialRVW.WorldLocation = {coordinate(random), coordinate(random), coordinate(random)};
+            entities->add(entity);
+        }
+    }
+
+    /// Gives every entity a random orientation and one of 16 signatures of 5 degree resolution
+    void addSignatures(tt::simship::EnvironmentChannel& environmentChannel) {
+        std::mt19937 random(7);
+        std::uniform_real_distribution<float> sample(0.1f, 20);
+        const auto signatures = environmentChannel.radarCrossSections.getWriteHandle();
+        for (int16_t signature = 0; signature < 16; ++signature) {
+            std::vector<float> values(72 * 37);
+            for (float& value : values) {
+                value = sample(random);
+            }
+            signatures->add(signature, 72, 37, values);
+        }
+
+        std::uniform_real_distribution<float> angle(-3, 3);
+        const auto entities = environmentChannel.physicalEntities.getWriteHandle();
+        for (size_t index = 0; index < entities->size(); ++index) {
+            const tt::EntityHandle handle = entities->handleAt(index);
+            tt::rpr_fom::PhysicalEntity entity = entities->get(handle);
+            entity.Spatial.SpatialRVW.Orientation = {angle(random), angle(random) / 2, angle(random)};
+            entity.RadarCrossSectionSignatureIndex = static_cast<int16_t>(random() % 16);
+            entities->update(handle, entity);
+        }
+    }
+
+    void runRadar(benchmark::State& state, const bool useSpatialIndex, const bool useSignatures = false) {
+        tt::simship::OwnshipChannel ownshipChannel;
+        tt::simship::EnvironmentChannel environmentChannel;
+        tt::simship::RadarChannel radarChannel(state.range(0));
+        addEntities(environmentChannel, state.range(0));
+        if (useSignatures) {
+            addSignatures(environmentChannel);
+        }
+
+        // The index stays synchronised, as the entities do not change while the radar runs
+        tt::simship::SpatialIndexModel spatialIndex(environmentChannel);
+        if (useSpatialIndex) {
+            spatialIndex.run();
+        }
+        tt::simship::RadarModel radar(ownshipChannel, environmentChannel, radarChannel);
+        radar.load();
+        radar.init();
+
+        for (auto _ : state) {
+            radar.run();
+            radarChannel.echoes.clear();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+static void BM_RadarModelRun(benchmark::State& state) {
+    runRadar(state, false);
+}
+BENCHMARK(BM_RadarModelRun)->RangeMultiplier(10)->Range(10, 100000);
+
+static void BM_RadarModelRunSpatialIndex(benchmark::State& state) {
+    runRadar(state, true);
+}
+BENCHMARK(BM_RadarModelRunSpatialIndex)->RangeMultiplier(10)->Range(10, 100000);
+
+static void BM_RadarModelRunSignatures(benchmark::State& state) {
+    runRadar(state, true, true);
+}
+BENCHMARK(BM_RadarModelRunSignatures)->RangeMultiplier(10)->Range(10, 100000);
+
+namespace {
+    constexpr int radarCount = 8;
+
+    /// Radars spread over the heading of a single ownship, evaluated by one RadarModel each or by a RadarBatchModel
+    void runRadars(benchmark::State& state, const bool batched) {
+        std::vector<std::unique_ptr<tt::simship::OwnshipChannel>> ownshipChannels;
+        std::vector<std::unique_ptr<tt::simship::RadarChannel>> radarChannels;
+        tt::simship::EnvironmentChannel environmentChannel;
+        addEntities(environmentChannel, state.range(0));
+        tt::simship::SpatialIndexModel spatialIndex(environmentChannel);
+        spatialIndex.run();
+
+        std::vector<std::unique_ptr<tt::simship::RadarModel>> radars;
+        tt::simship::RadarBatchModel batch(environmentChannel);
+        for (int i = 0; i < radarCount; ++i) {
+            ownshipChannels.push_back(std::make_unique<tt::simship::OwnshipChannel>());
+            const double heading = i * 2 * M_PI / radarCount;
+            *ownshipChannels.back()->aircraftRotation.getWriteHandle() = Eigen::Vector3d(0, 0, heading);
+            ownshipChannels.back()->aircraftRotation.publish();
+            radarChannels.push_back(std::make_unique<tt::simship::RadarChannel>(state.range(0)));
+            if (batched) {
+                batch.addRadar(*ownshipChannels.back(), *radarChannels.back());
+            } else {
+                radars.push_back(std::make_unique<tt::simship::RadarModel>(*ownshipChannels.back(), environmentChannel,
+                                                                           *radarChannels.back()));
+                radars.back()->load();
+            }
+        }
+        batch.load();
+
+        for (auto _ : state) {
+            if (batched) {
+                batch.run();
+            } else {
+                for (const auto& radar : radars) {
+                    radar->run();
+                }
+            }
+            for (const auto& radarChannel : radarChannels) {
+                radarChannel->echoes.clear();
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0) * radarCount);
+    }
+}
+
+static void BM_RadarModelRunSeparate(benchmark::State& state) {
+    runRadars(state, false);
+}
+BENCHMARK(BM_RadarModelRunSeparate)->RangeMultiplier(10)->Range(1000, 100000);
+
+static void BM_RadarBatchModelRun(benchmark::State& state) {
+    runRadars(state, true);
+}
+BENCHMARK(BM_RadarBatchModelRun)->RangeMultiplier(10)->Range(1000, 100000);
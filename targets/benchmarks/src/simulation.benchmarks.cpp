@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "TT/simulation.h"
+
+namespace {
+    class EmptyModel final : public tt::Model {
+    public:
+        EmptyModel() :
+            Model("Empty", 0) {
+        }
+
+        bool run() override {
+            return true;
+        }
+    };
+
+    /// Steps a free running simulation of empty models, so only the scheduling overhead is measured
+    void stepSimulation(benchmark::State& state, const tt::Simulation::ExecutionMode mode) {
+        std::vector<std::unique_ptr<EmptyModel>> models;
+        tt::Simulation simulation;
+        simulation.setClockMode(tt::Simulation::FreeRunning);
+        simulation.setExecutionMode(mode, 4);
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            models.push_back(std::make_unique<EmptyModel>());
+            simulation.addModel(*models.back());
+        }
+        simulation.setTargetState(tt::Simulation::Running);
+        simulation.step(); // load
+        simulation.step(); // init
+
+        for (auto _ : state) {
+            simulation.step();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+static void BM_SimulationStepSequential(benchmark::State& state) {
+    stepSimulation(state, tt::Simulation::Sequential);
+}
+BENCHMARK(BM_SimulationStepSequential)->RangeMultiplier(4)->Range(1, 64);
+
+static void BM_SimulationStepParallel(benchmark::State& state) {
+    stepSimulation(state, tt::Simulation::Parallel);
+}
+BENCHMARK(BM_SimulationStepParallel)->RangeMultiplier(4)->Range(1, 64);
@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "TT/spatial_grid.h"
+
+namespace {
+    tt::rpr_fom::PhysicalEntity entityAt(std::mt19937& random) {
+        std::uniform_real_distribution<double> coordinate(-200000, 200000);
+        tt::rpr_fom::PhysicalEntity entity;
+        entity.Spatial.SpatialRVW.WorldLocation = {coordinate(random), coordinate(random), coordinate(random)};
+        return entity;
+    }
+
+    /// One frame in which one percent of the entities receive an update, and optionally every position is written
+    /// through the columns as dead reckoning does
+    void synchroniseFrames(benchmark::State& state, const bool writeAllPositions) {
+        std::mt19937 random(42);
+        tt::EntityStore store;
+        std::vector<tt::EntityHandle> handles;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            handles.push_back(store.add(entityAt(random)));
+        }
+        tt::SpatialGrid grid;
+        grid.synchronise(store);
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            for (size_t i = 0; i < handles.size() / 100; ++i) {
+                store.update(handles[random() % handles.size()], entityAt(random));
+            }
+            if (writeAllPositions) {
+                benchmark::DoNotOptimize(store.getPositions().x);
+            }
+            state.ResumeTiming();
+            grid.synchronise(store);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+static void BM_SpatialGridSynchroniseUpdates(benchmark::State& state) {
+    synchroniseFrames(state, false);
+}
+BENCHMARK(BM_SpatialGridSynchroniseUpdates)->RangeMultiplier(10)->Range(1000, 100000);
+
+static void BM_SpatialGridSynchroniseAllPositions(benchmark::State& state) {
+    synchroniseFrames(state, true);
+}
+BENCHMARK(BM_SpatialGridSynchroniseAllPositions)->RangeMultiplier(10)->Range(1000, 100000);
@@ -0,0 +1,32 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "TT/tracker.h"
+
+/// One scan of established tracks, with the targets scattered in a cube so their density grows with their number
+static void BM_TrackerUpdate(benchmark::State& state) {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> coordinate(-50000, 50000);
+    std::uniform_real_distribution<double> speed(-250, 250);
+    std::vector<Eigen::Vector3d> targets;
+    std::vector<Eigen::Vector3d> velocities;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        targets.emplace_back(coordinate(random), coordinate(random), coordinate(random) / 10);
+        velocities.emplace_back(speed(random), speed(random), 0);
+    }
+
+    tt::simship::Tracker tracker;
+    for (auto _ : state) {
+        for (size_t i = 0; i < targets.size(); ++i) {
+            targets[i] += velocities[i] * 0.1;
+        }
+        tracker.update(targets, 0.1);
+        benchmark::DoNotOptimize(tracker.getTracks().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TrackerUpdate)->RangeMultiplier(10)->Range(10, 100000);
@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "TT/transform.h"
+
+namespace {
+    /// Builds a chain of transforms, each the child of the previous one
+    std::vector<std::unique_ptr<tt::Transform>> makeChain(const int64_t depth) {
+        std::vector<std::unique_ptr<tt::Transform>> chain;
+        for (int64_t i = 0; i < depth; ++i) {
+            const tt::Transform* parent = chain.empty() ? nullptr : chain.back().get();
+            chain.push_back(std::make_unique<tt::Transform>(1, 2, 3, 0.1, 0.2, 0.3, parent));
+        }
+        return chain;
+    }
+}
+
+static void BM_TransformFromEuler(benchmark::State& state) {
+    double yaw = 0;
+    for (auto _ : state) {
+        tt::Transform xform(1000, 2000, 3000, 0.1, 0.2, yaw);
+        benchmark::DoNotOptimize(xform);
+        yaw += 1e-3;
+    }
+}
+BENCHMARK(BM_TransformFromEuler);
+
+static void BM_TransformToLocalTransform(benchmark::State& state) {
+    const auto chain = makeChain(state.range(0));
+    const tt::Transform target(10000, 200, 300, 0, 0.1, 0.5);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(chain.back()->toLocalTransform(target));
+    }
+}
+BENCHMARK(BM_TransformToLocalTransform)->Arg(1)->Arg(4);
+
+/// World transform of the leaf of a chain which did not move, served from the cache
+static void BM_TransformToWorldTransformCached(benchmark::State& state) {
+    const auto chain = makeChain(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(chain.back()->toWorldTransform());
+    }
+}
+BENCHMARK(BM_TransformToWorldTransformCached)->RangeMultiplier(4)->Range(1, 64);
+
+/// World transform of the leaf of a chain whose root moves every iteration, so the whole chain is recomputed
+static void BM_TransformToWorldTransformMoving(benchmark::State& state) {
+    const auto chain = makeChain(state.range(0));
+    double x = 0;
+    for (auto _ : state) {
+        chain.front()->setLocalTranslation({x, 0, 0});
+        benchmark::DoNotOptimize(chain.back()->toWorldTransform());
+        x += 1;
+    }
+}
+BENCHMARK(BM_TransformToWorldTransformMoving)->RangeMultiplier(4)->Range(1, 64);
+
+static void BM_TransformToLocalPositions(benchmark::State& state) {
+    const auto chain = makeChain(2);
+    const Eigen::Matrix3Xd world = Eigen::Matrix3Xd::Random(3, state.range(0)) * 10000;
+    Eigen::Matrix3Xd local(3, state.range(0));
+    for (auto _ : state) {
+        chain.back()->toLocalPositions(world, local);
+        benchmark::DoNotOptimize(local.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformToLocalPositions)->RangeMultiplier(10)->Range(10, 100000);
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace tt {
+    /// An allocator which aligns every allocation to the supplied boundary. The default of 64 bytes matches a cache
+    /// line and the widest SIMD registers, so columns of data can be loaded with aligned vector instructions.
+    template <typename T, std::size_t Alignment = 64>
+    class AlignedAllocator {
+    public:
+        using value_type = T;
+
+        template <typename U>
+        struct rebind {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        AlignedAllocator() noexcept = default;
+
+        template <typename U>
+        explicit AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {
+        }
+
+        T* allocate(const std::size_t count) {
+            return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        void deallocate(T* pointer, std::size_t) noexcept {
+            ::operator delete(pointer, std::align_val_t(Alignment));
+        }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept {
+            return false;
+        }
+    };
+
+    template <typename T>
+    using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <memory>
+#include <type_traits>
+
+namespace tt {
+    /// A value whose copies share one instance until one of them is written, so that copying e.g. a large column costs
+    /// as much as copying a pointer until the column changes.
+    ///
+    /// Copies may be read and written on different threads, but a copy must not be made or released while another
+    /// thread writes a copy sharing the same instance.
+    template <typename T>
+    class CopyOnWrite final {
+    public:
+        CopyOnWrite() :
+            value_(std::make_shared<T>()) {
+        }
+
+        [[nodiscard]] const T& read() const {
+            return *value_;
+        }
+
+        /// Gives the instance of this copy its own instance first if other copies share it.
+        ///
+        /// \return the value of this copy, for writing
+        T& write() {
+            if (value_.use_count() > 1) {
+                value_ = std::make_shared<T>(*value_);
+            }
+            return *value_;
+        }
+
+        /// \return true if this copy and the supplied one share an instance
+        [[nodiscard]] bool shares(const CopyOnWrite& other) const {
+            return value_ == other.value_;
+        }
+
+    private:
+        std::shared_ptr<T> value_;
+    };
+
+    /// True for types which are cheap to copy because their copies share their storage until written, e.g. through
+    /// CopyOnWrite members. Snapshots keep a copy of such bus data rather than serialising it.
+    template <typename T>
+    struct IsCopyOnWrite : std::false_type {
+    };
+
+    template <typename T>
+    constexpr bool isCopyOnWrite = IsCopyOnWrite<T>::value;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "entity_store.h"
+
+namespace tt {
+    /// Extrapolates the position and orientation of all entities in the store from the state they were last added or
+    /// updated with, according to their dead reckoning algorithm (RPR-FOM DeadReckoningAlgorithmEnum8):
+    ///
+    /// - Static and Other entities stay at their reference state
+    /// - F** algorithms keep the reference orientation, R** algorithms rotate it by the angular velocity
+    /// - *PW and *PB algorithms move at constant velocity, *VW and *VB algorithms also apply the acceleration
+    /// - **W algorithms interpret velocity and acceleration in world coordinates, **B algorithms in body coordinates
+    ///   of the entity, which rotate along with the entity for the R*B algorithms
+    ///
+    /// The angular velocity is always in body coordinates, as defined by DIS. Positions are computed in closed form
+    /// from the elapsed time, so the extrapolation does not drift with the frame rate. Frozen entities do not advance.
+    /// Velocity and acceleration keep their reference values.
+    ///
+    /// Translational extrapolation of all entities runs vectorised over the position columns, only the rotating and
+    /// body frame algorithms need a per entity rotation. If no entity moves, e.g. all of them are static or frozen,
+    /// positions are left alone so the change set of the store does not mark them.
+    ///
+    /// \param entities the entities to advance, see EntityStore::getReferencePositions
+    /// \param deltaTime seconds since the previous call
+    void advanceDeadReckoning(EntityStore& entities, double deltaTime);
+}
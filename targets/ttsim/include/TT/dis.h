@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "rpr_fom.h"
+
+/// Encoding and decoding of Distributed Interactive Simulation (IEEE 1278.1) PDUs.
+///
+/// The codec reads and writes the big endian wire format directly from and to the datagram buffer, without copying the
+/// PDU into an intermediate structure first.
+namespace tt::dis {
+    constexpr uint8_t protocolVersion = 7;
+
+    constexpr uint8_t entityStatePduType = 1;
+
+    constexpr uint8_t entityInformationFamily = 1;
+
+    constexpr size_t pduHeaderSize = 12;
+
+    /// size of an Entity State PDU without articulation parameters
+    constexpr size_t entityStatePduSize = 144;
+
+    constexpr size_t articulationParameterSize = 16;
+
+    /// Entity appearance bits, common to all entity kinds
+    constexpr uint32_t frozenAppearance = 1u << 21;
+
+    constexpr uint32_t deactivatedAppearance = 1u << 23;
+
+    /// The content of an Entity State PDU which is relevant to the simulation.
+    struct EntityState {
+        uint8_t exerciseIdentifier = 0;
+
+        /// DIS timestamp, units of 3600 / 2^31 seconds past the hour, the lowest bit set for absolute time
+        uint32_t timestamp = 0;
+
+        uint8_t forceIdentifier = 0;
+
+        /// appearance bits besides frozen and deactivated, which are mapped onto entity and deactivated
+        uint32_t appearance = 0;
+
+        /// true if the entity has left the exercise
+        bool deactivated = false;
+
+        /// Identifier, type, spatial and dead reckoning attributes. Velocity and acceleration are in world
+        /// coordinates for the **W and in body coordinates for the **B dead reckoning algorithms.
+        rpr_fom::PhysicalEntity entity;
+    };
+
+    /// Reads the length of the PDU at the start of the supplied buffer, e.g. to step through several PDUs bundled into
+    /// a single datagram.
+    ///
+    /// \param data the start of a PDU
+    /// \param size the number of bytes available
+    /// \return the length of the PDU in bytes, or 0 if the buffer does not hold a complete PDU header or the length is
+    ///         larger than the buffer
+    [[nodiscard]] size_t getPduLength(const uint8_t* data, size_t size);
+
+    /// \param data the start of a PDU with at least pduHeaderSize bytes
+    /// \return the PDU type field of the header
+    [[nodiscard]] uint8_t getPduType(const uint8_t* data);
+
+    /// Decodes an Entity State PDU. Fields which do not exist in DIS, like the radar cross section signature index,
+    /// are left untouched.
+    ///
+    /// \param data the start of the PDU
+    /// \param size the number of bytes available
+    /// \param state receives the decoded content
+    /// \return false if the data is not a complete Entity State PDU
+    bool decodeEntityState(const uint8_t* data, size_t size, EntityState& state);
+
+    /// Encodes an Entity State PDU without articulation parameters.
+    ///
+    /// \param state the content to encode
+    /// \param data receives the PDU
+    /// \param capacity the number of bytes available, at least entityStatePduSize
+    /// \return the number of bytes written, or 0 if the capacity is too small
+    size_t encodeEntityState(const EntityState& state, uint8_t* data, size_t capacity);
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "dis.h"
+#include "ring_buffer.h"
+
+namespace tt::dis {
+    /// Receives DIS Entity State PDUs on a UDP socket on a thread of its own.
+    ///
+    /// Datagrams are read in batches with recvmmsg, each may contain several bundled PDUs. Entity State PDUs are
+    /// decoded straight from the receive buffers and queued for a single consumer, e.g. a model applying them to the
+    /// simulation. Other PDU types are ignored. Updates are dropped and counted by the queue if the consumer does not
+    /// keep up.
+    class Receiver {
+    public:
+        /// \param updateCapacity the maximum number of decoded updates waiting to be consumed
+        explicit Receiver(size_t updateCapacity = 16384);
+
+        ~Receiver();
+
+        Receiver(const Receiver&) = delete;
+
+        Receiver& operator=(const Receiver&) = delete;
+
+        /// Binds the socket and starts the receiving thread.
+        ///
+        /// \param port the UDP port to receive on, 0 binds to a free port, see getPort
+        /// \param address the local IPv4 address to bind to, e.g. 127.0.0.1 for loopback only
+        /// \return false if the receiver is already running or the socket could not be bound
+        bool start(uint16_t port, const std::string& address = "0.0.0.0");
+
+        /// Stops the receiving thread and closes the socket. Queued updates remain available.
+        void stop();
+
+        [[nodiscard]] bool isRunning() const;
+
+        /// \return the port the socket is bound to, or 0 if not running
+        [[nodiscard]] uint16_t getPort() const;
+
+        /// \return the decoded updates, in the order they were received
+        [[nodiscard]] RingBuffer<EntityState>& getUpdates();
+
+        /// \return the number of Entity State PDUs decoded so far, including any dropped by the update queue
+        [[nodiscard]] uint64_t getEntityStateCount() const;
+
+        /// \return the number of PDUs which were not Entity State PDUs or malformed
+        [[nodiscard]] uint64_t getIgnoredCount() const;
+
+    private:
+        void receiveMain();
+
+        int socket_;
+
+        uint16_t port_;
+
+        std::atomic<bool> running_;
+
+        std::thread thread_;
+
+        RingBuffer<EntityState> updates_;
+
+        std::atomic<uint64_t> entityStates_;
+
+        std::atomic<uint64_t> ignored_;
+    };
+}
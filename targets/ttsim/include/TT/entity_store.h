@@ -0,0 +1,403 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "aligned_allocator.h"
+#include "copy_on_write.h"
+#include "rpr_fom.h"
+#include "serialisation.h"
+
+namespace tt {
+    /// A stable reference to an entity in an EntityStore. Handles stay valid while other entities are added or
+    /// removed, and become invalid once the entity they refer to is removed, even if its slot is reused.
+    struct EntityHandle {
+        static constexpr uint32_t invalidSlot = std::numeric_limits<uint32_t>::max();
+
+        uint32_t slot = invalidSlot;
+
+        uint32_t generation = 0;
+
+        [[nodiscard]] bool isValid() const {
+            return slot != invalidSlot;
+        }
+
+        bool operator==(const EntityHandle& other) const {
+            return slot == other.slot && generation == other.generation;
+        }
+
+        bool operator!=(const EntityHandle& other) const {
+            return !(*this == other);
+        }
+    };
+
+    /// Pointers to the x, y and z columns of a vector attribute of all entities in an EntityStore.
+    template <typename T>
+    struct ColumnView3 {
+        T* x;
+
+        T* y;
+
+        T* z;
+    };
+
+    /// The attributes of an entity, as bits of the dirty masks of an EntityChangeSet.
+    enum EntityField : uint32_t {
+        PositionField = 1 << 0,
+        OrientationField = 1 << 1,
+        VelocityField = 1 << 2,
+        AccelerationField = 1 << 3,
+        AngularVelocityField = 1 << 4,
+        IdentifierField = 1 << 5,
+        TypeField = 1 << 6,
+        RadarCrossSectionSignatureField = 1 << 7,
+        /// dead reckoning algorithm, frozen flag, reference state and dead reckoning time
+        DeadReckoningField = 1 << 8,
+        AllEntityFields = (1 << 9) - 1
+    };
+
+    /// A change of an entity since a revision of the store, see EntityChangeSet::forEachSince.
+    struct EntityChange {
+        enum Kind {
+            /// the entity is new, and in the store
+            Added,
+            /// the entity is gone, and its handle invalid
+            Removed,
+            /// the entity is in the store, and the attributes in fields may have changed
+            Updated
+        };
+
+        EntityHandle handle;
+
+        Kind kind = Updated;
+
+        /// EntityField bits of the attributes which changed, all of them for an added or removed entity
+        uint32_t fields = 0;
+    };
+
+    /// The changes made to an EntityStore, stamped with the revision of the store they were made in, so consumers such
+    /// as spatial indices can catch up from the revision they last saw with work proportional to the churn rather than
+    /// to the number of entities. Every consumer reads from its own revision, so consumers running at different rates
+    /// share one change set.
+    ///
+    /// Each entity appears at most once since any revision: an entity added and then updated is only added, and an
+    /// entity updated or added and then removed is only removed. Consumers may see changes again, e.g. the fields of
+    /// an update accumulate over a few revisions, and a removal of an entity they never saw is simply ignored. Writes
+    /// through the non-const column accessors of the store cannot be attributed to entities, and mark the attribute of
+    /// every entity instead, see getFieldsOfAll().
+    ///
+    /// The oldest changes are dropped once the changes outnumber the entities of the store, at which point visiting
+    /// every entity is cheaper for consumers anyway.
+    class EntityChangeSet {
+    public:
+        /// Tells whether a consumer which last looked at the store at the supplied revision may catch up from this
+        /// change set rather than visiting every entity.
+        ///
+        /// \param revision the revision of the store the consumer has seen
+        /// \return true if the change set holds every change made since the supplied revision
+        [[nodiscard]] bool covers(const uint64_t revision) const {
+            return baseRevision_ <= revision;
+        }
+
+        /// \return the oldest revision the change set covers
+        [[nodiscard]] uint64_t getBaseRevision() const {
+            return baseRevision_;
+        }
+
+        /// \param revision a revision the change set covers
+        /// \return the EntityField bits of the attributes which may have changed for every entity since the revision
+        [[nodiscard]] uint32_t getFieldsOfAll(uint64_t revision) const;
+
+        /// Visits every entity which changed since the supplied revision once, in the order the changes were made.
+        ///
+        /// \param revision a revision the change set covers
+        /// \param visitor called with the EntityChange of each entity
+        template <typename Visitor>
+        void forEachSince(const uint64_t revision, Visitor&& visitor) const {
+            const auto first = std::upper_bound(entries_.begin(), entries_.end(), revision,
+                                                [](const uint64_t value, const Entry& entry) {
+                                                    return value < entry.revision;
+                                                });
+            for (auto entry = first; entry != entries_.end(); ++entry) {
+                // A later entry of the same entity supersedes this one
+                if (!entry->removed && entryOfSlot_[entry->handle.slot] != entry - entries_.begin()) {
+                    continue;
+                }
+                EntityChange change{entry->handle, EntityChange::Updated, entry->fields};
+                if (entry->removed) {
+                    change.kind = EntityChange::Removed;
+                    change.fields = AllEntityFields;
+                }
+                else if (entry->addedRevision > revision) {
+                    change.kind = EntityChange::Added;
+                    change.fields = AllEntityFields;
+                }
+                visitor(change);
+            }
+        }
+
+        /// \return the number of changes held, including superseded ones
+        [[nodiscard]] size_t size() const {
+            return entries_.size();
+        }
+
+    private:
+        friend class EntityStore;
+
+        static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+        struct Entry {
+            EntityHandle handle;
+
+            /// EntityField bits of the attributes updated since the entity was added, or since the change set began
+            uint32_t fields;
+
+            bool removed;
+
+            /// revision of the latest change
+            uint64_t revision;
+
+            /// revision the entity was added in, or 0 if it was added before the change set began
+            uint64_t addedRevision;
+        };
+
+        void recordAdded(EntityHandle handle, uint64_t revision);
+
+        void recordRemoved(EntityHandle handle, uint64_t revision);
+
+        void recordUpdated(EntityHandle handle, uint32_t fields, uint64_t revision);
+
+        void recordFieldsOfAll(uint32_t fields, uint64_t revision);
+
+        /// Drops the superseded entries, and the oldest ones until no more than entityCount are left.
+        void compact(size_t entityCount);
+
+        /// Drops every change, so only consumers which have seen the supplied revision are covered.
+        void clear(uint64_t revision);
+
+        /// ordered by revision
+        std::vector<Entry> entries_;
+
+        /// position in entries_ of the latest entry of the entity in each slot, or none
+        std::vector<uint32_t> entryOfSlot_;
+
+        /// revision each EntityField bit was last marked for every entity in, by bit
+        std::array<uint64_t, 9> fieldsOfAllRevisions_{};
+
+        uint64_t baseRevision_ = 0;
+    };
+
+    /// A structure of arrays table of rpr_fom::PhysicalEntity.
+    ///
+    /// Each attribute is stored in its own contiguous, cache line aligned column, so that e.g. a sensor which only
+    /// needs positions streams through positions only. Entities are densely packed: the columns hold exactly size()
+    /// elements at indices 0 to size() - 1. Removing an entity moves the last entity into its place, so dense indices
+    /// are only valid until the next removal. Use EntityHandle to refer to an entity over a longer time.
+    ///
+    /// Adding, removing and looking up an entity by handle are O(1). Copies share the columns until either store
+    /// writes them, so copying a store, e.g. into a snapshot, does not copy the entities.
+    class EntityStore {
+    public:
+        EntityStore() = default;
+
+        /// Shares the columns of the supplied store until either store writes them. The copy has the revision of the
+        /// supplied store, but none of its changes.
+        ///
+        /// \param other the store to copy
+        EntityStore(const EntityStore& other);
+
+        /// Shares the columns of the supplied store until either store writes them. The revision moves past the
+        /// revisions of both stores and the changes are dropped, so consumers of this store start over.
+        ///
+        /// \param other the store to copy
+        /// \return this store
+        EntityStore& operator=(const EntityStore& other);
+
+        /// Adds a copy of the supplied entity.
+        ///
+        /// \param entity the entity to add
+        /// \return a handle to the new entity
+        EntityHandle add(const rpr_fom::PhysicalEntity& entity);
+
+        /// Removes the entity the handle refers to. The last entity is moved into the dense index of the removed one.
+        ///
+        /// \param handle the entity to remove
+        /// \return false if the handle does not refer to an entity in this store
+        bool remove(EntityHandle handle);
+
+        /// Overwrites all attributes of the entity the handle refers to. The change set records which of them changed.
+        ///
+        /// \param handle the entity to update
+        /// \param entity the new attribute values
+        /// \return false if the handle does not refer to an entity in this store
+        bool update(EntityHandle handle, const rpr_fom::PhysicalEntity& entity);
+
+        /// Removes all entities, invalidating all handles.
+        void clear();
+
+        [[nodiscard]] bool contains(EntityHandle handle) const;
+
+        /// Assembles a PhysicalEntity from the columns of the entity the handle refers to.
+        ///
+        /// \param handle an entity contained in this store
+        /// \return a copy of the entity
+        [[nodiscard]] rpr_fom::PhysicalEntity get(EntityHandle handle) const;
+
+        /// \param handle an entity contained in this store
+        /// \return the current dense index of the entity
+        [[nodiscard]] size_t indexOf(EntityHandle handle) const;
+
+        /// \param index a dense index smaller than size()
+        /// \return the handle of the entity at the supplied dense index
+        [[nodiscard]] EntityHandle handleAt(size_t index) const;
+
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] bool empty() const;
+
+        /// Gets a counter which changes whenever the store may have been modified. This includes every call of a
+        /// non-const column accessor, as the caller may write through the returned pointers.
+        ///
+        /// \return the current revision of the store
+        [[nodiscard]] uint64_t getRevision() const;
+
+        /// \return the changes made to the store, for consumers to catch up from the revision they last saw
+        [[nodiscard]] const EntityChangeSet& getChanges() const;
+
+        /// World location (ECEF, meters) of all entities.
+        [[nodiscard]] ColumnView3<const double> getPositions() const;
+
+        [[nodiscard]] ColumnView3<double> getPositions();
+
+        /// Orientation (Psi, Theta, Phi in radians) of all entities, stored as x = Psi, y = Theta and z = Phi.
+        [[nodiscard]] ColumnView3<const float> getOrientations() const;
+
+        [[nodiscard]] ColumnView3<float> getOrientations();
+
+        /// Velocity (meters per second) of all entities.
+        [[nodiscard]] ColumnView3<const float> getVelocities() const;
+
+        [[nodiscard]] ColumnView3<float> getVelocities();
+
+        /// Acceleration (meters per second squared) of all entities.
+        [[nodiscard]] ColumnView3<const float> getAccelerations() const;
+
+        [[nodiscard]] ColumnView3<float> getAccelerations();
+
+        /// Angular velocity (radians per second) of all entities.
+        [[nodiscard]] ColumnView3<const float> getAngularVelocities() const;
+
+        [[nodiscard]] ColumnView3<float> getAngularVelocities();
+
+        [[nodiscard]] const rpr_fom::EntityIdentifierStruct* getEntityIdentifiers() const;
+
+        [[nodiscard]] const rpr_fom::EntityTypeStruct* getEntityTypes() const;
+
+        [[nodiscard]] const int16_t* getRadarCrossSectionSignatureIndices() const;
+
+        [[nodiscard]] const rpr_fom::DeadReckoningAlgorithmEnum8* getDeadReckoningAlgorithms() const;
+
+        [[nodiscard]] const uint8_t* getFrozen() const;
+
+        /// World location of all entities when they were last added or updated, the origin of dead reckoning.
+        [[nodiscard]] ColumnView3<const double> getReferencePositions() const;
+
+        /// Orientation of all entities when they were last added or updated, in the layout of getOrientations.
+        [[nodiscard]] ColumnView3<const float> getReferenceOrientations() const;
+
+        /// Seconds each entity has been dead reckoned since it was last added or updated.
+        [[nodiscard]] const double* getDeadReckoningTimes() const;
+
+        [[nodiscard]] double* getDeadReckoningTimes();
+
+        /// Appends all entities and the state behind their handles, so a deserialised copy accepts the same handles.
+        ///
+        /// \param buffer the buffer to append to
+        void serialise(std::vector<uint8_t>& buffer) const;
+
+        /// Replaces the content of this store with entities appended by serialise().
+        ///
+        /// \param reader the serialised store
+        /// \return false if the data does not hold a consistent store, in which case this store is left empty
+        bool deserialise(ByteReader& reader);
+
+    private:
+        template <typename T>
+        struct Columns3 {
+            AlignedVector<T> x;
+
+            AlignedVector<T> y;
+
+            AlignedVector<T> z;
+        };
+
+        /// \return the EntityField bits of the attributes whose values changed
+        uint32_t write(size_t index, const rpr_fom::PhysicalEntity& entity);
+
+        /// Compacts the change set once it holds more than twice as many changes as the store holds entities.
+        void limitChanges();
+
+        /// Moves the entity at index from to index to, overwriting the entity at index to.
+        void move(size_t from, size_t to);
+
+        void resize(size_t size);
+
+        CopyOnWrite<Columns3<double>> positions_;
+
+        CopyOnWrite<Columns3<float>> orientations_;
+
+        CopyOnWrite<Columns3<float>> velocities_;
+
+        CopyOnWrite<Columns3<float>> accelerations_;
+
+        CopyOnWrite<Columns3<float>> angularVelocities_;
+
+        CopyOnWrite<AlignedVector<rpr_fom::EntityIdentifierStruct>> entityIdentifiers_;
+
+        CopyOnWrite<AlignedVector<rpr_fom::EntityTypeStruct>> entityTypes_;
+
+        CopyOnWrite<AlignedVector<int16_t>> radarCrossSectionSignatureIndices_;
+
+        CopyOnWrite<AlignedVector<rpr_fom::DeadReckoningAlgorithmEnum8>> deadReckoningAlgorithms_;
+
+        CopyOnWrite<AlignedVector<uint8_t>> frozen_;
+
+        CopyOnWrite<Columns3<double>> referencePositions_;
+
+        CopyOnWrite<Columns3<float>> referenceOrientations_;
+
+        CopyOnWrite<AlignedVector<double>> deadReckoningTimes_;
+
+        /// slot of the entity at each dense index
+        CopyOnWrite<std::vector<uint32_t>> slotOfIndex_;
+
+        /// dense index of the entity in each slot, or invalidSlot if the slot is free
+        CopyOnWrite<std::vector<uint32_t>> indexOfSlot_;
+
+        /// incremented each time a slot is freed, invalidating handles to the previous occupant
+        CopyOnWrite<std::vector<uint32_t>> generationOfSlot_;
+
+        CopyOnWrite<std::vector<uint32_t>> freeSlots_;
+
+        uint64_t revision_ = 0;
+
+        EntityChangeSet changes_;
+    };
+
+    template <>
+    struct Serialiser<EntityStore> {
+        static void write(const EntityStore& value, std::vector<uint8_t>& buffer) {
+            value.serialise(buffer);
+        }
+
+        static bool read(ByteReader& reader, EntityStore& value) {
+            return value.deserialise(reader);
+        }
+    };
+
+    template <>
+    struct IsCopyOnWrite<EntityStore> : std::true_type {
+    };
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <Eigen/Core>
+
+namespace tt::math {
+    /// WGS-84 ellipsoid
+    constexpr double wgs84SemiMajorAxis = 6378137.0; // meter
+
+    constexpr double wgs84Flattening = 1 / 298.257223563;
+
+    constexpr double wgs84EccentricitySquared = wgs84Flattening * (2 - wgs84Flattening);
+
+    constexpr double wgs84SemiMinorAxis = wgs84SemiMajorAxis * (1 - wgs84Flattening); // meter
+
+    /// A position relative to the WGS-84 ellipsoid.
+    struct GeodeticPosition {
+        double latitude = 0; // radian, geodetic
+
+        double longitude = 0; // radian
+
+        double altitude = 0; // meter above the ellipsoid
+    };
+
+    /// Converts a geodetic position into world (ECEF) space.
+    ///
+    /// \param latitude geodetic latitude in radians
+    /// \param longitude longitude in radians
+    /// \param altitude height above the ellipsoid in meters
+    /// \return the ECEF position in meters
+    inline Eigen::Vector3d geodeticToEcef(const double latitude, const double longitude, const double altitude) {
+        const double sinLatitude = std::sin(latitude);
+        const double cosLatitude = std::cos(latitude);
+        // Radius of curvature in the prime vertical
+        const double normal =
+            wgs84SemiMajorAxis / std::sqrt(1 - wgs84EccentricitySquared * sinLatitude * sinLatitude);
+        const double horizontal = (normal + altitude) * cosLatitude;
+        return {horizontal * std::cos(longitude), horizontal * std::sin(longitude),
+                (normal * (1 - wgs84EccentricitySquared) + altitude) * sinLatitude};
+    }
+
+    inline Eigen::Vector3d geodeticToEcef(const GeodeticPosition& position) {
+        return geodeticToEcef(position.latitude, position.longitude, position.altitude);
+    }
+
+    /// Converts a world (ECEF) position into a geodetic position with the closed form of Olson (1996), without
+    /// iterating. The error is below a micrometer and a nanoradian from an altitude of -4000 km, i.e. more than about
+    /// 2300 km from the center of the earth, out to geosynchronous orbit. Closer to the center the closed form loses
+    /// accuracy quickly, e.g. by millimeters at -6000 km and by hundreds of meters at -6300 km.
+    ///
+    /// \param x ECEF x in meters
+    /// \param y ECEF y in meters
+    /// \param z ECEF z in meters
+    /// \return the geodetic position. The center of the earth maps to latitude and longitude 0.
+    inline GeodeticPosition ecefToGeodetic(const double x, const double y, const double z) {
+        constexpr double a1 = wgs84SemiMajorAxis * wgs84EccentricitySquared;
+        constexpr double a2 = a1 * a1;
+        constexpr double a3 = a1 * wgs84EccentricitySquared / 2;
+        constexpr double a4 = 2.5 * a2;
+        constexpr double a5 = a1 + a3;
+        constexpr double a6 = 1 - wgs84EccentricitySquared;
+
+        const double w2 = x * x + y * y;
+        const double r2 = w2 + z * z;
+        if (r2 == 0) {
+            return {0, 0, -wgs84SemiMajorAxis};
+        }
+        const double w = std::sqrt(w2);
+        const double r = std::sqrt(r2);
+        const double absZ = std::abs(z);
+        const double s2 = z * z / r2;
+        const double c2 = w2 / r2;
+        double u = a2 / r;
+        double v = a3 - a4 / r;
+
+        // First estimate of the latitude, from whichever of its sine and cosine is better conditioned
+        double latitude;
+        double s;
+        double c;
+        double ss;
+        if (c2 > 0.3) {
+            s = (absZ / r) * (1 + c2 * (a1 + u + s2 * v) / r);
+            latitude = std::asin(s);
+            ss = s * s;
+            c = std::sqrt(1 - ss);
+        }
+        else {
+            c = (w / r) * (1 - s2 * (a5 - u - c2 * v) / r);
+            latitude = std::acos(c);
+            ss = 1 - c * c;
+            s = std::sqrt(ss);
+        }
+
+        // One correction step in closed form
+        const double g = 1 - wgs84EccentricitySquared * ss;
+        const double rg = wgs84SemiMajorAxis / std::sqrt(g);
+        const double rf = a6 * rg;
+        u = w - rg * c;
+        v = absZ - rf * s;
+        const double f = c * u + s * v;
+        const double m = c * v - s * u;
+        const double p = m / (rf / g + f);
+        latitude += p;
+        return {z < 0 ? -latitude : latitude, std::atan2(y, x), f + m * p / 2};
+    }
+
+    inline GeodeticPosition ecefToGeodetic(const Eigen::Vector3d& ecef) {
+        return ecefToGeodetic(ecef.x(), ecef.y(), ecef.z());
+    }
+
+    /// \param latitude geodetic latitude in radians
+    /// \param longitude longitude in radians
+    /// \return the rotation from the local North East Down frame at the supplied position to ECEF, whose columns are
+    ///         the north, east and down directions in ECEF
+    inline Eigen::Matrix3d getNedToEcef(const double latitude, const double longitude) {
+        const double sinLatitude = std::sin(latitude);
+        const double cosLatitude = std::cos(latitude);
+        const double sinLongitude = std::sin(longitude);
+        const double cosLongitude = std::cos(longitude);
+        Eigen::Matrix3d nedToEcef;
+        nedToEcef << -sinLatitude * cosLongitude, -sinLongitude, -cosLatitude * cosLongitude,
+            -sinLatitude * sinLongitude, cosLongitude, -cosLatitude * sinLongitude,
+            cosLatitude, 0, -sinLatitude;
+        return nedToEcef;
+    }
+
+    /// \param latitude geodetic latitude in radians
+    /// \param longitude longitude in radians
+    /// \return the rotation from the local East North Up frame at the supplied position to ECEF, whose columns are
+    ///         the east, north and up directions in ECEF
+    inline Eigen::Matrix3d getEnuToEcef(const double latitude, const double longitude) {
+        const double sinLatitude = std::sin(latitude);
+        const double cosLatitude = std::cos(latitude);
+        const double sinLongitude = std::sin(longitude);
+        const double cosLongitude = std::cos(longitude);
+        Eigen::Matrix3d enuToEcef;
+        enuToEcef << -sinLongitude, -sinLatitude * cosLongitude, cosLatitude * cosLongitude,
+            cosLongitude, -sinLatitude * sinLongitude, cosLatitude * sinLongitude,
+            0, cosLatitude, sinLatitude;
+        return enuToEcef;
+    }
+
+    /// Converts a world (ECEF) position into the local North East Down frame of an origin.
+    ///
+    /// \param ecef the position to convert, in meters
+    /// \param origin the geodetic position of the origin of the local frame
+    /// \return the position relative to the origin in north, east and down meters
+    inline Eigen::Vector3d ecefToNed(const Eigen::Vector3d& ecef, const GeodeticPosition& origin) {
+        return getNedToEcef(origin.latitude, origin.longitude).transpose() * (ecef - geodeticToEcef(origin));
+    }
+
+    /// Converts a world (ECEF) position into the local East North Up frame of an origin.
+    ///
+    /// \see ecefToNed
+    inline Eigen::Vector3d ecefToEnu(const Eigen::Vector3d& ecef, const GeodeticPosition& origin) {
+        return getEnuToEcef(origin.latitude, origin.longitude).transpose() * (ecef - geodeticToEcef(origin));
+    }
+
+    /// Converts geodetic positions into world (ECEF) space, in the column layout of EntityStore.
+    ///
+    /// \param latitudes geodetic latitudes in radians
+    /// \param longitudes longitudes in radians
+    /// \param altitudes heights above the ellipsoid in meters
+    /// \param count the number of positions
+    /// \param x receives the ECEF x coordinates in meters
+    /// \param y receives the ECEF y coordinates in meters
+    /// \param z receives the ECEF z coordinates in meters
+    void geodeticToEcef(const double* latitudes, const double* longitudes, const double* altitudes, size_t count,
+                        double* x, double* y, double* z);
+
+    /// Converts world (ECEF) positions into geodetic positions, in the column layout of EntityStore.
+    ///
+    /// \see ecefToGeodetic(double, double, double)
+    void ecefToGeodetic(const double* x, const double* y, const double* z, size_t count, double* latitudes,
+                        double* longitudes, double* altitudes);
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <Eigen/Core>
+
+#include "entity_store.h"
+#include "rpr_fom.h"
+#include "spatial_grid.h"
+
+namespace tt {
+    /// The part of the federation a subscriber is interested in: a volume of world (ECEF) space and, optionally, a set
+    /// of entity types.
+    struct InterestRegion {
+        enum Shape : uint8_t {
+            /// every entity, only filtered by type
+            Everywhere,
+            /// every entity within range of center
+            Sphere,
+            /// every entity within range of center and within halfAngle of axis, e.g. the volume of a sensor
+            Cone
+        };
+
+        Shape shape = Everywhere;
+
+        /// center of the sphere or apex of the cone, in world space
+        Eigen::Vector3d center = Eigen::Vector3d::Zero();
+
+        /// unit direction of the cone axis, in world space
+        Eigen::Vector3d axis = Eigen::Vector3d::UnitX();
+
+        double halfAngle = M_PI; // radian
+
+        double range = 0; // meter
+
+        /// Entity types of interest, where a field of 0 matches any value of that field. An empty list matches every
+        /// entity.
+        std::vector<rpr_fom::EntityTypeStruct> entityTypes;
+
+        static InterestRegion sphere(const Eigen::Vector3d& center, double range);
+
+        static InterestRegion cone(const Eigen::Vector3d& apex, const Eigen::Vector3d& axis, double halfAngle,
+                                   double range);
+
+        /// \return true if the entity type passes the type filter of the region
+        [[nodiscard]] bool matchesType(const rpr_fom::EntityTypeStruct& entityType) const;
+
+        bool operator==(const InterestRegion& other) const;
+
+        bool operator!=(const InterestRegion& other) const {
+            return !(*this == other);
+        }
+    };
+
+    /// The entities inside the region of a subscription, as of the latest synchronisation.
+    class InterestView {
+    public:
+        /// \return the dense indices of the entities in the view, sorted ascending
+        [[nodiscard]] const std::vector<uint32_t>& getIndices() const {
+            return indices_;
+        }
+
+        /// \return the handles of the entities in the view, in the order of getIndices()
+        [[nodiscard]] const std::vector<EntityHandle>& getHandles() const {
+            return handles_;
+        }
+
+        /// \return the revision of the store the view was synchronised with. Dense indices are only valid while the
+        ///         store is at this revision.
+        [[nodiscard]] uint64_t getRevision() const {
+            return revision_;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return indices_.size();
+        }
+
+    private:
+        friend class InterestManager;
+
+        std::vector<uint32_t> indices_;
+
+        std::vector<EntityHandle> handles_;
+
+        uint64_t revision_ = 0;
+    };
+
+    /// Filters the entities of an EntityStore per subscriber, similar to the data distribution management of HLA.
+    ///
+    /// Each subscription holds a region and a view of the entities inside it. Views are only rebuilt when either the
+    /// store or the region changed, and use the cells of a SpatialGrid to visit the entities near the region only, so
+    /// a subscriber pays for the entities it is interested in rather than for the whole federation. When only some
+    /// entities changed, views catch up from the change set of the store instead, testing just those entities.
+    class InterestManager {
+    public:
+        using SubscriptionId = uint32_t;
+
+        static constexpr SubscriptionId invalidSubscription = UINT32_MAX;
+
+        /// \param region the region of interest
+        /// \return the id of the new subscription, whose view is empty until the next synchronisation
+        SubscriptionId subscribe(const InterestRegion& region);
+
+        /// \return false if the id does not refer to a subscription
+        bool unsubscribe(SubscriptionId subscription);
+
+        /// Moves or reshapes the region of a subscription, e.g. to follow the platform of a sensor.
+        ///
+        /// \param subscription the subscription to change
+        /// \param region the new region of interest
+        /// \return false if the id does not refer to a subscription
+        bool setRegion(SubscriptionId subscription, const InterestRegion& region);
+
+        /// \return the region of the subscription, or nullptr if the id does not refer to a subscription
+        [[nodiscard]] const InterestRegion* getRegion(SubscriptionId subscription) const;
+
+        /// Brings the views of all subscriptions up to date with the supplied store.
+        ///
+        /// \param entities the store to filter
+        /// \param entityIndex a spatial index over the store, only used if it is synchronised with the store
+        void synchronise(const EntityStore& entities, const SpatialGrid& entityIndex);
+
+        /// \return the view of the subscription, or nullptr if the id does not refer to a subscription
+        [[nodiscard]] const InterestView* getView(SubscriptionId subscription) const;
+
+        /// \return the number of subscriptions
+        [[nodiscard]] size_t size() const;
+
+    private:
+        struct Subscription {
+            bool active = false;
+
+            /// set when the region changed since the view was last rebuilt
+            bool dirty = true;
+
+            InterestRegion region;
+
+            InterestView view;
+        };
+
+        void rebuild(Subscription& subscription, const EntityStore& entities, const SpatialGrid* entityIndex);
+
+        /// Updates the view from the changes of the store since the view was last synchronised, which the change set
+        /// of the store covers.
+        void applyChanges(Subscription& subscription, const EntityStore& entities);
+
+        std::vector<Subscription> subscriptions_;
+
+        std::vector<SubscriptionId> freeSubscriptions_;
+
+        /// spatial index query results, kept to avoid allocating every synchronisation
+        std::vector<EntityHandle> candidates_;
+
+        std::vector<uint32_t> candidateIndices_;
+
+        std::vector<std::pair<uint32_t, EntityHandle>> entries_;
+
+        /// changeMark_ in the slots of the entities of the change set being applied
+        std::vector<uint64_t> changeMarkOfSlot_;
+
+        uint64_t changeMark_ = 0;
+    };
+}
@@ -1,11 +1,90 @@
 #pragma once
-#include <iostream>
+#include <cstdint>
+#include <cstdio>
 #include <string_view>
 
-namespace tt::log
-{
-    inline void info(const std::string_view& message)
-    {
-        std::cout << "INFO: " << message << std::endl;
+/// Messages below this level are removed at compile time. 0 = Trace, 1 = Debug, 2 = Info, 3 = Warning, 4 = Error.
+#ifndef TT_LOG_MIN_LEVEL
+#define TT_LOG_MIN_LEVEL 2
+#endif
+
+/// Asynchronous logging.
+///
+/// Log calls format the message into a fixed size record on a lock free ring buffer owned by the calling thread, and
+/// return without blocking or allocating. A background thread drains the buffers of all threads and writes the
+/// messages. If a buffer is full, the message is dropped and counted rather than blocking the caller. Messages of a
+/// single thread are written in order, messages of different threads may interleave in any order.
+namespace tt::log {
+    enum Level : uint8_t {
+        Trace,
+        Debug,
+        Info,
+        Warning,
+        Error
+    };
+
+    constexpr Level minimumLevel = static_cast<Level>(TT_LOG_MIN_LEVEL);
+
+    /// Longest message which can be logged, longer messages are truncated.
+    constexpr size_t maximumMessageLength = 240;
+
+    namespace detail {
+        bool isEnabled(Level level);
+
+        void write(Level level, const std::string_view* parts, size_t partCount);
+    }
+
+    /// Logs the concatenation of all supplied parts, if the level is enabled at compile time and at run time.
+    ///
+    /// \param parts anything convertible to std::string_view
+    template <Level L, typename... Parts>
+    void write(const Parts&... parts) {
+        if constexpr (L >= minimumLevel) {
+            if (detail::isEnabled(L)) {
+                const std::string_view views[] = {std::string_view(parts)...};
+                detail::write(L, views, sizeof...(Parts));
+            }
+        }
+    }
+
+    template <typename... Parts>
+    void trace(const Parts&... parts) {
+        write<Trace>(parts...);
+    }
+
+    template <typename... Parts>
+    void debug(const Parts&... parts) {
+        write<Debug>(parts...);
     }
+
+    template <typename... Parts>
+    void info(const Parts&... parts) {
+        write<Info>(parts...);
+    }
+
+    template <typename... Parts>
+    void warning(const Parts&... parts) {
+        write<Warning>(parts...);
+    }
+
+    template <typename... Parts>
+    void error(const Parts&... parts) {
+        write<Error>(parts...);
+    }
+
+    /// Sets the lowest level which is logged at run time. Levels removed at compile time cannot be enabled again.
+    void setLevel(Level level);
+
+    /// Sets the stream messages are written to, stdout by default. The stream is not closed by the logger.
+    void setOutput(std::FILE* output);
+
+    /// Blocks until every message logged before the call has been written to the output.
+    void flush();
+
+    /// \return the number of messages dropped so far because the buffer of the logging thread was full
+    uint64_t getDroppedCount();
+
+    /// \return the number of thread buffers held by the logger. The buffer of a thread is freed once the thread has
+    ///         exited and its messages are written.
+    size_t getBufferCount();
 }
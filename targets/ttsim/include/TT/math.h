@@ -6,11 +6,11 @@
 
 namespace tt::math {
 
-    Eigen::Vector4d homogeneousPoint(const double x, const double y, const double z) {
+    inline Eigen::Vector4d homogeneousPoint(const double x, const double y, const double z) {
         return {x, y, z, 1};
     }
 
-    Eigen::Vector4d homogeneousVector(const double x, const double y, const double z) {
+    inline Eigen::Vector4d homogeneousVector(const double x, const double y, const double z) {
         return {x, y, z, 0};
     }
 }
@@ -1,10 +1,16 @@
 #pragma once
+#include <atomic>
 #include <memory>
 #include <string_view>
+#include <vector>
 
+#include "copy_on_write.h"
 #include "logging.h"
+#include "serialisation.h"
 
 namespace tt {
+    class BusDataBase;
+
     class Model {
     public:
         Model(const std::string_view& name, uint32_t targetFrameInterval);
@@ -15,58 +21,332 @@ namespace tt {
 
         virtual bool init();
 
+        /// Called after the simulation state has been restored from a snapshot, to rebuild anything derived from the
+        /// restored bus data and model state.
         virtual bool reinit();
 
         virtual bool run();
 
+        /// Called when the simulation stops running frames, e.g. to pause external connections.
         virtual bool hold();
 
         virtual bool unload();
 
+        /// Appends the internal state of the model which is not held in bus data, so the model can continue from it
+        /// after a restore. Models whose state is fully held in bus data do not need to override this.
+        ///
+        /// \param buffer the buffer to append to
+        /// \return false if the state cannot be saved
+        virtual bool saveState(std::vector<uint8_t>& buffer) const;
+
+        /// Restores the state appended by saveState. Bus data has already been restored when this is called.
+        ///
+        /// \param reader the saved state
+        /// \return false if the saved state is invalid
+        virtual bool restoreState(ByteReader& reader);
+
         [[nodiscard]] const std::string_view& getName() const;
 
         [[nodiscard]] uint32_t getTargetFrameInterval() const;
 
+        /// Gets the time which passed since the previous run of this model, e.g. to integrate over. On the first run
+        /// this is the frame interval of the model.
+        ///
+        /// \return the time step of the current run in seconds
+        [[nodiscard]] double getDeltaTime() const;
+
+        /// Sets the time step of the next run. This is called by the Simulation before each run.
+        ///
+        /// \param deltaTime the time since the previous run in seconds
+        void setDeltaTime(double deltaTime);
+
+        /// Records that this model reads the supplied bus data. This is called by BusData when a read handle is
+        /// requested on behalf of this model, and is used by the Simulation to work out which models depend on each
+        /// other.
+        ///
+        /// \param busData the bus data read by this model
+        void addRead(const BusDataBase& busData);
+
+        /// Records that this model writes the supplied bus data.
+        ///
+        /// \see addRead
+        ///
+        /// \param busData the bus data written by this model
+        void addWrite(const BusDataBase& busData);
+
+        [[nodiscard]] const std::vector<const BusDataBase*>& getReads() const;
+
+        [[nodiscard]] const std::vector<const BusDataBase*>& getWrites() const;
+
     private:
         /// human readable name for the model
         const std::string_view name;
 
         /// minimum milliseconds between frames
         uint32_t targetFrameInterval;
+
+        /// seconds since the previous run
+        double deltaTime_;
+
+        /// bus data this model has requested read handles for
+        std::vector<const BusDataBase*> reads_;
+
+        /// bus data this model has requested write handles for
+        std::vector<const BusDataBase*> writes_;
+    };
+
+    /// The type independent part of BusData, used to identify bus data without knowing the type it carries.
+    class BusDataBase {
+    public:
+        enum Buffering {
+            /// Readers and writers share a single value. Writes are immediately visible to all readers, which is only
+            /// safe while readers and writers do not run concurrently.
+            Shared,
+            /// Writers update a back buffer, while readers see the front buffer. The buffers are swapped at the end of
+            /// each simulation frame, so readers see a consistent snapshot of the previous frame regardless of when
+            /// they run relative to the writer.
+            DoubleBuffered
+        };
+
+        virtual ~BusDataBase() = default;
+
+        [[nodiscard]] const std::string_view& getName() const;
+
+        [[nodiscard]] Buffering getBuffering() const;
+
+        /// Makes the values written during the last frame visible to readers. Called by the Simulation at the end of
+        /// every frame while no model is running. Has no effect on Shared bus data.
+        virtual void publish() const = 0;
+
+        /// Appends the published value to the supplied buffer, e.g. to record it.
+        ///
+        /// \param buffer the buffer to append to
+        /// \return false if the type of the bus data has no Serialiser, in which case nothing is appended
+        virtual bool serialise(std::vector<uint8_t>& buffer) const = 0;
+
+        /// Writes a value appended by serialise() as a writer would, so for DoubleBuffered bus data readers see it once
+        /// the frame is published.
+        ///
+        /// \param data the serialised value
+        /// \param size the number of bytes of the serialised value
+        /// \return false if the type has no Serialiser or the data does not hold exactly one value, in which case the
+        ///         written value is unspecified
+        virtual bool deserialise(const uint8_t* data, size_t size) const = 0;
+
+        /// Copies the published value of a type marked by IsCopyOnWrite, which shares its storage with the bus data
+        /// until either is written, e.g. to keep it in a snapshot without serialising it.
+        ///
+        /// \return the copy, or nullptr if the type is not copy on write
+        [[nodiscard]] virtual std::shared_ptr<const void> share() const = 0;
+
+        /// Writes a value copied by share() as a writer would, see deserialise().
+        ///
+        /// \param value a value returned by share() of this bus data
+        /// \return false if the type is not copy on write, in which case nothing is written
+        virtual bool restoreShared(const void* value) const = 0;
+
+        /// \return the number of values published so far, always 0 for Shared bus data
+        [[nodiscard]] virtual uint64_t getVersion() const = 0;
+
+    protected:
+        BusDataBase(std::string_view name, Buffering buffering);
+
+        std::string_view name_;
+
+        Buffering buffering_;
     };
 
     template <typename T>
-    class BusData {
+    class BusData final : public BusDataBase {
+        struct Buffers {
+            explicit Buffers(const T& initialValue, const unsigned backOffset) :
+                slots{initialValue, initialValue},
+                front(0),
+                backOffset(backOffset),
+                written(false),
+                stale(false),
+                version(0) {
+            }
+
+            /// \return the slot writers see, once it holds the latest published value
+            T& back() {
+                const unsigned current = front.load(std::memory_order_relaxed);
+                if (stale) {
+                    slots[current ^ 1] = slots[current];
+                    stale = false;
+                }
+                written = true;
+                return slots[current ^ backOffset];
+            }
+
+            T slots[2];
+
+            /// index of the slot readers see
+            std::atomic<unsigned> front;
+
+            /// offset from the front to the slot writers see, 0 if both share a slot
+            const unsigned backOffset;
+
+            /// true if a write handle has been dereferenced since the last publish
+            bool written;
+
+            /// true if the back slot still holds the value published before the latest one
+            bool stale;
+
+            /// number of times a new value has been published
+            std::atomic<uint64_t> version;
+        };
+
     public:
-        BusData(const T& initialValue, const std::string_view name) :
-            data_(std::make_shared<T>(initialValue)),
-            name_(name) {
+        /// Read access to the current value of bus data. Dereferencing always resolves the buffer which is currently
+        /// published, so a handle may be kept for the lifetime of the model.
+        class ReadHandle {
+        public:
+            const T& operator*() const {
+                return *get();
+            }
+
+            const T* operator->() const {
+                return get();
+            }
+
+            const T* get() const {
+                return &buffers_->slots[buffers_->front.load(std::memory_order_acquire)];
+            }
+
+            /// \return the number of values published so far, always 0 for Shared bus data
+            [[nodiscard]] uint64_t getVersion() const {
+                return buffers_->version.load(std::memory_order_acquire);
+            }
+
+        private:
+            friend class BusData;
+
+            explicit ReadHandle(std::shared_ptr<Buffers> buffers) :
+                buffers_(std::move(buffers)) {
+            }
+
+            std::shared_ptr<Buffers> buffers_;
         };
 
-        std::shared_ptr<const T> getReadHandle(const Model* const model = nullptr) const {
-            std::string message = "Read Handle: ";
-            message += model == nullptr ? "Anonymous" : std::string(model->getName());
-            message += " << ";
-            message += std::string(name_);
-            log::info(message);
-            return data_;
+        /// Write access to bus data. For DoubleBuffered bus data this resolves the back buffer, which initially holds
+        /// the last published value so that it may be updated partially.
+        class WriteHandle {
+        public:
+            T& operator*() const {
+                return *get();
+            }
+
+            T* operator->() const {
+                return get();
+            }
+
+            T* get() const {
+                return &buffers_->back();
+            }
+
+        private:
+            friend class BusData;
+
+            explicit WriteHandle(std::shared_ptr<Buffers> buffers) :
+                buffers_(std::move(buffers)) {
+            }
+
+            std::shared_ptr<Buffers> buffers_;
+        };
+
+        BusData(const T& initialValue, const std::string_view name, const Buffering buffering = Shared) :
+            BusDataBase(name, buffering),
+            buffers_(std::make_shared<Buffers>(initialValue, buffering == DoubleBuffered ? 1 : 0)) {
+        };
+
+        ReadHandle getReadHandle(Model* const model = nullptr) const {
+            log::info("Read Handle: ", model == nullptr ? std::string_view("Anonymous") : model->getName(),
+                      " << ", name_);
+            if (model != nullptr) {
+                model->addRead(*this);
+            }
+            return ReadHandle(buffers_);
         }
 
-        std::shared_ptr<T> getWriteHandle(const Model* const model = nullptr) {
-            std::string message = "Write Handle: ";
-            message += model == nullptr ? "Anonymous" : std::string(model->getName());
-            message += " >> ";
-            message += std::string(name_);
-            log::info(message);
-            return data_;
+        WriteHandle getWriteHandle(Model* const model = nullptr) {
+            log::info("Write Handle: ", model == nullptr ? std::string_view("Anonymous") : model->getName(),
+                      " >> ", name_);
+            if (model != nullptr) {
+                model->addWrite(*this);
+            }
+            return WriteHandle(buffers_);
         };
 
-    private:
-        std::shared_ptr<T> data_;
+        void publish() const override {
+            if (buffers_->backOffset == 0 || !buffers_->written) {
+                return;
+            }
+            const unsigned back = buffers_->front.load(std::memory_order_relaxed) ^ 1;
+            buffers_->front.store(back, std::memory_order_release);
+            buffers_->version.fetch_add(1, std::memory_order_release);
+            buffers_->written = false;
 
-        std::string_view name_;
+            // The published value is carried over into the new back buffer on the next write, so writers which only
+            // update part of the value continue from the latest state rather than from the value published one frame
+            // earlier. Frames without writes do not copy the value at all.
+            buffers_->stale = true;
+        }
+
+        bool serialise(std::vector<uint8_t>& buffer) const override {
+            if constexpr (isSerialisable<T>) {
+                Serialiser<T>::write(buffers_->slots[buffers_->front.load(std::memory_order_acquire)], buffer);
+                return true;
+            }
+            else {
+                return false;
+            }
+        }
+
+        uint64_t getVersion() const override {
+            return buffers_->version.load(std::memory_order_acquire);
+        }
+
+        bool deserialise(const uint8_t* const data, const size_t size) const override {
+            if constexpr (isSerialisable<T>) {
+                ByteReader reader(data, size);
+                T& value = buffers_->back();
+                return Serialiser<T>::read(reader, value) && reader.getRemaining() == 0;
+            }
+            else {
+                return false;
+            }
+        }
+
+        std::shared_ptr<const void> share() const override {
+            if constexpr (isCopyOnWrite<T>) {
+                return std::make_shared<const T>(buffers_->slots[buffers_->front.load(std::memory_order_acquire)]);
+            }
+            else {
+                return nullptr;
+            }
+        }
+
+        bool restoreShared(const void* const value) const override {
+            if constexpr (isCopyOnWrite<T>) {
+                buffers_->back() = *static_cast<const T*>(value);
+                return true;
+            }
+            else {
+                return false;
+            }
+        }
+
+    private:
+        std::shared_ptr<Buffers> buffers_;
     };
 
+    template <typename T>
+    using ReadHandle = typename BusData<T>::ReadHandle;
+
+    template <typename T>
+    using WriteHandle = typename BusData<T>::WriteHandle;
+
     class DataChannel {
     public:
         virtual ~DataChannel() = default;
@@ -0,0 +1,149 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tt {
+    /// Radar cross section of a platform over the aspect it is seen from, sampled on a regular grid of azimuth and
+    /// elevation in the body frame of the platform (x forward, y right, z down). Lookups interpolate bilinearly.
+    class RadarCrossSectionTable {
+    public:
+        /// \param azimuthCount number of samples over the full circle, the first at -pi. At least 1.
+        /// \param elevationCount number of samples from -pi/2 to pi/2 inclusive. At least 2.
+        /// \param values azimuthCount * elevationCount samples in meters squared, elevation after elevation
+        RadarCrossSectionTable(uint16_t azimuthCount, uint16_t elevationCount, const float* values);
+
+        /// \param azimuth radian in [-pi, pi], positive to the right of the nose
+        /// \param elevation radian, positive above the platform. Values beyond +/- pi/2 are clamped.
+        /// \return the interpolated radar cross section in meters squared
+        [[nodiscard]] float lookup(const double azimuth, const double elevation) const {
+            const double u = std::clamp((azimuth + M_PI) * azimuthScale_, 0.0, static_cast<double>(azimuthCount_));
+            const auto column = std::min(static_cast<int32_t>(u), azimuthCount_ - 1);
+            const double v = std::clamp((elevation + M_PI_2) * elevationScale_, 0.0, elevationCount_ - 1.0);
+            const auto row = std::min(static_cast<int32_t>(v), elevationCount_ - 2);
+            const double fu = u - column;
+            const double fv = v - row;
+
+            const float* below = values_.data() + row * (azimuthCount_ + 1) + column;
+            const float* above = below + azimuthCount_ + 1;
+            const double lower = below[0] + (below[1] - below[0]) * fu;
+            const double upper = above[0] + (above[1] - above[0]) * fu;
+            return static_cast<float>(lower + (upper - lower) * fv);
+        }
+
+        /// Looks up the radar cross section of a platform seen along a line of sight in world space.
+        ///
+        /// \param psi heading of the platform in radian, as in the RPR FOM
+        /// \param theta pitch of the platform in radian
+        /// \param phi roll of the platform in radian
+        /// \param x world space direction from the platform towards the observer, need not be normalised
+        /// \param y world space direction from the platform towards the observer
+        /// \param z world space direction from the platform towards the observer
+        /// \return the interpolated radar cross section in meters squared
+        [[nodiscard]] float lookup(const float psi, const float theta, const float phi,
+                                   const double x, const double y, const double z) const {
+            // Rotate into the body frame, i.e. apply the inverse of the Z-Y-X Euler rotation
+            const double cosPsi = std::cos(psi);
+            const double sinPsi = std::sin(psi);
+            const double cosTheta = std::cos(theta);
+            const double sinTheta = std::sin(theta);
+            const double cosPhi = std::cos(phi);
+            const double sinPhi = std::sin(phi);
+            const double headingX = cosPsi * x + sinPsi * y;
+            const double headingY = cosPsi * y - sinPsi * x;
+            const double bodyX = cosTheta * headingX - sinTheta * z;
+            const double pitchZ = sinTheta * headingX + cosTheta * z;
+            const double bodyY = cosPhi * headingY + sinPhi * pitchZ;
+            const double bodyZ = cosPhi * pitchZ - sinPhi * headingY;
+            return lookup(std::atan2(bodyY, bodyX), std::atan2(-bodyZ, std::hypot(bodyX, bodyY)));
+        }
+
+        [[nodiscard]] uint16_t getAzimuthCount() const;
+
+        [[nodiscard]] uint16_t getElevationCount() const;
+
+        /// \return the largest sample, which no lookup exceeds
+        [[nodiscard]] float getMaximum() const;
+
+        /// \param azimuth an index smaller than getAzimuthCount()
+        /// \param elevation an index smaller than getElevationCount()
+        /// \return the sample in meters squared
+        [[nodiscard]] float getSample(uint16_t azimuth, uint16_t elevation) const;
+
+    private:
+        int32_t azimuthCount_;
+
+        int32_t elevationCount_;
+
+        /// samples per radian
+        double azimuthScale_;
+
+        double elevationScale_;
+
+        float maximum_;
+
+        /// samples elevation after elevation, each row followed by a copy of its first sample so that interpolation
+        /// across +/- pi needs no wrapping
+        std::vector<float> values_;
+    };
+
+    /// The radar cross section tables of all platforms, indexed by the RadarCrossSectionSignatureIndex of the RPR FOM.
+    ///
+    /// Libraries are stored as a compact binary file in the byte order of the host: the magic "TTRS", a uint32_t
+    /// version and a uint32_t table count, followed by every table as int16_t signature index, uint16_t azimuth count,
+    /// uint16_t elevation count and the float samples in the order of RadarCrossSectionTable.
+    class RadarCrossSectionLibrary {
+    public:
+        static constexpr uint32_t fileVersion = 1;
+
+        /// Adds or replaces the table of a signature.
+        ///
+        /// \param signatureIndex a non negative RadarCrossSectionSignatureIndex
+        /// \param azimuthCount see RadarCrossSectionTable
+        /// \param elevationCount see RadarCrossSectionTable
+        /// \param values azimuthCount * elevationCount samples in meters squared, none negative
+        /// \return false if the table is invalid, in which case the library is unchanged
+        bool add(int16_t signatureIndex, uint16_t azimuthCount, uint16_t elevationCount,
+                 const std::vector<float>& values);
+
+        /// \param signatureIndex the RadarCrossSectionSignatureIndex of an entity
+        /// \return the table of the signature, or nullptr if the library has none, e.g. for the index -1
+        [[nodiscard]] const RadarCrossSectionTable* find(const int16_t signatureIndex) const {
+            if (signatureIndex < 0 || static_cast<size_t>(signatureIndex) >= tableOfSignature_.size()) {
+                return nullptr;
+            }
+            const int32_t table = tableOfSignature_[signatureIndex];
+            return table < 0 ? nullptr : &tables_[table];
+        }
+
+        /// \return the largest sample of all tables, or 0 if the library is empty
+        [[nodiscard]] float getMaximum() const;
+
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] bool empty() const;
+
+        /// Replaces the tables with those of a file.
+        ///
+        /// \param path the file to read
+        /// \return false if the file cannot be read or holds an invalid table, in which case the library is empty
+        bool load(const std::string& path);
+
+        /// \param path the file to write
+        /// \return false if the file cannot be written
+        bool save(const std::string& path) const;
+
+    private:
+        std::vector<RadarCrossSectionTable> tables_;
+
+        /// signature index of each table
+        std::vector<int16_t> signatures_;
+
+        /// index into tables_ for every signature index, -1 for none
+        std::vector<int32_t> tableOfSignature_;
+
+        float maximum_ = 0;
+    };
+}
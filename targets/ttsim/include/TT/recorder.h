@@ -0,0 +1,104 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "model.h"
+
+namespace tt {
+    /// Records bus data and other streams every frame into an append-only binary file, to be read by a Replayer.
+    ///
+    /// Frames are collected in memory and written a chunk at a time with a single large sequential write, so recording
+    /// costs little more than serialising the values. All numbers are stored in the byte order of the host:
+    ///
+    ///     header:  char[4] "TTRC", uint32 version, uint32 stream count,
+    ///              per stream: uint16 name length, name
+    ///     chunks:  char[4] "TTCK", uint32 payload size, uint32 frame count, payload
+    ///     payload: per frame: int64 simulated time in nanoseconds,
+    ///              per stream in the order of the header: uint32 size, value
+    ///
+    /// A chunk is only written once complete, so a recording which ends abruptly is readable up to its last chunk.
+    class Recorder {
+    public:
+        /// Appends the current value of a stream to the supplied buffer.
+        using Source = std::function<void(std::vector<uint8_t>& buffer)>;
+
+        static constexpr uint32_t fileVersion = 1;
+
+        /// \param chunkSize the size at which a chunk is written. Frames are never split, so a chunk may be larger.
+        explicit Recorder(size_t chunkSize = 4 * 1024 * 1024);
+
+        /// Writes the pending frames and closes the file.
+        ~Recorder();
+
+        Recorder(const Recorder&) = delete;
+
+        Recorder& operator=(const Recorder&) = delete;
+
+        /// Records the published value of the supplied bus data as a stream named like the bus data. A Replayer feeds
+        /// it back into bus data of the same name. Streams must be added before the file is opened.
+        ///
+        /// \param busData the bus data to record, which must outlive the recording
+        /// \return false if the file is already open, the type of the bus data has no Serialiser, or a stream of the
+        ///         same name exists
+        bool addBusData(const BusDataBase& busData);
+
+        /// Records data which is not held in bus data, e.g. the echoes a sensor produced in a frame.
+        ///
+        /// \param name the unique name of the stream
+        /// \param source called every frame to append the value of the stream
+        /// \return false if the file is already open or a stream of the same name exists
+        bool addStream(std::string_view name, Source source);
+
+        /// Creates the file, replacing an existing one, and writes the header.
+        ///
+        /// \param path the file to record to
+        /// \return false if the file is already open or cannot be written
+        bool open(const std::string& path);
+
+        /// Appends the current value of every stream as a frame. Typically called by a Simulation frame listener.
+        ///
+        /// \param simulationTime the simulated time of the frame
+        /// \return false if the file is not open or a chunk could not be written
+        bool recordFrame(std::chrono::nanoseconds simulationTime);
+
+        /// Writes the pending frames and closes the file.
+        ///
+        /// \return false if the file was not open or the pending frames could not be written
+        bool close();
+
+        [[nodiscard]] bool isOpen() const;
+
+        /// \return the number of frames recorded into the current file, including frames not yet written
+        [[nodiscard]] uint64_t getFrameCount() const;
+
+    private:
+        struct Stream {
+            std::string name;
+
+            Source source;
+        };
+
+        /// Writes the pending frames as a chunk.
+        bool writeChunk();
+
+        /// Writes the whole buffer, retrying on partial writes.
+        bool writeAll(const std::vector<uint8_t>& buffer);
+
+        std::vector<Stream> streams_;
+
+        size_t chunkSize_;
+
+        int file_;
+
+        /// the chunk being assembled, starting with room for its header
+        std::vector<uint8_t> chunk_;
+
+        uint32_t chunkFrameCount_;
+
+        uint64_t frameCount_;
+    };
+}
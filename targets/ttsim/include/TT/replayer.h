@@ -0,0 +1,119 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "model.h"
+
+namespace tt {
+    /// Reads a recording written by a Recorder. The file is memory mapped, so values are deserialised straight from
+    /// the page cache and frames can be accessed in any order.
+    class Replayer {
+    public:
+        Replayer();
+
+        ~Replayer();
+
+        Replayer(const Replayer&) = delete;
+
+        Replayer& operator=(const Replayer&) = delete;
+
+        /// Maps the file and indexes its frames. A trailing chunk which was not completely written is ignored.
+        ///
+        /// \param path the recording to read
+        /// \return false if the file cannot be mapped or is not a recording of this version
+        bool open(const std::string& path);
+
+        /// Unmaps the file. Data pointers obtained from getData become invalid.
+        void close();
+
+        [[nodiscard]] bool isOpen() const;
+
+        [[nodiscard]] size_t getFrameCount() const;
+
+        /// \param frame a frame smaller than getFrameCount()
+        /// \return the simulated time at which the frame was recorded
+        [[nodiscard]] std::chrono::nanoseconds getFrameTime(size_t frame) const;
+
+        [[nodiscard]] size_t getStreamCount() const;
+
+        /// \param stream a stream smaller than getStreamCount()
+        [[nodiscard]] const std::string& getStreamName(size_t stream) const;
+
+        /// \param name the name of the stream, for bus data the name of the bus data
+        /// \param stream receives the index of the stream
+        /// \return false if the recording has no stream of that name
+        bool findStream(std::string_view name, size_t& stream) const;
+
+        /// Gets the recorded value of a stream, pointing into the mapped file.
+        ///
+        /// \param frame a frame smaller than getFrameCount()
+        /// \param stream a stream smaller than getStreamCount()
+        /// \return the serialised value and its size in bytes
+        [[nodiscard]] std::pair<const uint8_t*, size_t> getData(size_t frame, size_t stream) const;
+
+        /// Writes the recorded value of a stream into bus data.
+        ///
+        /// \see BusDataBase::deserialise
+        ///
+        /// \param frame a frame smaller than getFrameCount()
+        /// \param stream a stream smaller than getStreamCount()
+        /// \param busData the bus data to write to
+        /// \return false if the value does not fit the type of the bus data
+        bool apply(size_t frame, size_t stream, BusDataBase& busData) const;
+
+    private:
+        const uint8_t* data_;
+
+        size_t size_;
+
+        std::vector<std::string> streamNames_;
+
+        std::vector<int64_t> frameTimes_;
+
+        /// offset of the size of each stream in each frame, frame after frame
+        std::vector<size_t> valueOffsets_;
+    };
+
+    /// Feeds a recording back into bus data, one recorded frame per run, so models see the recorded values in the
+    /// order they were recorded regardless of the clock mode. Add this model in place of the models which wrote the
+    /// recorded bus data.
+    class ReplayModel final : public Model {
+    public:
+        /// \param replayer an open recording, which must outlive the model
+        /// \param targetFrameInterval the frame interval the recording was made at
+        explicit ReplayModel(const Replayer& replayer, uint32_t targetFrameInterval = 0);
+
+        /// Writes the stream of the same name into the supplied bus data on every run. This model is registered as a
+        /// writer of the bus data.
+        ///
+        /// \param busData the bus data to feed, which must outlive the model
+        /// \return false if the recording has no stream of that name
+        bool bind(BusDataBase& busData);
+
+        /// Rewinds to the first recorded frame.
+        bool init() override;
+
+        /// Applies the next recorded frame. Once all frames have been applied the bus data keeps its last values.
+        ///
+        /// \return false if a recorded value does not fit its bus data
+        bool run() override;
+
+        /// \return the index of the next frame to apply
+        [[nodiscard]] size_t getFrame() const;
+
+        /// \return true once every recorded frame has been applied
+        [[nodiscard]] bool isFinished() const;
+
+    private:
+        const Replayer& replayer_;
+
+        /// bound bus data and the stream feeding it
+        std::vector<std::pair<BusDataBase*, size_t>> bindings_;
+
+        size_t frame_;
+    };
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace tt {
+    /// A bounded, lock free queue for exactly one producer thread and one consumer thread, e.g. a model producing
+    /// results and a processing stage on another core consuming them.
+    ///
+    /// All storage is allocated on construction, so pushing and popping never allocates or blocks. Items which do not
+    /// fit are dropped and counted, rather than overwriting items the consumer has not seen yet.
+    template <typename T>
+    class RingBuffer final {
+    public:
+        /// \param capacity maximum number of queued items, rounded up to the next power of two
+        explicit RingBuffer(const size_t capacity) :
+            capacity_(roundUpToPowerOfTwo(std::max<size_t>(capacity, 1))),
+            mask_(capacity_ - 1),
+            items_(std::make_unique<T[]>(capacity_)) {
+        }
+
+        RingBuffer(const RingBuffer&) = delete;
+
+        RingBuffer& operator=(const RingBuffer&) = delete;
+
+        /// Queues a single item. Must only be called by the producer.
+        ///
+        /// \return false if the buffer is full and the item was dropped
+        bool push(const T& item) {
+            return push(&item, 1) == 1;
+        }
+
+        /// Queues as many of the supplied items as fit, in order. Must only be called by the producer.
+        ///
+        /// \param items the first item to queue
+        /// \param count number of items to queue
+        /// \return the number of items queued, the remaining items were dropped
+        size_t push(const T* items, const size_t count) {
+            const uint64_t head = head_.load(std::memory_order_relaxed);
+            if (head + count - cachedTail_ > capacity_) {
+                cachedTail_ = tail_.load(std::memory_order_acquire);
+            }
+            const size_t pushed = std::min<size_t>(count, capacity_ - (head - cachedTail_));
+            for (size_t i = 0; i < pushed; ++i) {
+                items_[(head + i) & mask_] = items[i];
+            }
+            head_.store(head + pushed, std::memory_order_release);
+            if (pushed < count) {
+                overflows_.fetch_add(count - pushed, std::memory_order_relaxed);
+            }
+            return pushed;
+        }
+
+        /// Removes the oldest item. Must only be called by the consumer.
+        ///
+        /// \param item receives the removed item
+        /// \return false if the buffer was empty
+        bool pop(T& item) {
+            return pop(&item, 1) == 1;
+        }
+
+        /// Removes up to the supplied number of the oldest items. Must only be called by the consumer.
+        ///
+        /// \param items receives the removed items, oldest first
+        /// \param maximumCount the number of items the output can hold
+        /// \return the number of removed items
+        size_t pop(T* items, const size_t maximumCount) {
+            const uint64_t tail = tail_.load(std::memory_order_relaxed);
+            if (cachedHead_ - tail < maximumCount) {
+                cachedHead_ = head_.load(std::memory_order_acquire);
+            }
+            const size_t popped = std::min<size_t>(maximumCount, cachedHead_ - tail);
+            for (size_t i = 0; i < popped; ++i) {
+                items[i] = std::move(items_[(tail + i) & mask_]);
+            }
+            tail_.store(tail + popped, std::memory_order_release);
+            return popped;
+        }
+
+        /// Removes all queued items. Must only be called by the consumer.
+        void clear() {
+            tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+        }
+
+        /// \return the number of queued items. Only exact if neither producer nor consumer is active.
+        [[nodiscard]] size_t size() const {
+            return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size() == 0;
+        }
+
+        [[nodiscard]] size_t capacity() const {
+            return capacity_;
+        }
+
+        /// \return the total number of items dropped because the buffer was full
+        [[nodiscard]] uint64_t getOverflowCount() const {
+            return overflows_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static size_t roundUpToPowerOfTwo(const size_t value) {
+            size_t power = 1;
+            while (power < value) {
+                power <<= 1;
+            }
+            return power;
+        }
+
+        const size_t capacity_;
+
+        const size_t mask_;
+
+        const std::unique_ptr<T[]> items_;
+
+        /// written by the producer. Each side keeps a copy of the other side's index, so it only has to touch the
+        /// other side's cache line when the copy suggests the buffer is full or empty.
+        alignas(64) std::atomic<uint64_t> head_{0};
+
+        uint64_t cachedTail_ = 0;
+
+        std::atomic<uint64_t> overflows_{0};
+
+        /// written by the consumer
+        alignas(64) std::atomic<uint64_t> tail_{0};
+
+        uint64_t cachedHead_ = 0;
+    };
+}
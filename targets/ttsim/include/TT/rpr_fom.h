@@ -70,12 +70,44 @@ namespace tt::rpr_fom {
   };
 
   struct SpatialVariantStruct {
-    const DeadReckoningAlgorithmEnum8 DeadReckoningAlgorithm = DeadReckoningAlgorithmEnum8::DRM_RVW;
+    DeadReckoningAlgorithmEnum8 DeadReckoningAlgorithm = DeadReckoningAlgorithmEnum8::DRM_RVW;
 
     SpatialRVStruct SpatialRVW;
   };
 
+  struct FederateIdentifierStruct {
+    uint16_t SiteID = 0;
+
+    uint16_t ApplicationID = 0;
+  };
+
+  struct EntityIdentifierStruct {
+    FederateIdentifierStruct FederateIdentifier;
+
+    uint16_t EntityNumber = 0;
+  };
+
+  struct EntityTypeStruct {
+    uint8_t EntityKind = 0;
+
+    uint8_t Domain = 0;
+
+    uint16_t CountryCode = 0;
+
+    uint8_t Category = 0;
+
+    uint8_t Subcategory = 0;
+
+    uint8_t Specific = 0;
+
+    uint8_t Extra = 0;
+  };
+
   struct PhysicalEntity {
+    EntityIdentifierStruct EntityIdentifier;
+
+    EntityTypeStruct EntityType;
+
     short int RadarCrossSectionSignatureIndex = -1;
 
     SpatialVariantStruct Spatial;
@@ -0,0 +1,150 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace tt {
+    /// Reads a serialised value front to back. Reads past the end fail rather than overrun the data.
+    class ByteReader {
+    public:
+        ByteReader(const uint8_t* const data, const size_t size) :
+            data_(data),
+            remaining_(size) {
+        }
+
+        /// Copies the next bytes.
+        ///
+        /// \param destination receives the bytes
+        /// \param size the number of bytes to read
+        /// \return false if fewer bytes remain, in which case nothing is read
+        bool read(void* const destination, const size_t size) {
+            if (size > remaining_) {
+                return false;
+            }
+            if (size > 0) {
+                std::memcpy(destination, data_, size);
+            }
+            data_ += size;
+            remaining_ -= size;
+            return true;
+        }
+
+        /// Skips the next bytes.
+        ///
+        /// \param size the number of bytes to skip
+        /// \return false if fewer bytes remain, in which case nothing is skipped
+        bool skip(const size_t size) {
+            if (size > remaining_) {
+                return false;
+            }
+            data_ += size;
+            remaining_ -= size;
+            return true;
+        }
+
+        template <typename T>
+        bool read(T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return read(&value, sizeof(T));
+        }
+
+        [[nodiscard]] size_t getRemaining() const {
+            return remaining_;
+        }
+
+    private:
+        const uint8_t* data_;
+
+        size_t remaining_;
+    };
+
+    /// Appends raw bytes to a serialised value.
+    ///
+    /// \param buffer the buffer to append to
+    /// \param data the bytes to append
+    /// \param size the number of bytes
+    inline void appendBytes(std::vector<uint8_t>& buffer, const void* const data, const size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    template <typename T>
+    void appendBytes(std::vector<uint8_t>& buffer, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        appendBytes(buffer, &value, sizeof(T));
+    }
+
+    /// Converts values of type T to bytes and back, e.g. to record bus data. Values are stored in the byte order of the
+    /// host, so they can only be read on hosts of the same architecture.
+    ///
+    /// Specialisations provide
+    ///
+    ///     static void write(const T& value, std::vector<uint8_t>& buffer);
+    ///     static bool read(ByteReader& reader, T& value);
+    ///
+    /// where write appends the value to the buffer and read returns false if the data does not hold a valid value.
+    /// Types without a specialisation cannot be serialised, see isSerialisable.
+    template <typename T, typename Enable = void>
+    struct Serialiser;
+
+    /// Trivially copyable types are stored as they are in memory.
+    template <typename T>
+    struct Serialiser<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+        static void write(const T& value, std::vector<uint8_t>& buffer) {
+            appendBytes(buffer, value);
+        }
+
+        static bool read(ByteReader& reader, T& value) {
+            return reader.read(value);
+        }
+    };
+
+    template <typename Scalar, int Rows, int Columns, int Options, int MaxRows, int MaxColumns>
+    struct Serialiser<Eigen::Matrix<Scalar, Rows, Columns, Options, MaxRows, MaxColumns>,
+                      std::enable_if_t<Rows != Eigen::Dynamic && Columns != Eigen::Dynamic>> {
+        using Matrix = Eigen::Matrix<Scalar, Rows, Columns, Options, MaxRows, MaxColumns>;
+
+        static void write(const Matrix& value, std::vector<uint8_t>& buffer) {
+            appendBytes(buffer, value.data(), sizeof(Scalar) * Rows * Columns);
+        }
+
+        static bool read(ByteReader& reader, Matrix& value) {
+            return reader.read(value.data(), sizeof(Scalar) * Rows * Columns);
+        }
+    };
+
+    /// Vectors of trivially copyable elements are stored as their element count followed by the elements.
+    template <typename T, typename Allocator>
+    struct Serialiser<std::vector<T, Allocator>, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+        static void write(const std::vector<T, Allocator>& value, std::vector<uint8_t>& buffer) {
+            appendBytes(buffer, static_cast<uint64_t>(value.size()));
+            appendBytes(buffer, value.data(), sizeof(T) * value.size());
+        }
+
+        static bool read(ByteReader& reader, std::vector<T, Allocator>& value) {
+            uint64_t size;
+            if (!reader.read(size) || size > reader.getRemaining() / sizeof(T)) {
+                return false;
+            }
+            value.resize(size);
+            return reader.read(value.data(), sizeof(T) * size);
+        }
+    };
+
+    template <typename T, typename = void>
+    struct IsSerialisable : std::false_type {
+    };
+
+    template <typename T>
+    struct IsSerialisable<T, std::void_t<decltype(Serialiser<T>::write(std::declval<const T&>(),
+                                                                       std::declval<std::vector<uint8_t>&>()))>> :
+        std::true_type {
+    };
+
+    /// True if Serialiser has a specialisation for T.
+    template <typename T>
+    constexpr bool isSerialisable = IsSerialisable<T>::value;
+}
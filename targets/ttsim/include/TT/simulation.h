@@ -1,7 +1,14 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include "model.h"
+#include "snapshot.h"
+#include "thread_pool.h"
+#include "timing_statistics.h"
 
 namespace tt {
     class Simulation {
@@ -15,6 +22,27 @@ namespace tt {
             Unloaded
         };
 
+        enum ExecutionMode {
+            /// All models run one after another on the simulation thread, in the order they were added
+            Sequential,
+            /// Models which do not share bus data run concurrently on a pool of worker threads
+            Parallel
+        };
+
+        enum ClockMode {
+            /// Simulated time advances with the wall clock. Frames which cannot be executed in time are skipped.
+            RealTime,
+            /// Simulated time advances with the wall clock multiplied by the time scale, e.g. 10 runs ten times faster
+            /// than real time. Frames which cannot be executed in time are skipped.
+            Scaled,
+            /// Simulated time advances by a frame on every step, as fast as the models execute. No frame is skipped,
+            /// so results do not depend on the speed of the host.
+            FreeRunning
+        };
+
+        /// Called at the end of a frame with the simulated time of the frame.
+        using FrameListener = std::function<void(std::chrono::nanoseconds simulationTime)>;
+
     public:
         Simulation();
 
@@ -22,6 +50,11 @@ namespace tt {
         /// is preserved during execution. It makes e.g. more sense to add control input models first so that the input
         /// is updated before the flight dynamics gets the current control values.
         ///
+        /// Models are grouped into rate groups by their target frame interval. Models with a target frame interval of 0
+        /// run once every base frame. Rate groups are scheduled on simulated time, see setClockMode.
+        ///
+        /// \see setBaseFrameInterval
+        ///
         /// \param model a Model to add to the simulation execution
         void addModel(Model& model);
 
@@ -29,33 +62,274 @@ namespace tt {
 
         State getTargetState();
 
+        /// Requests a state, which the simulation moves towards on the following steps. Holding stops a running
+        /// simulation from executing frames until Running is requested again, and simulated time continues where it
+        /// stopped. Unloaded unloads all models and ends main().
+        ///
+        /// \param targetState the state to move to
+        /// \return true
         bool setTargetState(State targetState);
 
+        /// Sets the frame interval used by models with a target frame interval of 0. This is the fastest rate at which
+        /// the simulation will execute any model.
+        ///
+        /// \param interval the time between two base frames, must be larger than 0
+        /// \return false if the interval is not larger than 0, in which case the base frame interval is unchanged
+        bool setBaseFrameInterval(std::chrono::microseconds interval);
+
+        [[nodiscard]] std::chrono::microseconds getBaseFrameInterval() const;
+
+        /// Selects how the models of a frame are executed. In Parallel mode the simulation builds a dependency graph
+        /// from the bus data each model has requested read and write handles for. A model runs after every model added
+        /// before it which writes data it reads, reads data it writes, or writes the same data. Models without such a
+        /// relation run concurrently, so the results are the same as in Sequential mode. Reading DoubleBuffered bus
+        /// data does not order a model after the writers, as readers see the value published in the previous frame.
+        ///
+        /// Note, that data which is exchanged outside of BusData is invisible to the dependency graph.
+        ///
+        /// \param mode the execution mode to use from the next frame on
+        /// \param workerCount number of worker threads used in Parallel mode. The simulation thread also executes
+        ///                    models while it waits for a frame to complete.
+        void setExecutionMode(ExecutionMode mode, size_t workerCount = std::thread::hardware_concurrency());
+
+        [[nodiscard]] ExecutionMode getExecutionMode() const;
+
+        /// Selects how simulated time relates to the wall clock. Changing the mode while running continues from the
+        /// current simulated time.
+        ///
+        /// \param mode the clock mode
+        /// \param timeScale simulated seconds per wall clock second in Scaled mode, must be larger than 0. Ignored in
+        ///                  the other modes.
+        /// \return false if the time scale of Scaled mode is not larger than 0, in which case the clock mode is
+        ///         unchanged
+        bool setClockMode(ClockMode mode, double timeScale = 1);
+
+        [[nodiscard]] ClockMode getClockMode() const;
+
+        /// \return simulated seconds per wall clock second, 1 in RealTime mode and 0 in FreeRunning mode
+        [[nodiscard]] double getTimeScale() const;
+
+        /// Gets the simulated time of the current frame, measured from the first frame after initialisation.
+        ///
+        /// \return the simulated time
+        [[nodiscard]] std::chrono::nanoseconds getSimulationTime() const;
+
+        /// Steps the simulation until the supplied amount of simulated time has passed, loading, initialising or
+        /// resuming it first if necessary. Frames are paced according to the clock mode, so in FreeRunning mode e.g. an
+        /// hour of simulated time is executed as fast as the models allow.
+        ///
+        /// \param duration the simulated time to run for. Every frame scheduled before the end is executed.
+        /// \return false if a model failed to load, initialise or run, or there are no models or the base frame
+        ///         interval is 0, as simulated time would not advance
+        bool runFor(std::chrono::nanoseconds duration);
+
+        /// Saves the state at the end of the latest frame, so the scenario can later continue from it with
+        /// restoreSnapshot rather than start over. Must be called from the thread stepping the simulation, e.g. from a
+        /// frame listener, while Running or Holding.
+        ///
+        /// Retaking a snapshot of this simulation is incremental: DoubleBuffered bus data which has not been published
+        /// since is kept as it is, and other segments are rewritten in place unless a copy of the snapshot shares them.
+        /// Bus data without a Serialiser, e.g. indices derived from other bus data, is not saved.
+        ///
+        /// Bus data of copy on write types, such as the EntityStore, is shared with the snapshot rather than
+        /// serialised, so saving and restoring it costs a few pointer copies, and each of its columns is only copied
+        /// once a model writes it. Other Shared bus data and model states are serialised in full every time,
+        /// synchronously, so the frame in which a snapshot is taken is extended by the time it takes to copy them.
+        ///
+        /// \param snapshot receives the state
+        /// \return false if not Running or Holding, or a model failed to save its state
+        bool saveSnapshot(Snapshot& snapshot);
+
+        /// Restores a snapshot taken of this simulation and reinitialises all models. The next frame is the one which
+        /// followed the snapshot when it was taken. Must be called from the thread stepping the simulation, e.g. from a
+        /// frame listener, while Running or Holding.
+        ///
+        /// \param snapshot a snapshot taken of this simulation with the same models
+        /// \return false if not Running or Holding, the snapshot does not match the simulation, or restoring failed,
+        ///         in which case the state of the simulation is unspecified
+        bool restoreSnapshot(const Snapshot& snapshot);
+
+        /// Gets the total number of frames which were skipped because a rate group was still executing when its next
+        /// deadline passed.
+        ///
+        /// \return the number of missed frames over all rate groups since the simulation started running
+        [[nodiscard]] uint64_t getOverrunCount() const;
+
+        /// Gets the execution time statistics of all frames the simulation ran. A frame spans every model due in it
+        /// and the publishing of the bus data. Frames taking longer than the base frame interval count as overruns.
+        ///
+        /// \return the frame timing since the simulation started running or the statistics were last reset
+        [[nodiscard]] TimingStatistics::Summary getFrameTiming() const;
+
+        /// Gets the execution time statistics of the run() function of a model. Runs taking longer than the interval
+        /// of the rate group of the model count as overruns.
+        ///
+        /// \param model a model which has been added to the simulation
+        /// \return the timing of the model, or all zeros if the model is not part of the simulation
+        [[nodiscard]] TimingStatistics::Summary getModelTiming(const Model& model) const;
+
+        /// Discards the frame and model timing recorded so far, e.g. to exclude the start up from the statistics.
+        /// Must be called from the thread stepping the simulation.
+        void resetTiming();
+
+        /// Periodically logs the frame and model timing as Info messages. The report goes through tt::log like any
+        /// other message, so its lines do not interleave with messages of other threads and formatting it does not
+        /// block the frame on the output.
+        ///
+        /// \param interval the time between two reports, 0 to disable the report
+        void setTimingReport(std::chrono::milliseconds interval);
+
+        /// Registers a function which is called at the end of every frame, once the bus data has been published and
+        /// while no model is running, e.g. to record the bus data. Listeners are called on the thread stepping the
+        /// simulation, in the order they were added, and count towards the frame timing.
+        ///
+        /// \param listener the function to call
+        void addFrameListener(FrameListener listener);
+
+        /// Executes a single step of the simulation. When running, a step executes the next frame, but in RealTime and
+        /// Scaled mode only once the wall clock has reached it, so calling this more often than the fastest rate group
+        /// does not run models more often.
         void step();
 
+        /// Steps the simulation until it is unloaded, waiting between frames for the next rate group deadline.
         void main();
 
     private:
+        using Clock = std::chrono::steady_clock;
+
+        /// Performs a single step.
+        ///
+        /// \return false if a model failed in this step
+        bool advance();
+
         bool load();
 
         bool init();
 
         bool run();
 
+        struct SimModel;
+
+        /// Runs a single model and records its execution time.
+        bool runModel(SimModel& model);
+
+        /// Writes the current frame and model timing to the timing report output.
+        void writeTimingReport() const;
+
+        /// Runs the due models of the current frame on the thread pool, respecting the dependency graph.
+        bool runParallel();
+
+        /// Runs a single model as part of a parallel frame and queues any successor which is now free to run.
+        void runParallelModel(size_t index);
+
+        /// Derives the dependencies between models from their bus data reads and writes, and collects the bus data
+        /// which has to be published at the end of each frame.
+        void buildDependencyGraph();
+
         bool hold();
 
         bool unload();
 
+        /// Schedules every rate group to be due immediately and aligns the wall clock with the simulated time, e.g.
+        /// when transitioning into the Running state or changing the clock mode.
+        void resetDeadlines();
+
+        /// \return the simulated time of the next frame of any rate group
+        [[nodiscard]] std::chrono::nanoseconds getNextFrameTime() const;
+
+        /// \return the wall clock time at which the supplied simulated time is reached in RealTime and Scaled mode
+        [[nodiscard]] Clock::time_point toWallTime(std::chrono::nanoseconds simulationTime) const;
+
+        /// Blocks until the supplied time point. Sleeps for the bulk of the wait and spins for the remainder, as
+        /// sleeping alone is not precise enough to hit frame deadlines.
+        static void waitUntil(Clock::time_point deadline);
+
+        [[nodiscard]] std::chrono::nanoseconds getRateGroupInterval(uint32_t targetFrameInterval) const;
+
         struct SimModel {
             Model& model;
 
             State currentState;
+
+            /// index of the rate group this model is executed in
+            size_t rateGroup;
+
+            /// models added before this one which must complete before this one runs
+            std::vector<size_t> predecessors;
+
+            /// models added after this one which must wait for this one to complete
+            std::vector<size_t> successors;
+
+            /// execution time of run(), held by pointer as the statistics cannot be moved
+            std::unique_ptr<TimingStatistics> timing;
+        };
+
+        struct RateGroup {
+            /// the target frame interval (milliseconds) shared by all models in this group
+            uint32_t targetFrameInterval;
+
+            /// simulated time of the next frame of this group
+            std::chrono::nanoseconds nextFrameTime;
+
+            /// true if the group is being executed in the current frame
+            bool due;
+
+            /// number of frames missed by this group
+            uint64_t overruns;
+
+            /// simulated time of the previous frame of this group
+            std::chrono::nanoseconds previousFrameTime;
+
+            /// seconds between the previous and the current frame of this group
+            double deltaTime;
         };
 
         State currentState;
 
         State targetState_;
 
+        std::chrono::microseconds baseFrameInterval_;
+
+        ClockMode clockMode_;
+
+        double timeScale_;
+
+        std::chrono::nanoseconds simulationTime_;
+
+        /// wall clock time at which the simulated time was 0, as if the time scale had never changed
+        Clock::time_point wallClockEpoch_;
+
         std::vector<SimModel> models;
+
+        std::vector<RateGroup> rateGroups;
+
+        /// all bus data read or written by any model
+        std::vector<const BusDataBase*> busData_;
+
+        ExecutionMode executionMode_;
+
+        std::unique_ptr<ThreadPool> threadPool_;
+
+        /// true if the dependency graph matches the current set of models
+        bool dependencyGraphValid_;
+
+        /// per model count of predecessors which have not yet completed in the current parallel frame
+        std::unique_ptr<std::atomic<size_t>[]> pendingPredecessors_;
+
+        /// number of models which have not yet completed in the current parallel frame
+        std::atomic<size_t> pendingModels_;
+
+        /// due models without due predecessors in the current parallel frame, kept to avoid allocating every frame
+        std::vector<size_t> readyModels_;
+
+        std::atomic<bool> frameFailed_;
+
+        TimingStatistics frameTiming_;
+
+        Clock::duration timingReportInterval_;
+
+        Clock::time_point nextTimingReport_;
+
+        std::vector<FrameListener> frameListeners_;
     };
 }
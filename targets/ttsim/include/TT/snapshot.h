@@ -0,0 +1,67 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tt {
+    class Simulation;
+
+    /// The state of a running simulation at the end of a frame: the simulated time, the schedule of the rate groups,
+    /// every serialisable bus data and the internal state of every model. Taken and restored by the Simulation.
+    ///
+    /// The state is held in one segment per bus data and model. Copying a snapshot shares the segments, and a segment
+    /// is only rewritten in place while no copy shares it, so keeping a copy of a snapshot which is then retaken does
+    /// not copy the state again. Bus data of copy on write types, e.g. the EntityStore, is shared with the simulation
+    /// rather than serialised, so it is only copied by the writers which change it later, and only the parts they
+    /// change. The other changed segments are serialised on the calling thread.
+    class Snapshot {
+    public:
+        /// \return true if no state has been saved into this snapshot
+        [[nodiscard]] bool empty() const;
+
+        /// \return the simulated time of the frame the snapshot was taken after
+        [[nodiscard]] std::chrono::nanoseconds getSimulationTime() const;
+
+        /// \return the number of bytes of serialised state, including segments shared with other snapshots but not
+        ///         copy on write bus data
+        [[nodiscard]] size_t getSize() const;
+
+    private:
+        friend class Simulation;
+
+        struct Segment {
+            /// name of the bus data or model the state belongs to
+            std::string name;
+
+            std::shared_ptr<std::vector<uint8_t>> data;
+
+            /// copy of copy on write bus data, see BusDataBase::share(), in which case data is empty
+            std::shared_ptr<const void> value;
+
+            /// published version of DoubleBuffered bus data when the segment was written
+            uint64_t version = 0;
+        };
+
+        struct RateGroupState {
+            uint32_t targetFrameInterval;
+
+            std::chrono::nanoseconds nextFrameTime;
+
+            std::chrono::nanoseconds previousFrameTime;
+
+            double deltaTime;
+        };
+
+        /// the simulation which took the snapshot
+        const Simulation* owner_ = nullptr;
+
+        std::chrono::nanoseconds simulationTime_{0};
+
+        std::vector<RateGroupState> rateGroups_;
+
+        /// the bus data in the order of the simulation, followed by the models
+        std::vector<Segment> segments_;
+    };
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <Eigen/Core>
+
+#include "entity_store.h"
+
+namespace tt {
+    /// A uniform grid over world (ECEF) space which buckets the entities of an EntityStore by position.
+    ///
+    /// The grid is updated incrementally: an entity is only moved between buckets when it crosses a cell boundary.
+    /// Queries visit the cells overlapping the query volume, so their cost depends on the number of entities near the
+    /// volume rather than on the total number of entities.
+    class SpatialGrid {
+    public:
+        /// \param cellSize edge length of a grid cell in meters. A cell size in the order of the typical query radius
+        ///                 is a good starting point.
+        explicit SpatialGrid(double cellSize = 5000);
+
+        /// Adds an entity, or moves it if it is already in the grid.
+        ///
+        /// \param handle the entity
+        /// \param position the world position of the entity
+        void update(EntityHandle handle, const Eigen::Vector3d& position);
+
+        /// Removes an entity from the grid.
+        ///
+        /// \param handle the entity
+        /// \return false if the entity was not in the grid
+        bool remove(EntityHandle handle);
+
+        void clear();
+
+        /// Brings the grid up to date with the supplied store, adding new entities, moving entities which crossed a
+        /// cell boundary and removing entities which no longer exist. Only the entities which changed since the
+        /// previous call are visited if the change set of the store still covers that call.
+        ///
+        /// \param entities the store to index
+        void synchronise(const EntityStore& entities);
+
+        /// \return the revision of the store at the last call to synchronise
+        [[nodiscard]] uint64_t getSynchronisedRevision() const;
+
+        /// Collects all entities which may be inside the supplied cone. The result is conservative: every entity inside
+        /// the cone is returned, as well as some entities close to it.
+        ///
+        /// \param apex the tip of the cone, in world space
+        /// \param axis the unit direction of the cone axis, in world space
+        /// \param halfAngle the angle between the axis and the cone surface in radians. Angles of M_PI_2 and larger
+        ///                  are not culled by direction at all.
+        /// \param range the length of the cone, in meters
+        /// \param result receives the handles of the entities found. The vector is not cleared.
+        void queryCone(const Eigen::Vector3d& apex, const Eigen::Vector3d& axis, double halfAngle, double range,
+                       std::vector<EntityHandle>& result) const;
+
+        /// Collects all entities which may be within the supplied distance of a point.
+        ///
+        /// \see queryCone
+        void querySphere(const Eigen::Vector3d& center, double radius, std::vector<EntityHandle>& result) const;
+
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] double getCellSize() const;
+
+    private:
+        using CellKey = uint64_t;
+
+        struct Entry {
+            /// generation of the handle indexed in this slot
+            uint32_t generation = 0;
+
+            bool present = false;
+
+            CellKey cell = 0;
+
+            /// position of the handle in the entity list of its cell
+            uint32_t indexInCell = 0;
+
+            /// synchronisation pass in which the entity was last seen in the store
+            uint64_t lastSeen = 0;
+        };
+
+        [[nodiscard]] CellKey cellOf(const Eigen::Vector3d& position) const;
+
+        [[nodiscard]] Eigen::Vector3d cellCenter(CellKey cell) const;
+
+        static CellKey packCell(int64_t x, int64_t y, int64_t z);
+
+        void removeFromCell(const Entry& entry);
+
+        /// Visits every cell which may overlap the axis aligned box around center, calling visit(key, handles).
+        template <typename Visitor>
+        void forEachCellNear(const Eigen::Vector3d& center, double radius, Visitor&& visit) const;
+
+        double cellSize_;
+
+        /// entities per cell
+        std::unordered_map<CellKey, std::vector<EntityHandle>> cells_;
+
+        /// entry per handle slot
+        std::vector<Entry> entries_;
+
+        size_t size_;
+
+        uint64_t synchronisedRevision_;
+
+        uint64_t synchronisePass_;
+    };
+}
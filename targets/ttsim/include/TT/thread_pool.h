@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tt {
+    /// A fixed size pool of worker threads with a task queue per worker.
+    ///
+    /// Tasks submitted from a worker are pushed onto the queue of that worker and popped last in, first out, which
+    /// keeps dependent work on the same core while its data is still in cache. Idle workers steal the oldest task from
+    /// the queues of other workers. Tasks submitted from any other thread are distributed over the workers round robin.
+    class ThreadPool {
+    public:
+        using Task = std::function<void()>;
+
+        /// \param workerCount the number of threads to start. At least one worker is always started.
+        explicit ThreadPool(size_t workerCount);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// Queues a task for execution on one of the workers.
+        ///
+        /// \param task the task to execute
+        void submit(Task task);
+
+        /// Blocks the calling thread until the supplied predicate returns true. While waiting, the calling thread
+        /// executes queued tasks itself rather than sleeping, so a caller waiting for a batch of tasks contributes to
+        /// completing it.
+        ///
+        /// \param done a predicate which returns true once the caller may continue
+        void waitUntil(const std::function<bool()>& done);
+
+        [[nodiscard]] size_t getWorkerCount() const;
+
+    private:
+        struct WorkQueue {
+            std::mutex mutex;
+
+            std::deque<Task> tasks;
+        };
+
+        void workerMain(size_t index);
+
+        /// Pops a task from the queue of the supplied worker, or steals one from any other worker.
+        ///
+        /// \param index the queue to prefer, or an index >= the worker count to only steal
+        /// \param task the task which was found
+        /// \return true if a task was found
+        bool popOrSteal(size_t index, Task& task);
+
+        std::vector<std::unique_ptr<WorkQueue>> queues_;
+
+        std::vector<std::thread> workers_;
+
+        /// number of tasks which are queued but not yet started
+        std::atomic<size_t> queuedTasks_;
+
+        std::atomic<size_t> nextQueue_;
+
+        std::mutex sleepMutex_;
+
+        std::condition_variable wakeUp_;
+
+        bool stopping_;
+    };
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace tt {
+    /// Collects a distribution of durations, e.g. the execution times of a model.
+    ///
+    /// Durations are counted in a histogram with logarithmic buckets, each split into 16 linear sub buckets, so
+    /// percentiles are exact to within 1/16 of their value. Minimum, maximum, average and overrun count are exact.
+    /// Recording is lock free and may happen concurrently from several threads, and concurrently with reading a
+    /// summary. A summary taken while durations are being recorded may not reflect the latest records.
+    class TimingStatistics {
+    public:
+        using Duration = std::chrono::nanoseconds;
+
+        struct Summary {
+            uint64_t count;
+
+            Duration minimum;
+
+            Duration average;
+
+            Duration percentile99;
+
+            Duration maximum;
+
+            /// number of recorded durations which exceeded their budget
+            uint64_t overruns;
+        };
+
+    public:
+        TimingStatistics();
+
+        /// Records a single duration.
+        ///
+        /// \param duration the measured duration
+        /// \param budget the time available for this duration, longer durations are counted as overruns
+        void record(Duration duration, Duration budget);
+
+        /// \return all statistics, or all zeros if nothing was recorded yet
+        [[nodiscard]] Summary getSummary() const;
+
+        /// \param fraction of recorded durations which are shorter or equal to the returned value, between 0 and 1
+        /// \return the duration at the supplied fraction of the distribution, or 0 if nothing was recorded yet
+        [[nodiscard]] Duration getPercentile(double fraction) const;
+
+        /// Discards everything recorded so far. Must not be called concurrently with record.
+        void reset();
+
+    private:
+        static constexpr unsigned subBucketBits = 4;
+
+        static constexpr size_t subBucketCount = size_t(1) << subBucketBits;
+
+        /// buckets up to 2^64 nanoseconds
+        static constexpr size_t bucketCount = (64 - subBucketBits + 1) * subBucketCount;
+
+        static size_t getBucket(uint64_t nanoseconds);
+
+        /// \return the midpoint of the range of durations counted in the supplied bucket
+        static uint64_t getBucketValue(size_t bucket);
+
+        std::array<std::atomic<uint64_t>, bucketCount> buckets_;
+
+        std::atomic<uint64_t> count_;
+
+        std::atomic<uint64_t> total_;
+
+        std::atomic<uint64_t> minimum_;
+
+        std::atomic<uint64_t> maximum_;
+
+        std::atomic<uint64_t> overruns_;
+    };
+}
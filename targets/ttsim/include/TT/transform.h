@@ -30,6 +30,10 @@ namespace tt {
   /// the concept of Geography completely and work purely in the ECEF coordinate system. NED is generally only needed
   /// for e.g. representing velocity, rotation etc. relative to the planet at exactly your current location. Even
   /// physics effects such as gravity can be better applied without imposing man made concepts onto the pure math.
+  ///
+  /// The world transform and its inverse are cached. The cache of a Transform is invalidated when it or any of its
+  /// parents change, so repeated world space queries of a hierarchy which did not move do not redo any matrix math.
+  /// As the cache is updated by const methods, a Transform must not be queried from several threads at the same time.
   class Transform {
   public:
     /// Constructs a Transform at {0, 0, 0} with no rotation and no parent (a 4 x 4 Identity matrix).
@@ -42,7 +46,8 @@ namespace tt {
 
     explicit Transform(const Eigen::Transform<double, 3, Eigen::Affine>& xform, const Transform* parent = nullptr);
 
-    /// Transforms the supplied World Space Transformation to a Transform relative to this one.
+    /// Transforms the supplied World Space Transformation to a Transform relative to the world transform of this one,
+    /// i.e. taking all parents into account.
     ///
     /// For example, If this is a Radar, and the supplied attribute is the XForm of an enemy entity, this function will
     /// return a Transform that is the offset from the Radar.
@@ -72,6 +77,29 @@ namespace tt {
     /// \return
     [[nodiscard]] Eigen::Vector3d toLocalPosition(const Eigen::Vector3d& worldSpacePosition) const;
 
+    /// Transforms a batch of world space positions to local space. This is considerably faster than transforming the
+    /// positions one by one, as the inverse is only looked up once and the multiplication is vectorised.
+    ///
+    /// \param worldSpacePositions the positions to transform, one per column
+    /// \param localSpacePositions receives the transformed positions, must have as many columns as the input
+    void toLocalPositions(const Eigen::Ref<const Eigen::Matrix3Xd>& worldSpacePositions,
+                          Eigen::Ref<Eigen::Matrix3Xd> localSpacePositions) const;
+
+    /// Transforms a batch of world space direction vectors to local space.
+    ///
+    /// \see toLocalPositions
+    ///
+    /// \param worldSpaceVectors the vectors to transform, one per column
+    /// \param localSpaceVectors receives the transformed vectors, must have as many columns as the input
+    void toLocalVectors(const Eigen::Ref<const Eigen::Matrix3Xd>& worldSpaceVectors,
+                        Eigen::Ref<Eigen::Matrix3Xd> localSpaceVectors) const;
+
+    /// Returns true if this transform, ignoring its parents, only consists of a rotation and a translation. The
+    /// inverse of such a transform is computed from the transposed rotation, rather than by a general 4x4 inverse.
+    ///
+    /// \return false if the transform may contain scale or shear
+    [[nodiscard]] bool isRigid() const;
+
     /// Gets the translation element of this transform, irrelevant of the Transform heierachy. That is to say, the
     /// translation from the world position of the parent transform.
     ///
@@ -118,10 +146,24 @@ namespace tt {
     /// \return a Transform with no parent
     [[nodiscard]] Transform toWorldTransform() const;
 
+    /// Transforms the supplied Transform, given relative to this one, to world space. This is the reverse of
+    /// toLocalTransform.
+    ///
+    /// \param localSpaceTransform a transform relative to this one. Its own parent is ignored.
+    /// \return a Transform with no parent
     [[nodiscard]] Transform toWorldTransform(const Transform& localSpaceTransform) const;
 
+    /// Transforms the supplied local space direction vector to world space. The translation is not applied.
+    ///
+    /// \param localSpaceVector
+    /// \return
     [[nodiscard]] Eigen::Vector3d toWorldVector(const Eigen::Vector3d& localSpaceVector) const;
 
+    /// Transforms the supplied local space position to world space. For example, the world position of a point five
+    /// meters in front of a Radar is radarXform.toWorldPosition({5, 0, 0}).
+    ///
+    /// \param localSpacePosition
+    /// \return
     [[nodiscard]] Eigen::Vector3d toWorldPosition(const Eigen::Vector3d& localSpacePosition) const;
 
     /// Calculates and returns the world space position. For example, if this transform has a local transform of
@@ -164,14 +206,54 @@ namespace tt {
 
     [[nodiscard]] const Transform* getParent() const;
 
-    /// Gets the underlying transform in its raw Eigen format.
+    /// Gets the underlying transform in its raw Eigen format. As the caller may store any matrix through the returned
+    /// reference, the transform is no longer considered rigid afterwards.
     ///
     /// \return a reference to the underlying transform
     Eigen::Transform<double, 3, Eigen::Affine>& data();
 
   private:
-    Eigen::Transform<double, 3, Eigen::Affine> xform_;
+    using Affine = Eigen::Transform<double, 3, Eigen::Affine>;
+
+    /// Brings the cached world transform up to date with this transform and all of its parents.
+    ///
+    /// \return a stamp which is unique to the current world transform
+    uint64_t updateWorldCache() const;
+
+    /// \return the world transform, requires an up to date cache
+    [[nodiscard]] const Affine& cachedWorldXform() const;
+
+    [[nodiscard]] const Affine& worldXform() const;
+
+    [[nodiscard]] const Affine& worldInverseXform() const;
+
+    /// Marks the cached world transform as stale, called whenever the local transform or the parent changes.
+    void invalidate();
+
+    Affine xform_;
 
     const Transform* parent_;
+
+    /// true if xform_ is known to be a pure rotation and translation
+    bool rigid_;
+
+    /// parent world transform multiplied by the local transform, only used if there is a parent
+    mutable Affine worldCache_;
+
+    mutable Affine worldInverseCache_;
+
+    /// false if the local transform or the parent changed since the cache was computed
+    mutable bool worldValid_;
+
+    mutable bool inverseValid_;
+
+    /// true if this transform and all of its parents are rigid
+    mutable bool worldRigid_;
+
+    /// stamp of the parent world transform the cache was computed from
+    mutable uint64_t cachedParentStamp_;
+
+    /// stamp identifying the current world transform, handed to children to validate their caches
+    mutable uint64_t worldStamp_;
   };
 }
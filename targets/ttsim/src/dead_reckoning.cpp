@@ -0,0 +1,185 @@
+#include "TT/dead_reckoning.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+#include <Eigen/Geometry>
+
+namespace {
+    using tt::rpr_fom::DeadReckoningAlgorithmEnum8;
+
+    /// entities processed per pass of the vectorised translation
+    constexpr size_t blockSize = 256;
+
+    /// below this rotation angle (radians) over the elapsed time, the small angle limit of the closed form is used
+    constexpr double smallRotation = 1e-9;
+
+    /// Weight of the world velocity and acceleration per algorithm, indexed by DeadReckoningAlgorithmEnum8.
+    /// Body frame algorithms are handled separately and have zero weight here.
+    constexpr std::array<double, 10> velocityWeights = {0, 0, 1, 1, 1, 1, 0, 0, 0, 0};
+
+    constexpr std::array<double, 10> accelerationWeights = {0, 0, 0, 0, 0.5, 0.5, 0, 0, 0, 0};
+
+    size_t toIndex(const DeadReckoningAlgorithmEnum8 algorithm) {
+        const auto index = static_cast<size_t>(algorithm);
+        return index < velocityWeights.size() ? index : 0;
+    }
+
+    bool isRotating(const DeadReckoningAlgorithmEnum8 algorithm) {
+        return algorithm == DeadReckoningAlgorithmEnum8::DRM_RPW || algorithm == DeadReckoningAlgorithmEnum8::DRM_RVW ||
+            algorithm == DeadReckoningAlgorithmEnum8::DRM_RPB || algorithm == DeadReckoningAlgorithmEnum8::DRM_RVB;
+    }
+
+    bool isBodyFrame(const DeadReckoningAlgorithmEnum8 algorithm) {
+        return algorithm == DeadReckoningAlgorithmEnum8::DRM_FPB || algorithm == DeadReckoningAlgorithmEnum8::DRM_RPB ||
+            algorithm == DeadReckoningAlgorithmEnum8::DRM_RVB || algorithm == DeadReckoningAlgorithmEnum8::DRM_FVB;
+    }
+
+    /// Body to world rotation of the DIS Euler angles, psi about z, then theta about y, then phi about x
+    Eigen::Matrix3d toRotationMatrix(const double psi, const double theta, const double phi) {
+        return (Eigen::AngleAxisd(psi, Eigen::Vector3d::UnitZ()) *
+            Eigen::AngleAxisd(theta, Eigen::Vector3d::UnitY()) *
+            Eigen::AngleAxisd(phi, Eigen::Vector3d::UnitX())).toRotationMatrix();
+    }
+
+    Eigen::Vector3d toEulerAngles(const Eigen::Matrix3d& rotation) {
+        return {
+            std::atan2(rotation(1, 0), rotation(0, 0)),
+            std::asin(std::clamp(-rotation(2, 0), -1.0, 1.0)),
+            std::atan2(rotation(2, 1), rotation(2, 2))
+        };
+    }
+
+    /// Advances the entities which rotate or move in body coordinates.
+    void advanceRotatingEntity(const tt::EntityStore& entities, const size_t index, const double time,
+                               const tt::ColumnView3<double>& positions, const tt::ColumnView3<float>& orientations) {
+        const DeadReckoningAlgorithmEnum8 algorithm = entities.getDeadReckoningAlgorithms()[index];
+        const auto referenceOrientations = entities.getReferenceOrientations();
+        const auto angularVelocities = entities.getAngularVelocities();
+
+        const Eigen::Matrix3d referenceRotation = toRotationMatrix(referenceOrientations.x[index],
+                                                                   referenceOrientations.y[index],
+                                                                   referenceOrientations.z[index]);
+        const Eigen::Vector3d omega = isRotating(algorithm)
+            ? Eigen::Vector3d(angularVelocities.x[index], angularVelocities.y[index], angularVelocities.z[index])
+            : Eigen::Vector3d::Zero();
+        const double rate = omega.norm();
+        const double angle = rate * time;
+
+        if (isBodyFrame(algorithm)) {
+            const auto velocities = entities.getVelocities();
+            const auto accelerations = entities.getAccelerations();
+            const auto referencePositions = entities.getReferencePositions();
+            const Eigen::Vector3d velocity(velocities.x[index], velocities.y[index], velocities.z[index]);
+            const bool accelerating = algorithm == DeadReckoningAlgorithmEnum8::DRM_RVB ||
+                algorithm == DeadReckoningAlgorithmEnum8::DRM_FVB;
+            const Eigen::Vector3d acceleration = accelerating
+                ? Eigen::Vector3d(accelerations.x[index], accelerations.y[index], accelerations.z[index])
+                : Eigen::Vector3d::Zero();
+
+            // Integrals of the body rotation over the elapsed time, applied to velocity (R1) and acceleration (R2),
+            // see IEEE 1278.1 Annex E
+            Eigen::Matrix3d r1 = Eigen::Matrix3d::Identity() * time;
+            Eigen::Matrix3d r2 = Eigen::Matrix3d::Identity() * (0.5 * time * time);
+            if (angle > smallRotation) {
+                const Eigen::Matrix3d outer = omega * omega.transpose();
+                Eigen::Matrix3d skew;
+                skew << 0, -omega.z(), omega.y(),
+                    omega.z(), 0, -omega.x(),
+                    -omega.y(), omega.x(), 0;
+                const double sine = std::sin(angle);
+                const double cosine = std::cos(angle);
+                const double rate2 = rate * rate;
+                const double rate3 = rate2 * rate;
+                r1 = ((angle - sine) / rate3) * outer + (sine / rate) * Eigen::Matrix3d::Identity() +
+                    ((1 - cosine) / rate2) * skew;
+                r2 = ((0.5 * angle * angle - cosine - angle * sine + 1) / (rate2 * rate2)) * outer +
+                    ((cosine + angle * sine - 1) / rate2) * Eigen::Matrix3d::Identity() +
+                    ((sine - angle * cosine) / rate3) * skew;
+            }
+
+            const Eigen::Vector3d offset = referenceRotation * (r1 * velocity + r2 * acceleration);
+            positions.x[index] = referencePositions.x[index] + offset.x();
+            positions.y[index] = referencePositions.y[index] + offset.y();
+            positions.z[index] = referencePositions.z[index] + offset.z();
+        }
+
+        if (isRotating(algorithm) && angle > smallRotation) {
+            const Eigen::Matrix3d rotation =
+                referenceRotation * Eigen::AngleAxisd(angle, omega / rate).toRotationMatrix();
+            const Eigen::Vector3d euler = toEulerAngles(rotation);
+            orientations.x[index] = static_cast<float>(euler.x());
+            orientations.y[index] = static_cast<float>(euler.y());
+            orientations.z[index] = static_cast<float>(euler.z());
+        }
+    }
+}
+
+void tt::advanceDeadReckoning(EntityStore& entities, const double deltaTime) {
+    const size_t count = entities.size();
+    if (count == 0) {
+        return;
+    }
+
+    const EntityStore& constEntities = std::as_const(entities);
+    const DeadReckoningAlgorithmEnum8* algorithms = constEntities.getDeadReckoningAlgorithms();
+    const uint8_t* frozen = constEntities.getFrozen();
+    const auto referencePositions = constEntities.getReferencePositions();
+    const auto velocities = constEntities.getVelocities();
+    const auto accelerations = constEntities.getAccelerations();
+    double* times = entities.getDeadReckoningTimes();
+
+    // Positions are only written, and so marked as changed in the change set of the store, if any entity moves
+    bool anyMoving = false;
+    for (size_t i = 0; i < count && !anyMoving; ++i) {
+        anyMoving = frozen[i] == 0 && (velocityWeights[toIndex(algorithms[i])] != 0 || isRotating(algorithms[i]) ||
+            isBodyFrame(algorithms[i]));
+    }
+    if (!anyMoving) {
+        for (size_t i = 0; i < count; ++i) {
+            times[i] += frozen[i] != 0 ? 0 : deltaTime;
+        }
+        return;
+    }
+    const auto positions = entities.getPositions();
+
+    std::array<double, blockSize> velocityFactors;
+    std::array<double, blockSize> accelerationFactors;
+    bool anyRotating = false;
+    for (size_t begin = 0; begin < count; begin += blockSize) {
+        const Eigen::Index n = static_cast<Eigen::Index>(std::min(blockSize, count - begin));
+        for (Eigen::Index i = 0; i < n; ++i) {
+            double& time = times[begin + i];
+            time += frozen[begin + i] != 0 ? 0 : deltaTime;
+            const size_t algorithm = toIndex(algorithms[begin + i]);
+            velocityFactors[i] = velocityWeights[algorithm] * time;
+            accelerationFactors[i] = accelerationWeights[algorithm] * time * time;
+            anyRotating = anyRotating || isRotating(algorithms[begin + i]) || isBodyFrame(algorithms[begin + i]);
+        }
+
+        const Eigen::Map<const Eigen::ArrayXd> velocityFactor(velocityFactors.data(), n);
+        const Eigen::Map<const Eigen::ArrayXd> accelerationFactor(accelerationFactors.data(), n);
+        const auto extrapolate = [&](double* position, const double* reference, const float* velocity,
+                                     const float* acceleration) {
+            Eigen::Map<Eigen::ArrayXd>(position + begin, n) =
+                Eigen::Map<const Eigen::ArrayXd>(reference + begin, n) +
+                Eigen::Map<const Eigen::ArrayXf>(velocity + begin, n).cast<double>() * velocityFactor +
+                Eigen::Map<const Eigen::ArrayXf>(acceleration + begin, n).cast<double>() * accelerationFactor;
+        };
+        extrapolate(positions.x, referencePositions.x, velocities.x, accelerations.x);
+        extrapolate(positions.y, referencePositions.y, velocities.y, accelerations.y);
+        extrapolate(positions.z, referencePositions.z, velocities.z, accelerations.z);
+    }
+
+    if (!anyRotating) {
+        return;
+    }
+    const auto orientations = entities.getOrientations();
+    for (size_t i = 0; i < count; ++i) {
+        if (isRotating(algorithms[i]) || isBodyFrame(algorithms[i])) {
+            advanceRotatingEntity(constEntities, i, times[i], positions, orientations);
+        }
+    }
+}
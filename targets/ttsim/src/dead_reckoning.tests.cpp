@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "TT/dead_reckoning.h"
+
+namespace {
+    using tt::rpr_fom::DeadReckoningAlgorithmEnum8;
+
+    tt::rpr_fom::PhysicalEntity movingEntity(const DeadReckoningAlgorithmEnum8 algorithm) {
+        tt::rpr_fom::PhysicalEntity entity;
+        entity.Spatial.DeadReckoningAlgorithm = algorithm;
+        auto& spatial = entity.Spatial.SpatialRVW;
+        spatial.WorldLocation = {1000, 2000, 3000};
+        spatial.VelocityVector = {10, 20, -5};
+        spatial.AccelerationVector = {1, -2, 0.5};
+        spatial.AngularVelocity = {0.1f, -0.2f, 0.3f};
+        spatial.Orientation = {0.5f, 0.2f, -0.1f};
+        return entity;
+    }
+
+    Eigen::Vector3d positionOf(const tt::EntityStore& store, const tt::EntityHandle handle) {
+        const auto location = store.get(handle).Spatial.SpatialRVW.WorldLocation;
+        return {location.X, location.Y, location.Z};
+    }
+
+    Eigen::Matrix3d rotationOf(const tt::rpr_fom::OrientationStruct& orientation) {
+        return (Eigen::AngleAxisd(orientation.Psi, Eigen::Vector3d::UnitZ()) *
+            Eigen::AngleAxisd(orientation.Theta, Eigen::Vector3d::UnitY()) *
+            Eigen::AngleAxisd(orientation.Phi, Eigen::Vector3d::UnitX())).toRotationMatrix();
+    }
+
+    /// Integrates a body frame entity numerically, as reference for the closed form
+    Eigen::Vector3d integrateBodyFrame(const tt::rpr_fom::PhysicalEntity& entity, const double time) {
+        const auto& spatial = entity.Spatial.SpatialRVW;
+        const Eigen::Vector3d omega(spatial.AngularVelocity.XAngularVelocity, spatial.AngularVelocity.YAngularVelocity,
+                                    spatial.AngularVelocity.ZAngularVelocity);
+        const Eigen::Vector3d velocity(spatial.VelocityVector.XVelocity, spatial.VelocityVector.YVelocity,
+                                       spatial.VelocityVector.ZVelocity);
+        const Eigen::Vector3d acceleration(spatial.AccelerationVector.XAcceleration,
+                                           spatial.AccelerationVector.YAcceleration,
+                                           spatial.AccelerationVector.ZAcceleration);
+        const Eigen::Matrix3d reference = rotationOf(spatial.Orientation);
+
+        constexpr int steps = 100000;
+        const double step = time / steps;
+        Eigen::Vector3d position(spatial.WorldLocation.X, spatial.WorldLocation.Y, spatial.WorldLocation.Z);
+        for (int i = 0; i < steps; ++i) {
+            const double tau = (i + 0.5) * step;
+            const Eigen::Matrix3d rotation = reference * Eigen::AngleAxisd(omega.norm() * tau, omega.normalized());
+            position += rotation * (velocity + acceleration * tau) * step;
+        }
+        return position;
+    }
+}
+
+TEST(DeadReckoning, WorldFrameAlgorithms) {
+    tt::EntityStore store;
+    const auto fixed = store.add(movingEntity(DeadReckoningAlgorithmEnum8::Static));
+    const auto constantVelocity = store.add(movingEntity(DeadReckoningAlgorithmEnum8::DRM_FPW));
+    const auto accelerating = store.add(movingEntity(DeadReckoningAlgorithmEnum8::DRM_FVW));
+    auto frozenEntity = movingEntity(DeadReckoningAlgorithmEnum8::DRM_FVW);
+    frozenEntity.Spatial.SpatialRVW.IsFrozen = true;
+    const auto frozen = store.add(frozenEntity);
+
+    for (int i = 0; i < 20; ++i) {
+        tt::advanceDeadReckoning(store, 0.1);
+    }
+
+    const Eigen::Vector3d origin(1000, 2000, 3000);
+    ASSERT_TRUE(positionOf(store, fixed).isApprox(origin));
+    ASSERT_TRUE(positionOf(store, frozen).isApprox(origin));
+    ASSERT_TRUE(positionOf(store, constantVelocity).isApprox(origin + Eigen::Vector3d(20, 40, -10), 1e-12));
+    ASSERT_TRUE(positionOf(store, accelerating).isApprox(origin + Eigen::Vector3d(22, 36, -9), 1e-12));
+}
+
+TEST(DeadReckoning, UpdateRestartsFromNewState) {
+    tt::EntityStore store;
+    auto entity = movingEntity(DeadReckoningAlgorithmEnum8::DRM_FPW);
+    const auto handle = store.add(entity);
+    tt::advanceDeadReckoning(store, 1);
+
+    entity.Spatial.SpatialRVW.WorldLocation = {0, 0, 0};
+    store.update(handle, entity);
+    ASSERT_EQ(0, store.getDeadReckoningTimes()[store.indexOf(handle)]);
+    tt::advanceDeadReckoning(store, 0.5);
+    ASSERT_TRUE(positionOf(store, handle).isApprox(Eigen::Vector3d(5, 10, -2.5), 1e-12));
+}
+
+TEST(DeadReckoning, RotatingAlgorithmsRotateOrientation) {
+    tt::EntityStore store;
+    const auto rotating = store.add(movingEntity(DeadReckoningAlgorithmEnum8::DRM_RVW));
+    const auto fixed = store.add(movingEntity(DeadReckoningAlgorithmEnum8::DRM_FVW));
+    tt::advanceDeadReckoning(store, 2);
+
+    const auto reference = movingEntity(DeadReckoningAlgorithmEnum8::DRM_RVW).Spatial.SpatialRVW;
+    const Eigen::Vector3d omega(0.1, -0.2, 0.3);
+    const Eigen::Matrix3d expected = rotationOf(reference.Orientation) *
+        Eigen::AngleAxisd(omega.norm() * 2, omega.normalized()).toRotationMatrix();
+    ASSERT_TRUE(rotationOf(store.get(rotating).Spatial.SpatialRVW.Orientation).isApprox(expected, 1e-6));
+
+    const auto fixedOrientation = store.get(fixed).Spatial.SpatialRVW.Orientation;
+    ASSERT_EQ(reference.Orientation.Psi, fixedOrientation.Psi);
+    ASSERT_EQ(reference.Orientation.Theta, fixedOrientation.Theta);
+    ASSERT_EQ(reference.Orientation.Phi, fixedOrientation.Phi);
+
+    // World frame algorithms move the same, whether they rotate or not
+    ASSERT_TRUE(positionOf(store, rotating).isApprox(positionOf(store, fixed), 1e-12));
+}
+
+TEST(DeadReckoning, BodyFrameAlgorithmsMatchIntegration) {
+    for (const auto algorithm : {DeadReckoningAlgorithmEnum8::DRM_FPB, DeadReckoningAlgorithmEnum8::DRM_RPB,
+                                 DeadReckoningAlgorithmEnum8::DRM_RVB, DeadReckoningAlgorithmEnum8::DRM_FVB}) {
+        auto entity = movingEntity(algorithm);
+        tt::EntityStore store;
+        const auto handle = store.add(entity);
+        tt::advanceDeadReckoning(store, 1.5);
+        tt::advanceDeadReckoning(store, 1.5);
+
+        // The reference integration sees what each algorithm ignores as zero
+        auto& spatial = entity.Spatial.SpatialRVW;
+        if (algorithm == DeadReckoningAlgorithmEnum8::DRM_FPB || algorithm == DeadReckoningAlgorithmEnum8::DRM_FVB) {
+            spatial.AngularVelocity = {1e-12f, 0, 0};
+        }
+        if (algorithm == DeadReckoningAlgorithmEnum8::DRM_FPB || algorithm == DeadReckoningAlgorithmEnum8::DRM_RPB) {
+            spatial.AccelerationVector = {};
+        }
+        const Eigen::Vector3d expected = integrateBodyFrame(entity, 3);
+        ASSERT_LT((positionOf(store, handle) - expected).norm(), 1e-4) << static_cast<int>(algorithm);
+    }
+}
@@ -0,0 +1,183 @@
+#include "TT/dis.h"
+
+#include <cstring>
+#include <type_traits>
+
+namespace {
+    /// Unsigned integer type of the same size as T, used to byte swap floating point values
+    template <typename T>
+    using Bits = std::conditional_t<sizeof(T) == 8, uint64_t, std::conditional_t<sizeof(T) == 4, uint32_t,
+                                    std::conditional_t<sizeof(T) == 2, uint16_t, uint8_t>>>;
+
+    template <typename U>
+    U toBigEndian(const U value) {
+        if constexpr (sizeof(U) == 1) {
+            return value;
+        }
+        else if constexpr (sizeof(U) == 2) {
+            return __builtin_bswap16(value);
+        }
+        else if constexpr (sizeof(U) == 4) {
+            return __builtin_bswap32(value);
+        }
+        else {
+            return __builtin_bswap64(value);
+        }
+    }
+
+    template <typename T>
+    T load(const uint8_t* data, const size_t offset) {
+        Bits<T> bits;
+        std::memcpy(&bits, data + offset, sizeof(bits));
+        bits = toBigEndian(bits);
+        T value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    template <typename T>
+    void store(uint8_t* data, const size_t offset, const T value) {
+        Bits<T> bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        bits = toBigEndian(bits);
+        std::memcpy(data + offset, &bits, sizeof(bits));
+    }
+
+    // Field offsets of the Entity State PDU
+    constexpr size_t versionOffset = 0;
+    constexpr size_t exerciseOffset = 1;
+    constexpr size_t typeOffset = 2;
+    constexpr size_t familyOffset = 3;
+    constexpr size_t timestampOffset = 4;
+    constexpr size_t lengthOffset = 8;
+    constexpr size_t entityIdentifierOffset = 12;
+    constexpr size_t forceOffset = 18;
+    constexpr size_t articulationCountOffset = 19;
+    constexpr size_t entityTypeOffset = 20;
+    constexpr size_t velocityOffset = 36;
+    constexpr size_t locationOffset = 48;
+    constexpr size_t orientationOffset = 72;
+    constexpr size_t appearanceOffset = 84;
+    constexpr size_t deadReckoningAlgorithmOffset = 88;
+    constexpr size_t accelerationOffset = 104;
+    constexpr size_t angularVelocityOffset = 116;
+}
+
+size_t tt::dis::getPduLength(const uint8_t* data, const size_t size) {
+    if (size < pduHeaderSize) {
+        return 0;
+    }
+    const size_t length = load<uint16_t>(data, lengthOffset);
+    return length >= pduHeaderSize && length <= size ? length : 0;
+}
+
+uint8_t tt::dis::getPduType(const uint8_t* data) {
+    return data[typeOffset];
+}
+
+bool tt::dis::decodeEntityState(const uint8_t* data, const size_t size, EntityState& state) {
+    const size_t length = getPduLength(data, size);
+    if (length < entityStatePduSize || getPduType(data) != entityStatePduType ||
+        length < entityStatePduSize + data[articulationCountOffset] * articulationParameterSize) {
+        return false;
+    }
+
+    state.exerciseIdentifier = data[exerciseOffset];
+    state.timestamp = load<uint32_t>(data, timestampOffset);
+    state.forceIdentifier = data[forceOffset];
+
+    rpr_fom::PhysicalEntity& entity = state.entity;
+    entity.EntityIdentifier.FederateIdentifier.SiteID = load<uint16_t>(data, entityIdentifierOffset);
+    entity.EntityIdentifier.FederateIdentifier.ApplicationID = load<uint16_t>(data, entityIdentifierOffset + 2);
+    entity.EntityIdentifier.EntityNumber = load<uint16_t>(data, entityIdentifierOffset + 4);
+
+    entity.EntityType.EntityKind = data[entityTypeOffset];
+    entity.EntityType.Domain = data[entityTypeOffset + 1];
+    entity.EntityType.CountryCode = load<uint16_t>(data, entityTypeOffset + 2);
+    entity.EntityType.Category = data[entityTypeOffset + 4];
+    entity.EntityType.Subcategory = data[entityTypeOffset + 5];
+    entity.EntityType.Specific = data[entityTypeOffset + 6];
+    entity.EntityType.Extra = data[entityTypeOffset + 7];
+
+    rpr_fom::SpatialRVStruct& spatial = entity.Spatial.SpatialRVW;
+    spatial.VelocityVector.XVelocity = load<float>(data, velocityOffset);
+    spatial.VelocityVector.YVelocity = load<float>(data, velocityOffset + 4);
+    spatial.VelocityVector.ZVelocity = load<float>(data, velocityOffset + 8);
+    spatial.WorldLocation.X = load<double>(data, locationOffset);
+    spatial.WorldLocation.Y = load<double>(data, locationOffset + 8);
+    spatial.WorldLocation.Z = load<double>(data, locationOffset + 16);
+    spatial.Orientation.Psi = load<float>(data, orientationOffset);
+    spatial.Orientation.Theta = load<float>(data, orientationOffset + 4);
+    spatial.Orientation.Phi = load<float>(data, orientationOffset + 8);
+    spatial.AccelerationVector.XAcceleration = load<float>(data, accelerationOffset);
+    spatial.AccelerationVector.YAcceleration = load<float>(data, accelerationOffset + 4);
+    spatial.AccelerationVector.ZAcceleration = load<float>(data, accelerationOffset + 8);
+    spatial.AngularVelocity.XAngularVelocity = load<float>(data, angularVelocityOffset);
+    spatial.AngularVelocity.YAngularVelocity = load<float>(data, angularVelocityOffset + 4);
+    spatial.AngularVelocity.ZAngularVelocity = load<float>(data, angularVelocityOffset + 8);
+
+    const uint32_t appearance = load<uint32_t>(data, appearanceOffset);
+    spatial.IsFrozen = (appearance & frozenAppearance) != 0;
+    state.deactivated = (appearance & deactivatedAppearance) != 0;
+    state.appearance = appearance & ~(frozenAppearance | deactivatedAppearance);
+
+    const uint8_t algorithm = data[deadReckoningAlgorithmOffset];
+    const uint8_t lastAlgorithm = static_cast<uint8_t>(rpr_fom::DeadReckoningAlgorithmEnum8::DRM_FVB);
+    entity.Spatial.DeadReckoningAlgorithm = algorithm <= lastAlgorithm
+        ? static_cast<rpr_fom::DeadReckoningAlgorithmEnum8>(algorithm)
+        : rpr_fom::DeadReckoningAlgorithmEnum8::Other;
+    return true;
+}
+
+size_t tt::dis::encodeEntityState(const EntityState& state, uint8_t* data, const size_t capacity) {
+    if (capacity < entityStatePduSize) {
+        return 0;
+    }
+    std::memset(data, 0, entityStatePduSize);
+
+    data[versionOffset] = protocolVersion;
+    data[exerciseOffset] = state.exerciseIdentifier;
+    data[typeOffset] = entityStatePduType;
+    data[familyOffset] = entityInformationFamily;
+    store<uint32_t>(data, timestampOffset, state.timestamp);
+    store<uint16_t>(data, lengthOffset, static_cast<uint16_t>(entityStatePduSize));
+    data[forceOffset] = state.forceIdentifier;
+
+    const rpr_fom::PhysicalEntity& entity = state.entity;
+    store<uint16_t>(data, entityIdentifierOffset, entity.EntityIdentifier.FederateIdentifier.SiteID);
+    store<uint16_t>(data, entityIdentifierOffset + 2, entity.EntityIdentifier.FederateIdentifier.ApplicationID);
+    store<uint16_t>(data, entityIdentifierOffset + 4, entity.EntityIdentifier.EntityNumber);
+
+    data[entityTypeOffset] = entity.EntityType.EntityKind;
+    data[entityTypeOffset + 1] = entity.EntityType.Domain;
+    store<uint16_t>(data, entityTypeOffset + 2, entity.EntityType.CountryCode);
+    data[entityTypeOffset + 4] = entity.EntityType.Category;
+    data[entityTypeOffset + 5] = entity.EntityType.Subcategory;
+    data[entityTypeOffset + 6] = entity.EntityType.Specific;
+    data[entityTypeOffset + 7] = entity.EntityType.Extra;
+
+    const rpr_fom::SpatialRVStruct& spatial = entity.Spatial.SpatialRVW;
+    store<float>(data, velocityOffset, spatial.VelocityVector.XVelocity);
+    store<float>(data, velocityOffset + 4, spatial.VelocityVector.YVelocity);
+    store<float>(data, velocityOffset + 8, spatial.VelocityVector.ZVelocity);
+    store<double>(data, locationOffset, spatial.WorldLocation.X);
+    store<double>(data, locationOffset + 8, spatial.WorldLocation.Y);
+    store<double>(data, locationOffset + 16, spatial.WorldLocation.Z);
+    store<float>(data, orientationOffset, spatial.Orientation.Psi);
+    store<float>(data, orientationOffset + 4, spatial.Orientation.Theta);
+    store<float>(data, orientationOffset + 8, spatial.Orientation.Phi);
+    store<float>(data, accelerationOffset, spatial.AccelerationVector.XAcceleration);
+    store<float>(data, accelerationOffset + 4, spatial.AccelerationVector.YAcceleration);
+    store<float>(data, accelerationOffset + 8, spatial.AccelerationVector.ZAcceleration);
+    store<float>(data, angularVelocityOffset, spatial.AngularVelocity.XAngularVelocity);
+    store<float>(data, angularVelocityOffset + 4, spatial.AngularVelocity.YAngularVelocity);
+    store<float>(data, angularVelocityOffset + 8, spatial.AngularVelocity.ZAngularVelocity);
+
+    uint32_t appearance = state.appearance & ~(frozenAppearance | deactivatedAppearance);
+    appearance |= spatial.IsFrozen ? frozenAppearance : 0;
+    appearance |= state.deactivated ? deactivatedAppearance : 0;
+    store<uint32_t>(data, appearanceOffset, appearance);
+
+    data[deadReckoningAlgorithmOffset] = static_cast<uint8_t>(entity.Spatial.DeadReckoningAlgorithm);
+    return entityStatePduSize;
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "TT/dis.h"
+#include "TT/dis_receiver.h"
+
+namespace {
+    tt::dis::EntityState makeState(const uint16_t entityNumber) {
+        tt::dis::EntityState state;
+        state.exerciseIdentifier = 3;
+        state.timestamp = 0x12345679;
+        state.forceIdentifier = 2;
+        state.appearance = 0x10;
+        auto& entity = state.entity;
+        entity.EntityIdentifier = {{1, 2}, entityNumber};
+        entity.EntityType = {1, 2, 225, 1, 3, 4, 5};
+        entity.Spatial.DeadReckoningAlgorithm = tt::rpr_fom::DeadReckoningAlgorithmEnum8::DRM_FVW;
+        auto& spatial = entity.Spatial.SpatialRVW;
+        spatial.WorldLocation = {4000000.5, -300000.25, 4500000.125};
+        spatial.IsFrozen = true;
+        spatial.Orientation = {0.5f, -0.25f, 1.5f};
+        spatial.VelocityVector = {100, -20, 3};
+        spatial.AccelerationVector = {1, 2, 3};
+        spatial.AngularVelocity = {0.1f, 0.2f, 0.3f};
+        return state;
+    }
+
+    /// Sends datagrams to a local port
+    class Sender {
+    public:
+        explicit Sender(const uint16_t port) :
+            socket_(socket(AF_INET, SOCK_DGRAM, 0)) {
+            destination_.sin_family = AF_INET;
+            destination_.sin_port = htons(port);
+            inet_pton(AF_INET, "127.0.0.1", &destination_.sin_addr);
+        }
+
+        ~Sender() {
+            close(socket_);
+        }
+
+        void send(const std::vector<uint8_t>& datagram) const {
+            sendto(socket_, datagram.data(), datagram.size(), 0, reinterpret_cast<const sockaddr*>(&destination_),
+                   sizeof(destination_));
+        }
+
+    private:
+        int socket_;
+
+        sockaddr_in destination_{};
+    };
+}
+
+TEST(Dis, EncodesEntityStateWireFormat) {
+    uint8_t pdu[tt::dis::entityStatePduSize];
+    ASSERT_EQ(0, tt::dis::encodeEntityState(makeState(7), pdu, sizeof(pdu) - 1));
+    ASSERT_EQ(tt::dis::entityStatePduSize, tt::dis::encodeEntityState(makeState(7), pdu, sizeof(pdu)));
+
+    ASSERT_EQ(tt::dis::entityStatePduType, pdu[2]);
+    ASSERT_EQ(tt::dis::entityStatePduSize, pdu[8] * 256 + pdu[9]);
+    // Entity identifier, big endian
+    ASSERT_EQ(0, pdu[16]);
+    ASSERT_EQ(7, pdu[17]);
+    // Country code of the entity type
+    ASSERT_EQ(0, pdu[22]);
+    ASSERT_EQ(225, pdu[23]);
+    // Frozen appearance bit
+    ASSERT_EQ(0x20, pdu[85]);
+    ASSERT_EQ(5, pdu[88]);
+}
+
+TEST(Dis, DecodesWhatWasEncoded) {
+    const tt::dis::EntityState original = makeState(7);
+    uint8_t pdu[tt::dis::entityStatePduSize];
+    tt::dis::encodeEntityState(original, pdu, sizeof(pdu));
+
+    tt::dis::EntityState decoded;
+    ASSERT_TRUE(tt::dis::decodeEntityState(pdu, sizeof(pdu), decoded));
+    ASSERT_EQ(original.exerciseIdentifier, decoded.exerciseIdentifier);
+    ASSERT_EQ(original.timestamp, decoded.timestamp);
+    ASSERT_EQ(original.forceIdentifier, decoded.forceIdentifier);
+    ASSERT_EQ(original.appearance, decoded.appearance);
+    ASSERT_FALSE(decoded.deactivated);
+    ASSERT_EQ(7, decoded.entity.EntityIdentifier.EntityNumber);
+    ASSERT_EQ(2, decoded.entity.EntityIdentifier.FederateIdentifier.ApplicationID);
+    ASSERT_EQ(225, decoded.entity.EntityType.CountryCode);
+    ASSERT_EQ(5, decoded.entity.EntityType.Extra);
+    ASSERT_EQ(original.entity.Spatial.DeadReckoningAlgorithm, decoded.entity.Spatial.DeadReckoningAlgorithm);
+
+    const auto& expected = original.entity.Spatial.SpatialRVW;
+    const auto& spatial = decoded.entity.Spatial.SpatialRVW;
+    ASSERT_TRUE(spatial.IsFrozen);
+    ASSERT_EQ(expected.WorldLocation.X, spatial.WorldLocation.X);
+    ASSERT_EQ(expected.WorldLocation.Z, spatial.WorldLocation.Z);
+    ASSERT_EQ(expected.Orientation.Theta, spatial.Orientation.Theta);
+    ASSERT_EQ(expected.VelocityVector.YVelocity, spatial.VelocityVector.YVelocity);
+    ASSERT_EQ(expected.AccelerationVector.ZAcceleration, spatial.AccelerationVector.ZAcceleration);
+    ASSERT_EQ(expected.AngularVelocity.XAngularVelocity, spatial.AngularVelocity.XAngularVelocity);
+}
+
+TEST(Dis, RejectsIncompletePdus) {
+    std::vector<uint8_t> pdu(tt::dis::entityStatePduSize);
+    tt::dis::encodeEntityState(makeState(1), pdu.data(), pdu.size());
+    tt::dis::EntityState decoded;
+    ASSERT_FALSE(tt::dis::decodeEntityState(pdu.data(), pdu.size() - 1, decoded));
+
+    // Announces an articulation parameter which is missing
+    pdu[19] = 1;
+    ASSERT_FALSE(tt::dis::decodeEntityState(pdu.data(), pdu.size(), decoded));
+
+    pdu[19] = 0;
+    pdu[2] = 2;
+    ASSERT_FALSE(tt::dis::decodeEntityState(pdu.data(), pdu.size(), decoded));
+}
+
+TEST(Dis, ReceivesBundledPdusOnLoopback) {
+    tt::dis::Receiver receiver;
+    ASSERT_TRUE(receiver.start(0, "127.0.0.1"));
+    ASSERT_NE(0, receiver.getPort());
+
+    // 100 datagrams of 10 bundled Entity State PDUs each, followed by a PDU of another type
+    constexpr int datagramCount = 100;
+    constexpr int pdusPerDatagram = 10;
+    const Sender sender(receiver.getPort());
+    for (int datagram = 0; datagram < datagramCount; ++datagram) {
+        std::vector<uint8_t> data((pdusPerDatagram + 1) * tt::dis::entityStatePduSize);
+        for (int i = 0; i <= pdusPerDatagram; ++i) {
+            const auto number = static_cast<uint16_t>(datagram * pdusPerDatagram + i);
+            tt::dis::encodeEntityState(makeState(number), data.data() + i * tt::dis::entityStatePduSize,
+                                       tt::dis::entityStatePduSize);
+        }
+        data[pdusPerDatagram * tt::dis::entityStatePduSize + 2] = 2;
+        sender.send(data);
+    }
+
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (receiver.getEntityStateCount() < datagramCount * pdusPerDatagram &&
+           std::chrono::steady_clock::now() < timeout) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    receiver.stop();
+    ASSERT_FALSE(receiver.isRunning());
+
+    ASSERT_EQ(datagramCount * pdusPerDatagram, receiver.getEntityStateCount());
+    ASSERT_EQ(datagramCount, receiver.getIgnoredCount());
+    ASSERT_EQ(datagramCount * pdusPerDatagram, receiver.getUpdates().size());
+    tt::dis::EntityState state;
+    ASSERT_TRUE(receiver.getUpdates().pop(state));
+    ASSERT_EQ(0, state.entity.EntityIdentifier.EntityNumber);
+    ASSERT_TRUE(receiver.getUpdates().pop(state));
+    ASSERT_EQ(1, state.entity.EntityIdentifier.EntityNumber);
+}
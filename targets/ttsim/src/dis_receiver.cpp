@@ -0,0 +1,160 @@
+#include "TT/dis_receiver.h"
+
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "TT/logging.h"
+
+namespace {
+    /// datagrams read per system call
+    constexpr size_t batchSize = 64;
+
+    /// largest datagram accepted, DIS limits PDUs to 8192 bytes
+    constexpr size_t datagramSize = 8192;
+
+    /// how often the receiving thread checks whether it should stop
+    constexpr timeval receiveTimeout{0, 50000};
+
+    /// socket receive buffer, large enough to absorb bursts while the thread is not scheduled
+    constexpr int receiveBufferSize = 4 * 1024 * 1024;
+}
+
+tt::dis::Receiver::Receiver(const size_t updateCapacity) :
+    socket_(-1),
+    port_(0),
+    running_(false),
+    updates_(updateCapacity),
+    entityStates_(0),
+    ignored_(0) {
+}
+
+tt::dis::Receiver::~Receiver() {
+    stop();
+}
+
+bool tt::dis::Receiver::start(const uint16_t port, const std::string& address) {
+    if (running_) {
+        return false;
+    }
+
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &local.sin_addr) != 1) {
+        log::error("DIS receiver: invalid address ", address);
+        return false;
+    }
+
+    socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_ < 0) {
+        log::error("DIS receiver: cannot create socket");
+        return false;
+    }
+    const int reuse = 1;
+    setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize));
+    setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout));
+
+    socklen_t localSize = sizeof(local);
+    if (bind(socket_, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0 ||
+        getsockname(socket_, reinterpret_cast<sockaddr*>(&local), &localSize) != 0) {
+        log::error("DIS receiver: cannot bind to ", address);
+        close(socket_);
+        socket_ = -1;
+        return false;
+    }
+    port_ = ntohs(local.sin_port);
+
+    running_ = true;
+    thread_ = std::thread(&Receiver::receiveMain, this);
+    return true;
+}
+
+void tt::dis::Receiver::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+    thread_.join();
+    close(socket_);
+    socket_ = -1;
+    port_ = 0;
+}
+
+bool tt::dis::Receiver::isRunning() const {
+    return running_;
+}
+
+uint16_t tt::dis::Receiver::getPort() const {
+    return port_;
+}
+
+tt::RingBuffer<tt::dis::EntityState>& tt::dis::Receiver::getUpdates() {
+    return updates_;
+}
+
+uint64_t tt::dis::Receiver::getEntityStateCount() const {
+    return entityStates_.load(std::memory_order_relaxed);
+}
+
+uint64_t tt::dis::Receiver::getIgnoredCount() const {
+    return ignored_.load(std::memory_order_relaxed);
+}
+
+void tt::dis::Receiver::receiveMain() {
+    std::vector<uint8_t> buffers(batchSize * datagramSize);
+    std::vector<iovec> vectors(batchSize);
+    std::vector<mmsghdr> messages(batchSize);
+    for (size_t i = 0; i < batchSize; ++i) {
+        vectors[i] = {buffers.data() + i * datagramSize, datagramSize};
+        messages[i] = {};
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // Decoded updates are queued in batches, so the consumer sees fewer updates of the queue indices
+    std::vector<EntityState> decoded(batchSize);
+    size_t decodedCount = 0;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        // Blocks until at least one datagram arrived or the timeout passed, then takes whatever else is queued
+        const int received = recvmmsg(socket_, messages.data(), batchSize, MSG_WAITFORONE, nullptr);
+        if (received <= 0) {
+            continue;
+        }
+
+        uint64_t entityStates = 0;
+        uint64_t ignored = 0;
+        for (int i = 0; i < received; ++i) {
+            const uint8_t* data = buffers.data() + i * datagramSize;
+            size_t remaining = messages[i].msg_len;
+            while (remaining >= pduHeaderSize) {
+                const size_t length = getPduLength(data, remaining);
+                if (length == 0) {
+                    ++ignored;
+                    break;
+                }
+                if (getPduType(data) == entityStatePduType && decodeEntityState(data, length, decoded[decodedCount])) {
+                    ++entityStates;
+                    if (++decodedCount == decoded.size()) {
+                        updates_.push(decoded.data(), decodedCount);
+                        decodedCount = 0;
+                    }
+                }
+                else {
+                    ++ignored;
+                }
+                data += length;
+                remaining -= length;
+            }
+        }
+        updates_.push(decoded.data(), decodedCount);
+        decodedCount = 0;
+        entityStates_.fetch_add(entityStates, std::memory_order_relaxed);
+        ignored_.fetch_add(ignored, std::memory_order_relaxed);
+    }
+}
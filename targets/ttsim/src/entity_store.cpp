@@ -0,0 +1,605 @@
+#include "TT/entity_store.h"
+
+#include <algorithm>
+#include <cstring>
+
+uint32_t tt::EntityChangeSet::getFieldsOfAll(const uint64_t revision) const {
+    uint32_t fields = 0;
+    for (size_t bit = 0; bit < fieldsOfAllRevisions_.size(); ++bit) {
+        if (fieldsOfAllRevisions_[bit] > revision) {
+            fields |= 1u << bit;
+        }
+    }
+    return fields;
+}
+
+void tt::EntityChangeSet::recordAdded(const EntityHandle handle, const uint64_t revision) {
+    if (handle.slot >= entryOfSlot_.size()) {
+        entryOfSlot_.resize(handle.slot + 1, none);
+    }
+    entryOfSlot_[handle.slot] = static_cast<uint32_t>(entries_.size());
+    entries_.push_back({handle, 0, false, revision, revision});
+}
+
+void tt::EntityChangeSet::recordRemoved(const EntityHandle handle, const uint64_t revision) {
+    // Consumers may have seen the entity being added, so its removal is recorded even if its addition was. The
+    // previous entry of the entity is superseded.
+    if (handle.slot < entryOfSlot_.size()) {
+        entryOfSlot_[handle.slot] = none;
+    }
+    entries_.push_back({handle, 0, true, revision, 0});
+}
+
+void tt::EntityChangeSet::recordUpdated(const EntityHandle handle, const uint32_t fields, const uint64_t revision) {
+    if (fields == 0) {
+        return;
+    }
+    if (handle.slot >= entryOfSlot_.size()) {
+        entryOfSlot_.resize(handle.slot + 1, none);
+    }
+
+    // The entity moves to the end of the entries, keeping them ordered by revision
+    uint32_t& position = entryOfSlot_[handle.slot];
+    if (position == entries_.size() - 1) {
+        entries_[position].fields |= fields;
+        entries_[position].revision = revision;
+        return;
+    }
+    Entry entry{handle, fields, false, revision, 0};
+    if (position != none) {
+        entry.fields |= entries_[position].fields;
+        entry.addedRevision = entries_[position].addedRevision;
+    }
+    position = static_cast<uint32_t>(entries_.size());
+    entries_.push_back(entry);
+}
+
+void tt::EntityChangeSet::recordFieldsOfAll(const uint32_t fields, const uint64_t revision) {
+    for (size_t bit = 0; bit < fieldsOfAllRevisions_.size(); ++bit) {
+        if ((fields & (1u << bit)) != 0) {
+            fieldsOfAllRevisions_[bit] = revision;
+        }
+    }
+}
+
+void tt::EntityChangeSet::compact(const size_t entityCount) {
+    size_t kept = 0;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const Entry& entry = entries_[i];
+        if (entry.removed || entryOfSlot_[entry.handle.slot] == i) {
+            entries_[kept++] = entry;
+        }
+    }
+    entries_.resize(kept);
+
+    // Consumers which have not seen the dropped changes visit every entity instead
+    const size_t dropped = kept > entityCount ? kept - entityCount : 0;
+    if (dropped > 0) {
+        baseRevision_ = entries_[dropped - 1].revision;
+        entries_.erase(entries_.begin(), entries_.begin() + static_cast<std::ptrdiff_t>(dropped));
+    }
+    std::fill(entryOfSlot_.begin(), entryOfSlot_.end(), none);
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (!entries_[i].removed) {
+            entryOfSlot_[entries_[i].handle.slot] = static_cast<uint32_t>(i);
+        }
+    }
+}
+
+void tt::EntityChangeSet::clear(const uint64_t revision) {
+    entries_.clear();
+    std::fill(entryOfSlot_.begin(), entryOfSlot_.end(), none);
+    baseRevision_ = revision;
+}
+
+tt::EntityStore::EntityStore(const EntityStore& other) :
+    positions_(other.positions_),
+    orientations_(other.orientations_),
+    velocities_(other.velocities_),
+    accelerations_(other.accelerations_),
+    angularVelocities_(other.angularVelocities_),
+    entityIdentifiers_(other.entityIdentifiers_),
+    entityTypes_(other.entityTypes_),
+    radarCrossSectionSignatureIndices_(other.radarCrossSectionSignatureIndices_),
+    deadReckoningAlgorithms_(other.deadReckoningAlgorithms_),
+    frozen_(other.frozen_),
+    referencePositions_(other.referencePositions_),
+    referenceOrientations_(other.referenceOrientations_),
+    deadReckoningTimes_(other.deadReckoningTimes_),
+    slotOfIndex_(other.slotOfIndex_),
+    indexOfSlot_(other.indexOfSlot_),
+    generationOfSlot_(other.generationOfSlot_),
+    freeSlots_(other.freeSlots_),
+    revision_(other.revision_) {
+    changes_.clear(revision_);
+}
+
+tt::EntityStore& tt::EntityStore::operator=(const EntityStore& other) {
+    if (this == &other) {
+        return *this;
+    }
+    positions_ = other.positions_;
+    orientations_ = other.orientations_;
+    velocities_ = other.velocities_;
+    accelerations_ = other.accelerations_;
+    angularVelocities_ = other.angularVelocities_;
+    entityIdentifiers_ = other.entityIdentifiers_;
+    entityTypes_ = other.entityTypes_;
+    radarCrossSectionSignatureIndices_ = other.radarCrossSectionSignatureIndices_;
+    deadReckoningAlgorithms_ = other.deadReckoningAlgorithms_;
+    frozen_ = other.frozen_;
+    referencePositions_ = other.referencePositions_;
+    referenceOrientations_ = other.referenceOrientations_;
+    deadReckoningTimes_ = other.deadReckoningTimes_;
+    slotOfIndex_ = other.slotOfIndex_;
+    indexOfSlot_ = other.indexOfSlot_;
+    generationOfSlot_ = other.generationOfSlot_;
+    freeSlots_ = other.freeSlots_;
+
+    // Consumers may have seen either revision of a different state, so neither may be reused
+    revision_ = std::max(revision_, other.revision_) + 1;
+    changes_.clear(revision_);
+    return *this;
+}
+
+tt::EntityHandle tt::EntityStore::add(const rpr_fom::PhysicalEntity& entity) {
+    std::vector<uint32_t>& indexOfSlot = indexOfSlot_.write();
+    std::vector<uint32_t>& generationOfSlot = generationOfSlot_.write();
+    uint32_t slot;
+    if (freeSlots_.read().empty()) {
+        slot = static_cast<uint32_t>(indexOfSlot.size());
+        indexOfSlot.push_back(EntityHandle::invalidSlot);
+        generationOfSlot.push_back(0);
+    }
+    else {
+        slot = freeSlots_.read().back();
+        freeSlots_.write().pop_back();
+    }
+
+    ++revision_;
+    const size_t index = size();
+    resize(index + 1);
+    write(index, entity);
+    slotOfIndex_.write().push_back(slot);
+    indexOfSlot[slot] = static_cast<uint32_t>(index);
+
+    const EntityHandle handle{slot, generationOfSlot[slot]};
+    changes_.recordAdded(handle, revision_);
+    limitChanges();
+    return handle;
+}
+
+bool tt::EntityStore::remove(const EntityHandle handle) {
+    if (!contains(handle)) {
+        return false;
+    }
+
+    ++revision_;
+    std::vector<uint32_t>& slotOfIndex = slotOfIndex_.write();
+    std::vector<uint32_t>& indexOfSlot = indexOfSlot_.write();
+    const size_t index = indexOfSlot[handle.slot];
+    const size_t last = size() - 1;
+    if (index != last) {
+        move(last, index);
+        slotOfIndex[index] = slotOfIndex[last];
+        indexOfSlot[slotOfIndex[index]] = static_cast<uint32_t>(index);
+    }
+    resize(last);
+    slotOfIndex.pop_back();
+
+    indexOfSlot[handle.slot] = EntityHandle::invalidSlot;
+    ++generationOfSlot_.write()[handle.slot];
+    freeSlots_.write().push_back(handle.slot);
+    changes_.recordRemoved(handle, revision_);
+    limitChanges();
+    return true;
+}
+
+bool tt::EntityStore::update(const EntityHandle handle, const rpr_fom::PhysicalEntity& entity) {
+    if (!contains(handle)) {
+        return false;
+    }
+    ++revision_;
+    changes_.recordUpdated(handle, write(indexOfSlot_.read()[handle.slot], entity), revision_);
+    limitChanges();
+    return true;
+}
+
+void tt::EntityStore::clear() {
+    ++revision_;
+    std::vector<uint32_t>& indexOfSlot = indexOfSlot_.write();
+    std::vector<uint32_t>& generationOfSlot = generationOfSlot_.write();
+    std::vector<uint32_t>& freeSlots = freeSlots_.write();
+    for (const uint32_t slot : slotOfIndex_.read()) {
+        indexOfSlot[slot] = EntityHandle::invalidSlot;
+        ++generationOfSlot[slot];
+        freeSlots.push_back(slot);
+    }
+    slotOfIndex_.write().clear();
+    resize(0);
+    // Consumers rather start over than remove every entity one by one
+    changes_.clear(revision_);
+}
+
+bool tt::EntityStore::contains(const EntityHandle handle) const {
+    const std::vector<uint32_t>& indexOfSlot = indexOfSlot_.read();
+    return handle.slot < indexOfSlot.size() &&
+        indexOfSlot[handle.slot] != EntityHandle::invalidSlot &&
+        generationOfSlot_.read()[handle.slot] == handle.generation;
+}
+
+tt::rpr_fom::PhysicalEntity tt::EntityStore::get(const EntityHandle handle) const {
+    const size_t index = indexOf(handle);
+
+    rpr_fom::PhysicalEntity entity;
+    entity.EntityIdentifier = entityIdentifiers_.read()[index];
+    entity.EntityType = entityTypes_.read()[index];
+    entity.RadarCrossSectionSignatureIndex = radarCrossSectionSignatureIndices_.read()[index];
+    entity.Spatial.DeadReckoningAlgorithm = deadReckoningAlgorithms_.read()[index];
+
+    const Columns3<double>& positions = positions_.read();
+    const Columns3<float>& orientations = orientations_.read();
+    const Columns3<float>& velocities = velocities_.read();
+    const Columns3<float>& accelerations = accelerations_.read();
+    const Columns3<float>& angularVelocities = angularVelocities_.read();
+    rpr_fom::SpatialRVStruct& spatial = entity.Spatial.SpatialRVW;
+    spatial.WorldLocation = {positions.x[index], positions.y[index], positions.z[index]};
+    spatial.IsFrozen = frozen_.read()[index] != 0;
+    spatial.Orientation = {orientations.x[index], orientations.y[index], orientations.z[index]};
+    spatial.VelocityVector = {velocities.x[index], velocities.y[index], velocities.z[index]};
+    spatial.AccelerationVector = {accelerations.x[index], accelerations.y[index], accelerations.z[index]};
+    spatial.AngularVelocity = {angularVelocities.x[index], angularVelocities.y[index], angularVelocities.z[index]};
+    return entity;
+}
+
+size_t tt::EntityStore::indexOf(const EntityHandle handle) const {
+    return indexOfSlot_.read()[handle.slot];
+}
+
+tt::EntityHandle tt::EntityStore::handleAt(const size_t index) const {
+    const uint32_t slot = slotOfIndex_.read()[index];
+    return {slot, generationOfSlot_.read()[slot]};
+}
+
+size_t tt::EntityStore::size() const {
+    return slotOfIndex_.read().size();
+}
+
+bool tt::EntityStore::empty() const {
+    return slotOfIndex_.read().empty();
+}
+
+uint64_t tt::EntityStore::getRevision() const {
+    return revision_;
+}
+
+const tt::EntityChangeSet& tt::EntityStore::getChanges() const {
+    return changes_;
+}
+
+tt::ColumnView3<const double> tt::EntityStore::getPositions() const {
+    const Columns3<double>& columns = positions_.read();
+    return {columns.x.data(), columns.y.data(), columns.z.data()};
+}
+
+tt::ColumnView3<double> tt::EntityStore::getPositions() {
+    ++revision_;
+    changes_.recordFieldsOfAll(PositionField, revision_);
+    Columns3<double>& columns = positions_.write();
+    return {columns.x.data(), columns.y.data(), columns.z.data()};
+}
+
+tt::ColumnView3<const float> tt::EntityStore::getOrientations() const {
+    const Columns3<float>& columns = orientations_.read();
+    return {columns.x.data(), columns.y.data(), columns.z.data()};
+}
+
+tt::ColumnView3<float> tt::EntityStore::getOrientations() {
+    ++revision_;
+    changes_.recordFieldsOfAll(OrientationField, revision_);
+    Columns3<float>& columns = orientations_.write();
+    return {columns.x.data(), columns.y.data(), columns.z.data()};
+}
+
+tt::ColumnView3<const float> tt::EntityStore::getVelocities() const {
+    const Columns3<float>& columns = velocities_.read();
+    return {columns.x.data(), columns.y.data(), columns.z.data()};
+}
+
+tt::ColumnView3<float> tt::EntityStore::getVelocities() {
+    ++revision_;
+    changes_.recordFieldsOfAll(VelocityField, revision_);
+    Columns3<float>& columns = velocities_.write();
+    return {columns.x.data(), columns.y.data(), columns.z.data()};
+}
+
+tt::ColumnView3<const float> tt::EntityStore::getAccelerations() const {
+    const Columns3<float>& columns = accelerations_.read();
+    return {columns.x.data(), columns.y.data(), columns.z.data()};
+}
+
+tt::ColumnView3<float> tt::EntityStore::getAccelerations() {
+    ++revision_;
+    changes_.recordFieldsOfAll(AccelerationField, revision_);
+    Columns3<float>& columns = accelerations_.write();
+    return {columns.x.data(), columns.y.data(), columns.z.data()};
+}
+
+tt::ColumnView3<const float> tt::EntityStore::getAngularVelocities() const {
+    const Columns3<float>& columns = angularVelocities_.read();
+    return {columns.x.data(), columns.y.data(), columns.z.data()};
+}
+
+tt::ColumnView3<float> tt::EntityStore::getAngularVelocities() {
+    ++revision_;
+    changes_.recordFieldsOfAll(AngularVelocityField, revision_);
+    Columns3<float>& columns = angularVelocities_.write();
+    return {columns.x.data(), columns.y.data(), columns.z.data()};
+}
+
+const tt::rpr_fom::EntityIdentifierStruct* tt::EntityStore::getEntityIdentifiers() const {
+    return entityIdentifiers_.read().data();
+}
+
+const tt::rpr_fom::EntityTypeStruct* tt::EntityStore::getEntityTypes() const {
+    return entityTypes_.read().data();
+}
+
+const int16_t* tt::EntityStore::getRadarCrossSectionSignatureIndices() const {
+    return radarCrossSectionSignatureIndices_.read().data();
+}
+
+const tt::rpr_fom::DeadReckoningAlgorithmEnum8* tt::EntityStore::getDeadReckoningAlgorithms() const {
+    return deadReckoningAlgorithms_.read().data();
+}
+
+const uint8_t* tt::EntityStore::getFrozen() const {
+    return frozen_.read().data();
+}
+
+tt::ColumnView3<const double> tt::EntityStore::getReferencePositions() const {
+    const Columns3<double>& columns = referencePositions_.read();
+    return {columns.x.data(), columns.y.data(), columns.z.data()};
+}
+
+tt::ColumnView3<const float> tt::EntityStore::getReferenceOrientations() const {
+    const Columns3<float>& columns = referenceOrientations_.read();
+    return {columns.x.data(), columns.y.data(), columns.z.data()};
+}
+
+const double* tt::EntityStore::getDeadReckoningTimes() const {
+    return deadReckoningTimes_.read().data();
+}
+
+double* tt::EntityStore::getDeadReckoningTimes() {
+    ++revision_;
+    changes_.recordFieldsOfAll(DeadReckoningField, revision_);
+    return deadReckoningTimes_.write().data();
+}
+
+uint32_t tt::EntityStore::write(const size_t index, const rpr_fom::PhysicalEntity& entity) {
+    const rpr_fom::SpatialRVStruct& spatial = entity.Spatial.SpatialRVW;
+    Columns3<double>& positions = positions_.write();
+    Columns3<float>& orientations = orientations_.write();
+    Columns3<float>& velocities = velocities_.write();
+    Columns3<float>& accelerations = accelerations_.write();
+    Columns3<float>& angularVelocities = angularVelocities_.write();
+    AlignedVector<rpr_fom::EntityIdentifierStruct>& entityIdentifiers = entityIdentifiers_.write();
+    AlignedVector<rpr_fom::EntityTypeStruct>& entityTypes = entityTypes_.write();
+    AlignedVector<int16_t>& radarCrossSectionSignatureIndices = radarCrossSectionSignatureIndices_.write();
+
+    // Which attributes differ from the current values, before they are overwritten. The reference state and the
+    // dead reckoning time are reset by every write.
+    uint32_t fields = DeadReckoningField;
+    const auto differs = [index](const auto& columns, const auto x, const auto y, const auto z) {
+        return columns.x[index] != x || columns.y[index] != y || columns.z[index] != z;
+    };
+    if (differs(positions, spatial.WorldLocation.X, spatial.WorldLocation.Y, spatial.WorldLocation.Z)) {
+        fields |= PositionField;
+    }
+    if (differs(orientations, spatial.Orientation.Psi, spatial.Orientation.Theta, spatial.Orientation.Phi)) {
+        fields |= OrientationField;
+    }
+    if (differs(velocities, spatial.VelocityVector.XVelocity, spatial.VelocityVector.YVelocity,
+                spatial.VelocityVector.ZVelocity)) {
+        fields |= VelocityField;
+    }
+    if (differs(accelerations, spatial.AccelerationVector.XAcceleration, spatial.AccelerationVector.YAcceleration,
+                spatial.AccelerationVector.ZAcceleration)) {
+        fields |= AccelerationField;
+    }
+    if (differs(angularVelocities, spatial.AngularVelocity.XAngularVelocity, spatial.AngularVelocity.YAngularVelocity,
+                spatial.AngularVelocity.ZAngularVelocity)) {
+        fields |= AngularVelocityField;
+    }
+    if (std::memcmp(&entityIdentifiers[index], &entity.EntityIdentifier, sizeof(entity.EntityIdentifier)) != 0) {
+        fields |= IdentifierField;
+    }
+    if (std::memcmp(&entityTypes[index], &entity.EntityType, sizeof(entity.EntityType)) != 0) {
+        fields |= TypeField;
+    }
+    if (radarCrossSectionSignatureIndices[index] != entity.RadarCrossSectionSignatureIndex) {
+        fields |= RadarCrossSectionSignatureField;
+    }
+
+    positions.x[index] = spatial.WorldLocation.X;
+    positions.y[index] = spatial.WorldLocation.Y;
+    positions.z[index] = spatial.WorldLocation.Z;
+    orientations.x[index] = spatial.Orientation.Psi;
+    orientations.y[index] = spatial.Orientation.Theta;
+    orientations.z[index] = spatial.Orientation.Phi;
+    velocities.x[index] = spatial.VelocityVector.XVelocity;
+    velocities.y[index] = spatial.VelocityVector.YVelocity;
+    velocities.z[index] = spatial.VelocityVector.ZVelocity;
+    accelerations.x[index] = spatial.AccelerationVector.XAcceleration;
+    accelerations.y[index] = spatial.AccelerationVector.YAcceleration;
+    accelerations.z[index] = spatial.AccelerationVector.ZAcceleration;
+    angularVelocities.x[index] = spatial.AngularVelocity.XAngularVelocity;
+    angularVelocities.y[index] = spatial.AngularVelocity.YAngularVelocity;
+    angularVelocities.z[index] = spatial.AngularVelocity.ZAngularVelocity;
+    entityIdentifiers[index] = entity.EntityIdentifier;
+    entityTypes[index] = entity.EntityType;
+    radarCrossSectionSignatureIndices[index] = entity.RadarCrossSectionSignatureIndex;
+    deadReckoningAlgorithms_.write()[index] = entity.Spatial.DeadReckoningAlgorithm;
+    frozen_.write()[index] = spatial.IsFrozen ? 1 : 0;
+
+    // The received state is the origin for dead reckoning until the next update
+    Columns3<double>& referencePositions = referencePositions_.write();
+    Columns3<float>& referenceOrientations = referenceOrientations_.write();
+    referencePositions.x[index] = positions.x[index];
+    referencePositions.y[index] = positions.y[index];
+    referencePositions.z[index] = positions.z[index];
+    referenceOrientations.x[index] = orientations.x[index];
+    referenceOrientations.y[index] = orientations.y[index];
+    referenceOrientations.z[index] = orientations.z[index];
+    deadReckoningTimes_.write()[index] = 0;
+    return fields;
+}
+
+void tt::EntityStore::limitChanges() {
+    // Compacting rarely enough that it costs amortised constant time per change
+    const size_t limit = std::max<size_t>(size(), 64);
+    if (changes_.size() > 2 * limit) {
+        changes_.compact(limit);
+    }
+}
+
+void tt::EntityStore::move(const size_t from, const size_t to) {
+    for (auto* columns : {&orientations_.write(), &velocities_.write(), &accelerations_.write(),
+                          &angularVelocities_.write(), &referenceOrientations_.write()}) {
+        columns->x[to] = columns->x[from];
+        columns->y[to] = columns->y[from];
+        columns->z[to] = columns->z[from];
+    }
+    for (auto* columns : {&positions_.write(), &referencePositions_.write()}) {
+        columns->x[to] = columns->x[from];
+        columns->y[to] = columns->y[from];
+        columns->z[to] = columns->z[from];
+    }
+    const auto moveElement = [from, to](auto& column) {
+        column[to] = column[from];
+    };
+    moveElement(deadReckoningTimes_.write());
+    moveElement(entityIdentifiers_.write());
+    moveElement(entityTypes_.write());
+    moveElement(radarCrossSectionSignatureIndices_.write());
+    moveElement(deadReckoningAlgorithms_.write());
+    moveElement(frozen_.write());
+}
+
+void tt::EntityStore::serialise(std::vector<uint8_t>& buffer) const {
+    const auto writeColumns = [&buffer](const auto& columns) {
+        const auto& value = columns.read();
+        for (const auto* column : {&value.x, &value.y, &value.z}) {
+            Serialiser<std::decay_t<decltype(*column)>>::write(*column, buffer);
+        }
+    };
+    const auto writeColumn = [&buffer](const auto& column) {
+        Serialiser<std::decay_t<decltype(column.read())>>::write(column.read(), buffer);
+    };
+
+    writeColumns(positions_);
+    writeColumns(orientations_);
+    writeColumns(velocities_);
+    writeColumns(accelerations_);
+    writeColumns(angularVelocities_);
+    writeColumn(entityIdentifiers_);
+    writeColumn(entityTypes_);
+    writeColumn(radarCrossSectionSignatureIndices_);
+    writeColumn(deadReckoningAlgorithms_);
+    writeColumn(frozen_);
+    writeColumns(referencePositions_);
+    writeColumns(referenceOrientations_);
+    writeColumn(deadReckoningTimes_);
+    writeColumn(slotOfIndex_);
+    writeColumn(indexOfSlot_);
+    writeColumn(generationOfSlot_);
+    writeColumn(freeSlots_);
+}
+
+bool tt::EntityStore::deserialise(ByteReader& reader) {
+    ++revision_;
+    bool valid = true;
+    const auto readColumns = [&reader, &valid](auto& columns) {
+        auto& value = columns.write();
+        for (auto* column : {&value.x, &value.y, &value.z}) {
+            valid = valid && Serialiser<std::decay_t<decltype(*column)>>::read(reader, *column);
+        }
+    };
+    const auto readColumn = [&reader, &valid](auto& column) {
+        valid = valid && Serialiser<std::decay_t<decltype(column.read())>>::read(reader, column.write());
+    };
+
+    readColumns(positions_);
+    readColumns(orientations_);
+    readColumns(velocities_);
+    readColumns(accelerations_);
+    readColumns(angularVelocities_);
+    readColumn(entityIdentifiers_);
+    readColumn(entityTypes_);
+    readColumn(radarCrossSectionSignatureIndices_);
+    readColumn(deadReckoningAlgorithms_);
+    readColumn(frozen_);
+    readColumns(referencePositions_);
+    readColumns(referenceOrientations_);
+    readColumn(deadReckoningTimes_);
+    readColumn(slotOfIndex_);
+    readColumn(indexOfSlot_);
+    readColumn(generationOfSlot_);
+    readColumn(freeSlots_);
+
+    // Every column has to hold exactly one element per entity, and every handle has to resolve to an entity
+    const std::vector<uint32_t>& slotOfIndex = slotOfIndex_.read();
+    const std::vector<uint32_t>& indexOfSlot = indexOfSlot_.read();
+    const std::vector<uint32_t>& freeSlots = freeSlots_.read();
+    const size_t count = slotOfIndex.size();
+    for (const auto* columns : {&orientations_.read(), &velocities_.read(), &accelerations_.read(),
+                                &angularVelocities_.read(), &referenceOrientations_.read()}) {
+        valid = valid && columns->x.size() == count && columns->y.size() == count && columns->z.size() == count;
+    }
+    for (const auto* columns : {&positions_.read(), &referencePositions_.read()}) {
+        valid = valid && columns->x.size() == count && columns->y.size() == count && columns->z.size() == count;
+    }
+    for (const size_t size : {entityIdentifiers_.read().size(), entityTypes_.read().size(),
+                              radarCrossSectionSignatureIndices_.read().size(), deadReckoningAlgorithms_.read().size(),
+                              frozen_.read().size(), deadReckoningTimes_.read().size()}) {
+        valid = valid && size == count;
+    }
+    valid = valid && indexOfSlot.size() == generationOfSlot_.read().size();
+    for (size_t index = 0; valid && index < count; ++index) {
+        valid = slotOfIndex[index] < indexOfSlot.size() && indexOfSlot[slotOfIndex[index]] == index;
+    }
+    for (size_t i = 0; valid && i < freeSlots.size(); ++i) {
+        valid = freeSlots[i] < indexOfSlot.size() && indexOfSlot[freeSlots[i]] == EntityHandle::invalidSlot;
+    }
+
+    if (!valid) {
+        slotOfIndex_.write().clear();
+        indexOfSlot_.write().clear();
+        generationOfSlot_.write().clear();
+        freeSlots_.write().clear();
+        resize(0);
+    }
+    changes_.clear(revision_);
+    return valid;
+}
+
+void tt::EntityStore::resize(const size_t size) {
+    for (auto* columns : {&orientations_.write(), &velocities_.write(), &accelerations_.write(),
+                          &angularVelocities_.write(), &referenceOrientations_.write()}) {
+        columns->x.resize(size);
+        columns->y.resize(size);
+        columns->z.resize(size);
+    }
+    for (auto* columns : {&positions_.write(), &referencePositions_.write()}) {
+        columns->x.resize(size);
+        columns->y.resize(size);
+        columns->z.resize(size);
+    }
+    deadReckoningTimes_.write().resize(size);
+    entityIdentifiers_.write().resize(size);
+    entityTypes_.write().resize(size);
+    radarCrossSectionSignatureIndices_.write().resize(size);
+    deadReckoningAlgorithms_.write().resize(size);
+    frozen_.write().resize(size);
+}
@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "TT/entity_store.h"
+
+namespace {
+    tt::rpr_fom::PhysicalEntity entityAt(const double x) {
+        tt::rpr_fom::PhysicalEntity entity;
+        entity.Spatial.SpatialRVW.WorldLocation.X = x;
+        return entity;
+    }
+}
+
+TEST(EntityStore, AddAndGet) {
+    tt::rpr_fom::PhysicalEntity entity;
+    entity.RadarCrossSectionSignatureIndex = 7;
+    entity.Spatial.DeadReckoningAlgorithm = tt::rpr_fom::DeadReckoningAlgorithmEnum8::DRM_FPW;
+    entity.Spatial.SpatialRVW.WorldLocation = {1, 2, 3};
+    entity.Spatial.SpatialRVW.Orientation = {0.1f, 0.2f, 0.3f};
+    entity.Spatial.SpatialRVW.VelocityVector = {4, 5, 6};
+
+    tt::EntityStore store;
+    const auto handle = store.add(entity);
+    ASSERT_TRUE(store.contains(handle));
+    ASSERT_EQ(1, store.size());
+
+    const auto stored = store.get(handle);
+    ASSERT_EQ(7, stored.RadarCrossSectionSignatureIndex);
+    ASSERT_EQ(tt::rpr_fom::DeadReckoningAlgorithmEnum8::DRM_FPW, stored.Spatial.DeadReckoningAlgorithm);
+    ASSERT_EQ(2, stored.Spatial.SpatialRVW.WorldLocation.Y);
+    ASSERT_EQ(0.3f, stored.Spatial.SpatialRVW.Orientation.Phi);
+    ASSERT_EQ(6, stored.Spatial.SpatialRVW.VelocityVector.ZVelocity);
+    ASSERT_EQ(3, store.getPositions().z[0]);
+}
+
+TEST(EntityStore, RemoveKeepsHandlesStable) {
+    tt::EntityStore store;
+    const auto first = store.add(entityAt(1));
+    const auto second = store.add(entityAt(2));
+    const auto third = store.add(entityAt(3));
+
+    ASSERT_TRUE(store.remove(first));
+    ASSERT_FALSE(store.contains(first));
+    ASSERT_FALSE(store.remove(first));
+    ASSERT_EQ(2, store.size());
+
+    // The last entity moved into the freed dense index, but its handle still resolves it
+    ASSERT_EQ(0, store.indexOf(third));
+    ASSERT_EQ(third, store.handleAt(0));
+    ASSERT_EQ(3, store.get(third).Spatial.SpatialRVW.WorldLocation.X);
+    ASSERT_EQ(2, store.get(second).Spatial.SpatialRVW.WorldLocation.X);
+
+    // A reused slot does not resurrect the old handle
+    const auto fourth = store.add(entityAt(4));
+    ASSERT_EQ(first.slot, fourth.slot);
+    ASSERT_FALSE(store.contains(first));
+    ASSERT_TRUE(store.contains(fourth));
+}
+
+TEST(EntityStore, ColumnsAreAligned) {
+    tt::EntityStore store;
+    for (int i = 0; i < 100; ++i) {
+        store.add(entityAt(i));
+    }
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(store.getPositions().x) % 64);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(store.getVelocities().y) % 64);
+
+    store.clear();
+    ASSERT_TRUE(store.empty());
+}
+
+TEST(EntityStore, SerialiseRoundTrip) {
+    tt::EntityStore store;
+    const auto first = store.add(entityAt(1));
+    const auto second = store.add(entityAt(2));
+    const auto third = store.add(entityAt(3));
+    store.remove(first);
+    store.getDeadReckoningTimes()[0] = 0.5;
+
+    std::vector<uint8_t> buffer;
+    store.serialise(buffer);
+
+    tt::EntityStore copy;
+    copy.add(entityAt(9));
+    tt::ByteReader reader(buffer.data(), buffer.size());
+    ASSERT_TRUE(copy.deserialise(reader));
+    ASSERT_EQ(0, reader.getRemaining());
+
+    // Handles of the original resolve to the same entities in the copy, the removed one stays invalid
+    ASSERT_EQ(2, copy.size());
+    ASSERT_FALSE(copy.contains(first));
+    ASSERT_EQ(2, copy.get(second).Spatial.SpatialRVW.WorldLocation.X);
+    ASSERT_EQ(3, copy.get(third).Spatial.SpatialRVW.WorldLocation.X);
+    ASSERT_EQ(0.5, copy.getDeadReckoningTimes()[0]);
+    ASSERT_EQ(store.indexOf(third), copy.indexOf(third));
+
+    // A handle added to the copy reuses the same slot as it would have in the original
+    ASSERT_EQ(store.add(entityAt(4)), copy.add(entityAt(4)));
+}
+
+TEST(EntityStore, CopiesShareColumnsUntilWritten) {
+    tt::EntityStore store;
+    const auto first = store.add(entityAt(1));
+    store.add(entityAt(2));
+    const tt::EntityStore& readStore = store;
+
+    // A copy shares every column and starts at the revision of the store, without changes
+    const tt::EntityStore copy(store);
+    ASSERT_EQ(readStore.getPositions().x, copy.getPositions().x);
+    ASSERT_EQ(readStore.getDeadReckoningTimes(), copy.getDeadReckoningTimes());
+    ASSERT_EQ(store.getRevision(), copy.getRevision());
+    ASSERT_EQ(0, copy.getChanges().size());
+
+    // Writing a column only copies that column
+    store.getDeadReckoningTimes()[0] = 1;
+    ASSERT_NE(readStore.getDeadReckoningTimes(), copy.getDeadReckoningTimes());
+    ASSERT_EQ(0, copy.getDeadReckoningTimes()[0]);
+    ASSERT_EQ(readStore.getPositions().x, copy.getPositions().x);
+    ASSERT_TRUE(store.update(first, entityAt(3)));
+    ASSERT_NE(readStore.getPositions().x, copy.getPositions().x);
+    ASSERT_EQ(1, copy.getPositions().x[0]);
+
+    // Assigning moves the revision past both stores, so consumers of either start over
+    tt::EntityStore assigned;
+    assigned.add(entityAt(4));
+    const uint64_t revision = std::max(store.getRevision(), assigned.getRevision());
+    assigned = store;
+    ASSERT_EQ(readStore.getPositions().x, std::as_const(assigned).getPositions().x);
+    ASSERT_GT(assigned.getRevision(), revision);
+    ASSERT_FALSE(assigned.getChanges().covers(revision));
+    ASSERT_EQ(3, assigned.get(first).Spatial.SpatialRVW.WorldLocation.X);
+}
+
+TEST(EntityStore, DeserialiseRejectsTruncatedData) {
+    tt::EntityStore store;
+    store.add(entityAt(1));
+    std::vector<uint8_t> buffer;
+    store.serialise(buffer);
+
+    tt::EntityStore copy;
+    tt::ByteReader reader(buffer.data(), buffer.size() - 1);
+    ASSERT_FALSE(copy.deserialise(reader));
+    ASSERT_TRUE(copy.empty());
+}
+
+namespace {
+    std::vector<tt::EntityChange> changesSince(const tt::EntityStore& store, const uint64_t revision) {
+        std::vector<tt::EntityChange> changes;
+        store.getChanges().forEachSince(revision, [&changes](const tt::EntityChange& change) {
+            changes.push_back(change);
+        });
+        return changes;
+    }
+}
+
+TEST(EntityStore, ChangeSetRecordsChurn) {
+    tt::EntityStore store;
+    const auto kept = store.add(entityAt(1));
+    const auto removed = store.add(entityAt(2));
+    const auto updated = store.add(entityAt(3));
+    ASSERT_EQ(3, changesSince(store, 0).size());
+    const uint64_t revision = store.getRevision();
+    ASSERT_TRUE(changesSince(store, revision).empty());
+
+    // Only the attributes which changed are marked
+    tt::rpr_fom::PhysicalEntity entity = entityAt(3);
+    entity.EntityType.Domain = 2;
+    ASSERT_TRUE(store.update(updated, entity));
+    entity.Spatial.SpatialRVW.WorldLocation.X = 4;
+    ASSERT_TRUE(store.update(updated, entity));
+    ASSERT_TRUE(store.remove(removed));
+    const auto transient = store.add(entityAt(5));
+    const auto added = store.add(entityAt(6));
+    ASSERT_TRUE(store.update(added, entityAt(7)));
+    ASSERT_TRUE(store.remove(transient));
+
+    // Each entity appears once, in the order of its latest change
+    const tt::EntityChangeSet& changes = store.getChanges();
+    ASSERT_TRUE(changes.covers(revision));
+    std::vector<tt::EntityChange> since = changesSince(store, revision);
+    ASSERT_EQ(4, since.size());
+    ASSERT_EQ(updated, since[0].handle);
+    ASSERT_EQ(tt::EntityChange::Updated, since[0].kind);
+    ASSERT_EQ(tt::PositionField | tt::TypeField | tt::DeadReckoningField, since[0].fields);
+    ASSERT_EQ(removed, since[1].handle);
+    ASSERT_EQ(tt::EntityChange::Removed, since[1].kind);
+    ASSERT_EQ(added, since[2].handle);
+    ASSERT_EQ(tt::EntityChange::Added, since[2].kind);
+    ASSERT_EQ(transient, since[3].handle);
+    ASSERT_EQ(tt::EntityChange::Removed, since[3].kind);
+    ASSERT_EQ(0, changes.getFieldsOfAll(revision));
+
+    // A consumer which saw the entity being added only sees an update
+    const uint64_t addedRevision = store.getRevision() - 2;
+    since = changesSince(store, addedRevision);
+    ASSERT_EQ(2, since.size());
+    ASSERT_EQ(added, since[0].handle);
+    ASSERT_EQ(tt::EntityChange::Updated, since[0].kind);
+
+    // Removing an updated entity leaves it removed only, writing through a column marks every entity
+    const uint64_t columnRevision = store.getRevision();
+    ASSERT_TRUE(store.remove(updated));
+    since = changesSince(store, revision);
+    ASSERT_EQ(4, since.size());
+    ASSERT_EQ(updated, since.back().handle);
+    ASSERT_EQ(tt::EntityChange::Removed, since.back().kind);
+    store.getPositions().x[store.indexOf(kept)] = 10;
+    ASSERT_EQ(tt::PositionField, changes.getFieldsOfAll(revision));
+    ASSERT_EQ(tt::PositionField, changes.getFieldsOfAll(columnRevision));
+    ASSERT_EQ(0, changes.getFieldsOfAll(store.getRevision()));
+
+    // Clearing or restoring the store starts over
+    store.clear();
+    ASSERT_EQ(0, changes.size());
+    ASSERT_FALSE(changes.covers(revision));
+}
+
+TEST(EntityStore, ChangeSetIsLimitedByStoreSize) {
+    tt::EntityStore store;
+    std::vector<tt::EntityHandle> handles;
+    for (int i = 0; i < 100; ++i) {
+        handles.push_back(store.add(entityAt(i)));
+    }
+    const uint64_t revision = store.getRevision();
+
+    // Updating the same entities over and over only keeps their latest changes
+    for (int pass = 0; pass < 10; ++pass) {
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_TRUE(store.update(handles[i], entityAt(pass * 100 + i + 1000)));
+        }
+    }
+    ASSERT_LE(store.getChanges().size(), 200);
+    ASSERT_TRUE(store.getChanges().covers(revision));
+    ASSERT_EQ(10, changesSince(store, revision).size());
+
+    // Removing most entities drops the oldest changes, which no longer covers the previous revision
+    for (int i = 0; i < 90; ++i) {
+        ASSERT_TRUE(store.remove(store.handleAt(0)));
+    }
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(store.update(store.handleAt(i % store.size()), entityAt(i + 5000)));
+    }
+    ASSERT_LE(store.getChanges().size(), 128);
+    ASSERT_FALSE(store.getChanges().covers(revision));
+}
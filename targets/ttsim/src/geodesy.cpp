@@ -0,0 +1,21 @@
+#include "TT/geodesy.h"
+
+void tt::math::geodeticToEcef(const double* latitudes, const double* longitudes, const double* altitudes,
+                              const size_t count, double* x, double* y, double* z) {
+    for (size_t i = 0; i < count; ++i) {
+        const Eigen::Vector3d ecef = geodeticToEcef(latitudes[i], longitudes[i], altitudes[i]);
+        x[i] = ecef.x();
+        y[i] = ecef.y();
+        z[i] = ecef.z();
+    }
+}
+
+void tt::math::ecefToGeodetic(const double* x, const double* y, const double* z, const size_t count,
+                              double* latitudes, double* longitudes, double* altitudes) {
+    for (size_t i = 0; i < count; ++i) {
+        const GeodeticPosition position = ecefToGeodetic(x[i], y[i], z[i]);
+        latitudes[i] = position.latitude;
+        longitudes[i] = position.longitude;
+        altitudes[i] = position.altitude;
+    }
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/LU>
+
+#include "TT/geodesy.h"
+
+namespace {
+    constexpr double positionTolerance = 1e-6; // meter
+
+    constexpr double angleTolerance = 1e-12; // radian
+}
+
+TEST(Geodesy, GeodeticToEcefOfKnownPoints) {
+    const Eigen::Vector3d origin = tt::math::geodeticToEcef(0, 0, 0);
+    ASSERT_NEAR(tt::math::wgs84SemiMajorAxis, origin.x(), positionTolerance);
+    ASSERT_NEAR(0, origin.y(), positionTolerance);
+    ASSERT_NEAR(0, origin.z(), positionTolerance);
+
+    const Eigen::Vector3d east = tt::math::geodeticToEcef(0, M_PI_2, 1000);
+    ASSERT_NEAR(0, east.x(), positionTolerance);
+    ASSERT_NEAR(tt::math::wgs84SemiMajorAxis + 1000, east.y(), positionTolerance);
+    ASSERT_NEAR(0, east.z(), positionTolerance);
+
+    const Eigen::Vector3d southPole = tt::math::geodeticToEcef(-M_PI_2, 0, 0);
+    ASSERT_NEAR(0, southPole.x(), positionTolerance);
+    ASSERT_NEAR(0, southPole.y(), positionTolerance);
+    ASSERT_NEAR(-tt::math::wgs84SemiMinorAxis, southPole.z(), positionTolerance);
+}
+
+TEST(Geodesy, EcefToGeodeticOfKnownPoints) {
+    const tt::math::GeodeticPosition equator = tt::math::ecefToGeodetic(tt::math::wgs84SemiMajorAxis + 10, 0, 0);
+    ASSERT_NEAR(0, equator.latitude, angleTolerance);
+    ASSERT_NEAR(0, equator.longitude, angleTolerance);
+    ASSERT_NEAR(10, equator.altitude, positionTolerance);
+
+    const tt::math::GeodeticPosition northPole = tt::math::ecefToGeodetic(0, 0, tt::math::wgs84SemiMinorAxis - 10);
+    ASSERT_NEAR(M_PI_2, northPole.latitude, angleTolerance);
+    ASSERT_NEAR(-10, northPole.altitude, positionTolerance);
+
+    const tt::math::GeodeticPosition center = tt::math::ecefToGeodetic(0, 0, 0);
+    ASSERT_EQ(0, center.latitude);
+    ASSERT_EQ(0, center.longitude);
+    ASSERT_EQ(-tt::math::wgs84SemiMajorAxis, center.altitude);
+}
+
+TEST(Geodesy, RoundTripIsWithinErrorBound) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> latitudeDistribution(-M_PI_2, M_PI_2);
+    std::uniform_real_distribution<double> longitudeDistribution(-M_PI, M_PI);
+    // From the lower edge of the domain of the closed form out to geosynchronous orbit, with a third of the positions
+    // near the surface and a third at the lower edge
+    constexpr double lowestAltitude = -4000000;
+    std::uniform_real_distribution<double> altitudeDistribution(lowestAltitude, 36000000);
+
+    for (int i = 0; i < 150000; ++i) {
+        const double latitude = i < 2 ? (i == 0 ? M_PI_2 : -M_PI_2) : latitudeDistribution(generator);
+        const double longitude = longitudeDistribution(generator);
+        const double altitude = i % 3 == 0 ? altitudeDistribution(generator)
+            : i % 3 == 1 ? altitudeDistribution(generator) / 1000
+            : lowestAltitude;
+
+        const tt::math::GeodeticPosition position =
+            tt::math::ecefToGeodetic(tt::math::geodeticToEcef(latitude, longitude, altitude));
+        ASSERT_NEAR(latitude, position.latitude, angleTolerance);
+        ASSERT_NEAR(altitude, position.altitude, positionTolerance);
+        if (std::abs(latitude) < M_PI_2 - 1e-6) {
+            ASSERT_NEAR(longitude, position.longitude, angleTolerance);
+        }
+    }
+}
+
+TEST(Geodesy, BatchedConversionsMatchSingleConversions) {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> latitudeDistribution(-M_PI_2, M_PI_2);
+    std::uniform_real_distribution<double> longitudeDistribution(-M_PI, M_PI);
+    std::uniform_real_distribution<double> altitudeDistribution(-500, 20000);
+
+    constexpr size_t count = 1000;
+    std::vector<double> latitudes(count);
+    std::vector<double> longitudes(count);
+    std::vector<double> altitudes(count);
+    for (size_t i = 0; i < count; ++i) {
+        latitudes[i] = latitudeDistribution(generator);
+        longitudes[i] = longitudeDistribution(generator);
+        altitudes[i] = altitudeDistribution(generator);
+    }
+
+    std::vector<double> x(count);
+    std::vector<double> y(count);
+    std::vector<double> z(count);
+    tt::math::geodeticToEcef(latitudes.data(), longitudes.data(), altitudes.data(), count, x.data(), y.data(),
+                             z.data());
+    std::vector<double> latitudesBack(count);
+    std::vector<double> longitudesBack(count);
+    std::vector<double> altitudesBack(count);
+    tt::math::ecefToGeodetic(x.data(), y.data(), z.data(), count, latitudesBack.data(), longitudesBack.data(),
+                             altitudesBack.data());
+
+    for (size_t i = 0; i < count; ++i) {
+        const Eigen::Vector3d ecef = tt::math::geodeticToEcef(latitudes[i], longitudes[i], altitudes[i]);
+        ASSERT_NEAR(ecef.x(), x[i], positionTolerance);
+        ASSERT_NEAR(ecef.y(), y[i], positionTolerance);
+        ASSERT_NEAR(ecef.z(), z[i], positionTolerance);
+
+        const tt::math::GeodeticPosition position = tt::math::ecefToGeodetic(x[i], y[i], z[i]);
+        ASSERT_EQ(position.latitude, latitudesBack[i]);
+        ASSERT_EQ(position.longitude, longitudesBack[i]);
+        ASSERT_EQ(position.altitude, altitudesBack[i]);
+    }
+}
+
+TEST(Geodesy, LocalFrames) {
+    const double latitude = 0.9;
+    const double longitude = -2.1;
+    const Eigen::Matrix3d nedToEcef = tt::math::getNedToEcef(latitude, longitude);
+    const Eigen::Matrix3d enuToEcef = tt::math::getEnuToEcef(latitude, longitude);
+    ASSERT_TRUE((nedToEcef.transpose() * nedToEcef).isIdentity(1e-12));
+    ASSERT_TRUE((enuToEcef.transpose() * enuToEcef).isIdentity(1e-12));
+    ASSERT_NEAR(1, nedToEcef.determinant(), 1e-12);
+    ASSERT_NEAR(1, enuToEcef.determinant(), 1e-12);
+
+    // Both frames share the north and east directions, and up is the ellipsoid normal
+    ASSERT_TRUE(nedToEcef.col(0).isApprox(enuToEcef.col(1)));
+    ASSERT_TRUE(nedToEcef.col(1).isApprox(enuToEcef.col(0)));
+    ASSERT_TRUE(nedToEcef.col(2).isApprox(-enuToEcef.col(2)));
+    const Eigen::Vector3d surface = tt::math::geodeticToEcef(latitude, longitude, 0);
+    const Eigen::Vector3d above = tt::math::geodeticToEcef(latitude, longitude, 100);
+    ASSERT_TRUE(((above - surface) / 100).isApprox(enuToEcef.col(2), 1e-9));
+    ASSERT_GT(nedToEcef.col(0).z(), 0);
+
+    const tt::math::GeodeticPosition origin{latitude, longitude, 50};
+    const Eigen::Vector3d ned = tt::math::ecefToNed(tt::math::geodeticToEcef(latitude, longitude, 150), origin);
+    ASSERT_NEAR(0, ned.x(), positionTolerance);
+    ASSERT_NEAR(0, ned.y(), positionTolerance);
+    ASSERT_NEAR(-100, ned.z(), positionTolerance);
+    const Eigen::Vector3d enu = tt::math::ecefToEnu(tt::math::geodeticToEcef(latitude, longitude, 150), origin);
+    ASSERT_NEAR(100, enu.z(), positionTolerance);
+}
@@ -0,0 +1,273 @@
+#include "TT/interest_management.h"
+
+#include <algorithm>
+
+namespace {
+    /// Relative slack of the exact region tests, so that consumers gating with the same region in a different order of
+    /// operations never miss an entity on its boundary
+    constexpr double slack = 1e-9;
+
+    /// The exact test of the entities of a store against a region.
+    class RegionTest {
+    public:
+        RegionTest(const tt::InterestRegion& region, const tt::EntityStore& entities) :
+            region(region),
+            positions(entities.getPositions()),
+            entityTypes(entities.getEntityTypes()),
+            rangeSquared(region.range * region.range * (1 + slack)),
+            directional(region.shape == tt::InterestRegion::Cone && region.halfAngle < M_PI),
+            cosHalfAngle(std::cos(region.halfAngle)) {
+        }
+
+        bool operator()(const size_t i) const {
+            if (!region.matchesType(entityTypes[i])) {
+                return false;
+            }
+            if (region.shape == tt::InterestRegion::Everywhere) {
+                return true;
+            }
+            const Eigen::Vector3d offset =
+                Eigen::Vector3d(positions.x[i], positions.y[i], positions.z[i]) - region.center;
+            const double distanceSquared = offset.squaredNorm();
+            // Inside the cone if the angle between the axis and the offset is at most the half angle
+            return distanceSquared <= rangeSquared &&
+                (!directional || offset.dot(region.axis) >= std::sqrt(distanceSquared) * (cosHalfAngle - slack));
+        }
+
+    private:
+        const tt::InterestRegion& region;
+
+        const tt::ColumnView3<const double> positions;
+
+        const tt::rpr_fom::EntityTypeStruct* const entityTypes;
+
+        const double rangeSquared;
+
+        const bool directional;
+
+        const double cosHalfAngle;
+    };
+}
+
+tt::InterestRegion tt::InterestRegion::sphere(const Eigen::Vector3d& center, const double range) {
+    InterestRegion region;
+    region.shape = Sphere;
+    region.center = center;
+    region.range = range;
+    return region;
+}
+
+tt::InterestRegion tt::InterestRegion::cone(const Eigen::Vector3d& apex, const Eigen::Vector3d& axis,
+                                            const double halfAngle, const double range) {
+    InterestRegion region;
+    region.shape = Cone;
+    region.center = apex;
+    region.axis = axis;
+    region.halfAngle = halfAngle;
+    region.range = range;
+    return region;
+}
+
+bool tt::InterestRegion::matchesType(const rpr_fom::EntityTypeStruct& entityType) const {
+    if (entityTypes.empty()) {
+        return true;
+    }
+    const auto matches = [](const auto filter, const auto value) {
+        return filter == 0 || filter == value;
+    };
+    for (const rpr_fom::EntityTypeStruct& filter : entityTypes) {
+        if (matches(filter.EntityKind, entityType.EntityKind) && matches(filter.Domain, entityType.Domain) &&
+            matches(filter.CountryCode, entityType.CountryCode) && matches(filter.Category, entityType.Category) &&
+            matches(filter.Subcategory, entityType.Subcategory) && matches(filter.Specific, entityType.Specific) &&
+            matches(filter.Extra, entityType.Extra)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool tt::InterestRegion::operator==(const InterestRegion& other) const {
+    if (shape != other.shape || center != other.center || axis != other.axis || halfAngle != other.halfAngle ||
+        range != other.range || entityTypes.size() != other.entityTypes.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < entityTypes.size(); ++i) {
+        const rpr_fom::EntityTypeStruct& a = entityTypes[i];
+        const rpr_fom::EntityTypeStruct& b = other.entityTypes[i];
+        if (a.EntityKind != b.EntityKind || a.Domain != b.Domain || a.CountryCode != b.CountryCode ||
+            a.Category != b.Category || a.Subcategory != b.Subcategory || a.Specific != b.Specific ||
+            a.Extra != b.Extra) {
+            return false;
+        }
+    }
+    return true;
+}
+
+tt::InterestManager::SubscriptionId tt::InterestManager::subscribe(const InterestRegion& region) {
+    SubscriptionId subscription;
+    if (freeSubscriptions_.empty()) {
+        subscription = static_cast<SubscriptionId>(subscriptions_.size());
+        subscriptions_.emplace_back();
+    }
+    else {
+        subscription = freeSubscriptions_.back();
+        freeSubscriptions_.pop_back();
+    }
+    Subscription& added = subscriptions_[subscription];
+    added.active = true;
+    added.dirty = true;
+    added.region = region;
+    added.view = {};
+    return subscription;
+}
+
+bool tt::InterestManager::unsubscribe(const SubscriptionId subscription) {
+    if (subscription >= subscriptions_.size() || !subscriptions_[subscription].active) {
+        return false;
+    }
+    subscriptions_[subscription].active = false;
+    subscriptions_[subscription].view = {};
+    freeSubscriptions_.push_back(subscription);
+    return true;
+}
+
+bool tt::InterestManager::setRegion(const SubscriptionId subscription, const InterestRegion& region) {
+    if (subscription >= subscriptions_.size() || !subscriptions_[subscription].active) {
+        return false;
+    }
+    Subscription& changed = subscriptions_[subscription];
+    if (changed.region != region) {
+        changed.region = region;
+        changed.dirty = true;
+    }
+    return true;
+}
+
+const tt::InterestRegion* tt::InterestManager::getRegion(const SubscriptionId subscription) const {
+    if (subscription >= subscriptions_.size() || !subscriptions_[subscription].active) {
+        return nullptr;
+    }
+    return &subscriptions_[subscription].region;
+}
+
+void tt::InterestManager::synchronise(const EntityStore& entities, const SpatialGrid& entityIndex) {
+    const SpatialGrid* index = entityIndex.getSynchronisedRevision() == entities.getRevision() ? &entityIndex : nullptr;
+    // Unless every position or type may have changed, views covered by the change set of the store catch up by
+    // testing the entities which changed since they were last synchronised
+    const EntityChangeSet& changes = entities.getChanges();
+    const auto isIncremental = [&changes](const uint64_t revision) {
+        return changes.covers(revision) && (changes.getFieldsOfAll(revision) & (PositionField | TypeField)) == 0;
+    };
+    for (Subscription& subscription : subscriptions_) {
+        if (!subscription.active || (!subscription.dirty && subscription.view.revision_ == entities.getRevision())) {
+            continue;
+        }
+        if (subscription.dirty || !isIncremental(subscription.view.revision_)) {
+            rebuild(subscription, entities, index);
+        }
+        else {
+            applyChanges(subscription, entities);
+        }
+    }
+}
+
+const tt::InterestView* tt::InterestManager::getView(const SubscriptionId subscription) const {
+    if (subscription >= subscriptions_.size() || !subscriptions_[subscription].active) {
+        return nullptr;
+    }
+    return &subscriptions_[subscription].view;
+}
+
+size_t tt::InterestManager::size() const {
+    return subscriptions_.size() - freeSubscriptions_.size();
+}
+
+void tt::InterestManager::rebuild(Subscription& subscription, const EntityStore& entities,
+                                  const SpatialGrid* entityIndex) {
+    const InterestRegion& region = subscription.region;
+    InterestView& view = subscription.view;
+
+    // Candidates come from the cells near the region if possible, and are tested exactly below
+    candidateIndices_.clear();
+    if (region.shape == InterestRegion::Everywhere || entityIndex == nullptr) {
+        for (uint32_t i = 0; i < entities.size(); ++i) {
+            candidateIndices_.push_back(i);
+        }
+    }
+    else {
+        candidates_.clear();
+        if (region.shape == InterestRegion::Cone) {
+            entityIndex->queryCone(region.center, region.axis, region.halfAngle, region.range, candidates_);
+        }
+        else {
+            entityIndex->querySphere(region.center, region.range, candidates_);
+        }
+        for (const EntityHandle handle : candidates_) {
+            candidateIndices_.push_back(static_cast<uint32_t>(entities.indexOf(handle)));
+        }
+        std::sort(candidateIndices_.begin(), candidateIndices_.end());
+    }
+
+    const RegionTest isInside(region, entities);
+    view.indices_.clear();
+    view.handles_.clear();
+    for (const uint32_t i : candidateIndices_) {
+        if (isInside(i)) {
+            view.indices_.push_back(i);
+            view.handles_.push_back(entities.handleAt(i));
+        }
+    }
+    view.revision_ = entities.getRevision();
+    subscription.dirty = false;
+}
+
+void tt::InterestManager::applyChanges(Subscription& subscription, const EntityStore& entities) {
+    const EntityChangeSet& changes = entities.getChanges();
+    InterestView& view = subscription.view;
+
+    // Mark the slots of every entity which may have entered or left the region
+    ++changeMark_;
+    const auto mayMove = [](const EntityChange& change) {
+        return change.kind != EntityChange::Updated || (change.fields & (PositionField | TypeField)) != 0;
+    };
+    changes.forEachSince(view.revision_, [&](const EntityChange& change) {
+        if (mayMove(change)) {
+            if (change.handle.slot >= changeMarkOfSlot_.size()) {
+                changeMarkOfSlot_.resize(change.handle.slot + 1, 0);
+            }
+            changeMarkOfSlot_[change.handle.slot] = changeMark_;
+        }
+    });
+    const auto isMarked = [this](const EntityHandle handle) {
+        return handle.slot < changeMarkOfSlot_.size() && changeMarkOfSlot_[handle.slot] == changeMark_;
+    };
+
+    // Unchanged entities stay in the view, the changed ones are tested again. Removals move entities to other dense
+    // indices, so the indices of the whole view are looked up again and sorted.
+    entries_.clear();
+    for (const EntityHandle handle : view.handles_) {
+        if (!isMarked(handle)) {
+            entries_.emplace_back(static_cast<uint32_t>(entities.indexOf(handle)), handle);
+        }
+    }
+    const RegionTest isInside(subscription.region, entities);
+    changes.forEachSince(view.revision_, [&](const EntityChange& change) {
+        if (change.kind != EntityChange::Removed && mayMove(change)) {
+            const size_t i = entities.indexOf(change.handle);
+            if (isInside(i)) {
+                entries_.emplace_back(static_cast<uint32_t>(i), change.handle);
+            }
+        }
+    });
+    std::sort(entries_.begin(), entries_.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    view.indices_.clear();
+    view.handles_.clear();
+    for (const auto& [index, handle] : entries_) {
+        view.indices_.push_back(index);
+        view.handles_.push_back(handle);
+    }
+    view.revision_ = entities.getRevision();
+}
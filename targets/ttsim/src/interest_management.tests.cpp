@@ -0,0 +1,251 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "TT/interest_management.h"
+
+namespace {
+    tt::rpr_fom::PhysicalEntity entityAt(const double x, const double y, const double z, const uint8_t domain = 2) {
+        tt::rpr_fom::PhysicalEntity entity;
+        entity.EntityType.EntityKind = 1;
+        entity.EntityType.Domain = domain;
+        entity.Spatial.SpatialRVW.WorldLocation = {x, y, z};
+        return entity;
+    }
+}
+
+TEST(InterestManagement, FiltersByRegionAndType) {
+    tt::EntityStore store;
+    const auto near = store.add(entityAt(100, 0, 0));
+    const auto ahead = store.add(entityAt(3000, 100, 0));
+    const auto behind = store.add(entityAt(-3000, 0, 0));
+    const auto ship = store.add(entityAt(0, 200, 0, 3));
+    store.add(entityAt(50000, 0, 0));
+    tt::SpatialGrid grid(1000);
+    grid.synchronise(store);
+
+    tt::InterestManager interest;
+    const auto everything = interest.subscribe({});
+    const auto sphere = interest.subscribe(tt::InterestRegion::sphere({0, 0, 0}, 5000));
+    const auto cone = interest.subscribe(tt::InterestRegion::cone({0, 0, 0}, {1, 0, 0}, 0.3, 5000));
+    tt::InterestRegion air = tt::InterestRegion::sphere({0, 0, 0}, 5000);
+    air.entityTypes.push_back({1, 2});
+    const auto airborne = interest.subscribe(air);
+    ASSERT_EQ(4, interest.size());
+    ASSERT_EQ(0, interest.getView(sphere)->size());
+
+    interest.synchronise(store, grid);
+    ASSERT_EQ(5, interest.getView(everything)->size());
+    const std::vector<tt::EntityHandle> expectedSphere = {near, ahead, behind, ship};
+    ASSERT_EQ(expectedSphere, interest.getView(sphere)->getHandles());
+    ASSERT_EQ(store.getRevision(), interest.getView(sphere)->getRevision());
+    const std::vector<tt::EntityHandle> expectedCone = {near, ahead};
+    ASSERT_EQ(expectedCone, interest.getView(cone)->getHandles());
+    const std::vector<tt::EntityHandle> expectedAirborne = {near, ahead, behind};
+    ASSERT_EQ(expectedAirborne, interest.getView(airborne)->getHandles());
+
+    // Indices are sorted and match the handles
+    const tt::InterestView& view = *interest.getView(sphere);
+    for (size_t i = 0; i < view.size(); ++i) {
+        ASSERT_EQ(view.getHandles()[i], store.handleAt(view.getIndices()[i]));
+        ASSERT_TRUE(i == 0 || view.getIndices()[i - 1] < view.getIndices()[i]);
+    }
+}
+
+TEST(InterestManagement, ViewsFollowEntitiesAndRegions) {
+    tt::EntityStore store;
+    const auto mover = store.add(entityAt(100, 0, 0));
+    const auto removed = store.add(entityAt(200, 0, 0));
+    tt::SpatialGrid grid(1000);
+    tt::InterestManager interest;
+    const auto subscription = interest.subscribe(tt::InterestRegion::sphere({0, 0, 0}, 1000));
+    grid.synchronise(store);
+    interest.synchronise(store, grid);
+    ASSERT_EQ(2, interest.getView(subscription)->size());
+
+    // Entities leave the view as they move out or are removed
+    store.getPositions().x[store.indexOf(mover)] = 20000;
+    store.remove(removed);
+    grid.synchronise(store);
+    interest.synchronise(store, grid);
+    ASSERT_EQ(0, interest.getView(subscription)->size());
+
+    // And enter it once the region follows them
+    ASSERT_TRUE(interest.setRegion(subscription, tt::InterestRegion::sphere({20000, 0, 0}, 1000)));
+    interest.synchronise(store, grid);
+    const std::vector<tt::EntityHandle> expected = {mover};
+    ASSERT_EQ(expected, interest.getView(subscription)->getHandles());
+
+    // Without a synchronised spatial index every entity is tested
+    store.getPositions().x[store.indexOf(mover)] = 20500;
+    interest.synchronise(store, grid);
+    ASSERT_EQ(expected, interest.getView(subscription)->getHandles());
+    ASSERT_EQ(store.getRevision(), interest.getView(subscription)->getRevision());
+
+    ASSERT_TRUE(interest.unsubscribe(subscription));
+    ASSERT_FALSE(interest.unsubscribe(subscription));
+    ASSERT_FALSE(interest.setRegion(subscription, {}));
+    ASSERT_EQ(nullptr, interest.getView(subscription));
+    ASSERT_EQ(nullptr, interest.getRegion(subscription));
+    ASSERT_EQ(0, interest.size());
+    ASSERT_EQ(subscription, interest.subscribe({}));
+}
+
+TEST(InterestManagement, MatchesBruteForce) {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> coordinate(-20000, 20000);
+    tt::EntityStore store;
+    for (int i = 0; i < 2000; ++i) {
+        store.add(entityAt(coordinate(random), coordinate(random), coordinate(random), i % 2 + 1));
+    }
+    tt::SpatialGrid grid(2000);
+    grid.synchronise(store);
+
+    tt::InterestManager interest;
+    std::vector<tt::InterestRegion> regions;
+    for (int i = 0; i < 20; ++i) {
+        const Eigen::Vector3d center(coordinate(random), coordinate(random), coordinate(random));
+        const Eigen::Vector3d axis =
+            Eigen::Vector3d(coordinate(random), coordinate(random), coordinate(random)).normalized();
+        tt::InterestRegion region = i % 2 == 0 ? tt::InterestRegion::sphere(center, 8000)
+                                               : tt::InterestRegion::cone(center, axis, 0.2 * i, 15000);
+        if (i % 3 == 0) {
+            region.entityTypes.push_back({0, 2});
+        }
+        regions.push_back(region);
+        interest.subscribe(region);
+    }
+    interest.synchronise(store, grid);
+
+    const auto positions = store.getPositions();
+    for (tt::InterestManager::SubscriptionId subscription = 0; subscription < regions.size(); ++subscription) {
+        const tt::InterestRegion& region = regions[subscription];
+        std::vector<uint32_t> expected;
+        for (uint32_t i = 0; i < store.size(); ++i) {
+            const Eigen::Vector3d offset =
+                Eigen::Vector3d(positions.x[i], positions.y[i], positions.z[i]) - region.center;
+            const bool inside = offset.norm() <= region.range &&
+                (region.shape == tt::InterestRegion::Sphere ||
+                 std::acos(offset.normalized().dot(region.axis)) <= region.halfAngle);
+            if (inside && region.matchesType(store.getEntityTypes()[i])) {
+                expected.push_back(i);
+            }
+        }
+        ASSERT_FALSE(expected.empty());
+        ASSERT_EQ(expected, interest.getView(subscription)->getIndices());
+    }
+}
+
+TEST(InterestManagement, ViewsCatchUpFromChangeSet) {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> coordinate(-20000, 20000);
+    tt::EntityStore store;
+    std::vector<tt::EntityHandle> handles;
+    for (int i = 0; i < 1000; ++i) {
+        handles.push_back(store.add(entityAt(coordinate(random), coordinate(random), 0, i % 2 + 1)));
+    }
+    tt::SpatialGrid grid(2000);
+    tt::InterestManager interest;
+    tt::InterestRegion air = tt::InterestRegion::sphere({0, 0, 0}, 10000);
+    air.entityTypes.push_back({0, 2});
+    const std::vector<tt::InterestRegion> regions = {tt::InterestRegion::sphere({5000, 0, 0}, 8000),
+                                                     tt::InterestRegion::cone({0, 0, 0}, {0, 1, 0}, 0.5, 15000), air};
+    for (const tt::InterestRegion& region : regions) {
+        interest.subscribe(region);
+    }
+    grid.synchronise(store);
+    interest.synchronise(store, grid);
+
+    for (int frame = 0; frame < 5; ++frame) {
+        // Entities move, change type, appear and disappear
+        for (int i = 0; i < 50; ++i) {
+            const size_t victim = random() % handles.size();
+            if (i % 3 == 0) {
+                ASSERT_TRUE(store.remove(handles[victim]));
+                handles[victim] = store.add(entityAt(coordinate(random), coordinate(random), 0, 2));
+            }
+            else {
+                ASSERT_TRUE(store.update(handles[victim],
+                                         entityAt(coordinate(random), coordinate(random), 0, random() % 2 + 1)));
+            }
+        }
+        ASSERT_TRUE(store.getChanges().covers(interest.getView(0)->getRevision()));
+        ASSERT_EQ(0, store.getChanges().getFieldsOfAll(interest.getView(0)->getRevision()));
+        grid.synchronise(store);
+        interest.synchronise(store, grid);
+
+        tt::InterestManager reference;
+        for (tt::InterestManager::SubscriptionId subscription = 0; subscription < regions.size(); ++subscription) {
+            reference.subscribe(regions[subscription]);
+        }
+        reference.synchronise(store, grid);
+        for (tt::InterestManager::SubscriptionId subscription = 0; subscription < regions.size(); ++subscription) {
+            ASSERT_EQ(reference.getView(subscription)->getIndices(), interest.getView(subscription)->getIndices());
+            ASSERT_EQ(reference.getView(subscription)->getHandles(), interest.getView(subscription)->getHandles());
+            ASSERT_EQ(store.getRevision(), interest.getView(subscription)->getRevision());
+        }
+    }
+}
+
+TEST(InterestManagement, SlowConsumersCatchUpFromChangeLog) {
+    std::mt19937 random(11);
+    std::uniform_real_distribution<double> coordinate(-20000, 20000);
+    tt::EntityStore store;
+    std::vector<tt::EntityHandle> handles;
+    for (int i = 0; i < 1000; ++i) {
+        handles.push_back(store.add(entityAt(coordinate(random), coordinate(random), 0, i % 2 + 1)));
+    }
+    tt::SpatialGrid grid(2000);
+    tt::SpatialGrid slowGrid(2000);
+    tt::InterestManager interest;
+    const tt::InterestRegion region = tt::InterestRegion::sphere({5000, 0, 0}, 8000);
+    const tt::InterestManager::SubscriptionId subscription = interest.subscribe(region);
+    grid.synchronise(store);
+    slowGrid.synchronise(store);
+    interest.synchronise(store, grid);
+
+    // The producer changes the store every frame, the grid follows every frame while the interest management and
+    // the slow grid only catch up every tenth frame, from the revision they last saw
+    for (int frame = 1; frame <= 30; ++frame) {
+        for (int i = 0; i < 50; ++i) {
+            const size_t victim = random() % handles.size();
+            if (i % 3 == 0) {
+                ASSERT_TRUE(store.remove(handles[victim]));
+                handles[victim] = store.add(entityAt(coordinate(random), coordinate(random), 0, 2));
+            }
+            else {
+                ASSERT_TRUE(store.update(handles[victim],
+                                         entityAt(coordinate(random), coordinate(random), 0, random() % 2 + 1)));
+            }
+        }
+        grid.synchronise(store);
+        if (frame % 10 != 0) {
+            continue;
+        }
+
+        ASSERT_TRUE(store.getChanges().covers(slowGrid.getSynchronisedRevision()));
+        ASSERT_TRUE(store.getChanges().covers(interest.getView(subscription)->getRevision()));
+        slowGrid.synchronise(store);
+        interest.synchronise(store, grid);
+
+        tt::SpatialGrid referenceGrid(2000);
+        referenceGrid.synchronise(tt::EntityStore(store));
+        ASSERT_EQ(referenceGrid.size(), slowGrid.size());
+        for (const tt::EntityHandle handle : handles) {
+            const size_t i = store.indexOf(handle);
+            const auto positions = std::as_const(store).getPositions();
+            std::vector<tt::EntityHandle> found;
+            slowGrid.querySphere({positions.x[i], positions.y[i], positions.z[i]}, 1, found);
+            ASSERT_NE(found.end(), std::find(found.begin(), found.end(), handle));
+        }
+
+        tt::InterestManager reference;
+        reference.subscribe(region);
+        reference.synchronise(store, grid);
+        ASSERT_EQ(reference.getView(0)->getIndices(), interest.getView(subscription)->getIndices());
+        ASSERT_EQ(reference.getView(0)->getHandles(), interest.getView(subscription)->getHandles());
+    }
+}
@@ -0,0 +1,242 @@
+#include "TT/logging.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    using namespace tt::log;
+
+    constexpr std::string_view levelNames[] = {"TRACE: ", "DEBUG: ", "INFO: ", "WARNING: ", "ERROR: "};
+
+    /// records per thread, at ~256 bytes each
+    constexpr size_t ringCapacity = 1024;
+
+    /// how often the writer checks for new messages when nobody waits for a flush
+    constexpr std::chrono::milliseconds drainInterval(5);
+
+    struct Record {
+        Level level;
+
+        uint16_t length;
+
+        char text[maximumMessageLength];
+    };
+
+    /// Single producer, single consumer ring of records. The producer is the owning thread, the consumer the writer.
+    struct Ring {
+        alignas(64) std::atomic<uint64_t> head{0};
+
+        alignas(64) std::atomic<uint64_t> tail{0};
+
+        /// set when the owning thread exits, the writer then frees the ring once it is drained
+        std::atomic<bool> orphaned{false};
+
+        std::array<Record, ringCapacity> records;
+    };
+
+    class Backend {
+    public:
+        Backend() :
+            output_(stdout),
+            stopping_(false),
+            written_(0),
+            drainPasses_(0),
+            writer_(&Backend::writerMain, this) {
+        }
+
+        ~Backend() {
+            {
+                std::lock_guard lock(mutex_);
+                stopping_ = true;
+            }
+            wakeUp_.notify_all();
+            writer_.join();
+        }
+
+        std::shared_ptr<Ring> createRing() {
+            auto ring = std::make_shared<Ring>();
+            std::lock_guard lock(mutex_);
+            rings_.push_back(ring);
+            return ring;
+        }
+
+        void setOutput(std::FILE* output) {
+            std::lock_guard lock(mutex_);
+            output_ = output;
+        }
+
+        void flush(const uint64_t target) {
+            std::unique_lock lock(mutex_);
+            // The writer drains with the mutex held, so the next pass starts after this call and also sees the rings
+            // orphaned before it
+            const uint64_t pass = drainPasses_;
+            while ((written_ < target || drainPasses_ == pass) && !stopping_) {
+                wakeUp_.notify_all();
+                flushed_.wait_for(lock, drainInterval);
+            }
+        }
+
+        size_t getRingCount() {
+            std::lock_guard lock(mutex_);
+            return rings_.size();
+        }
+
+        std::atomic<uint64_t> logged{0};
+
+        std::atomic<uint64_t> dropped{0};
+
+    private:
+        void writerMain() {
+            std::string buffer;
+            buffer.reserve(ringCapacity * sizeof(Record));
+
+            std::unique_lock lock(mutex_);
+            while (true) {
+                const uint64_t target = logged.load(std::memory_order_acquire);
+                drain(buffer);
+                written_ = std::max(written_, target);
+                ++drainPasses_;
+                flushed_.notify_all();
+                if (stopping_) {
+                    return;
+                }
+                wakeUp_.wait_for(lock, drainInterval);
+            }
+        }
+
+        /// Writes all queued records and frees the rings of exited threads, called with mutex_ held
+        void drain(std::string& buffer) {
+            bool anyOrphaned = false;
+            for (const auto& ring : rings_) {
+                // Loaded before head, so every record of an exited thread is written before its ring is freed
+                const bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+                anyOrphaned = anyOrphaned || orphaned;
+                const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+                const uint64_t head = ring->head.load(std::memory_order_acquire);
+                for (uint64_t i = tail; i < head; ++i) {
+                    const Record& record = ring->records[i % ringCapacity];
+                    buffer += levelNames[record.level];
+                    buffer.append(record.text, record.length);
+                    buffer += '\n';
+                }
+                ring->tail.store(head, std::memory_order_release);
+            }
+            if (anyOrphaned) {
+                rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const std::shared_ptr<Ring>& ring) {
+                    return ring->orphaned.load(std::memory_order_relaxed) &&
+                        ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire);
+                }), rings_.end());
+            }
+            if (!buffer.empty()) {
+                std::fwrite(buffer.data(), 1, buffer.size(), output_);
+                std::fflush(output_);
+                buffer.clear();
+            }
+        }
+
+        std::FILE* output_;
+
+        std::mutex mutex_;
+
+        std::condition_variable wakeUp_;
+
+        std::condition_variable flushed_;
+
+        std::vector<std::shared_ptr<Ring>> rings_;
+
+        bool stopping_;
+
+        /// number of log calls known to be written
+        uint64_t written_;
+
+        /// number of completed calls to drain()
+        uint64_t drainPasses_;
+
+        std::thread writer_;
+    };
+
+    Backend& backend() {
+        static Backend instance;
+        return instance;
+    }
+
+    std::atomic<Level> runtimeLevel(Info);
+
+    /// Owns the ring of a thread and hands it over to the writer when the thread exits
+    class RingOwner {
+    public:
+        RingOwner() :
+            ring(backend().createRing()) {
+        }
+
+        ~RingOwner() {
+            ring->orphaned.store(true, std::memory_order_release);
+        }
+
+        // Shared with the backend, so messages of a thread which has already exited are still written
+        const std::shared_ptr<Ring> ring;
+    };
+
+    Ring& threadRing() {
+        thread_local const RingOwner owner;
+        return *owner.ring;
+    }
+}
+
+bool tt::log::detail::isEnabled(const Level level) {
+    return level >= runtimeLevel.load(std::memory_order_relaxed);
+}
+
+void tt::log::detail::write(const Level level, const std::string_view* parts, const size_t partCount) {
+    Backend& logBackend = backend();
+    Ring& ring = threadRing();
+
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= ringCapacity) {
+        logBackend.dropped.fetch_add(1, std::memory_order_relaxed);
+        logBackend.logged.fetch_add(1, std::memory_order_release);
+        return;
+    }
+
+    Record& record = ring.records[head % ringCapacity];
+    record.level = level;
+    size_t length = 0;
+    for (size_t i = 0; i < partCount && length < maximumMessageLength; ++i) {
+        const size_t count = std::min(parts[i].size(), maximumMessageLength - length);
+        std::memcpy(record.text + length, parts[i].data(), count);
+        length += count;
+    }
+    record.length = static_cast<uint16_t>(length);
+    ring.head.store(head + 1, std::memory_order_release);
+    // Counted after publishing, so a flush which sees this call also sees its record
+    logBackend.logged.fetch_add(1, std::memory_order_release);
+}
+
+void tt::log::setLevel(const Level level) {
+    runtimeLevel.store(level, std::memory_order_relaxed);
+}
+
+void tt::log::setOutput(std::FILE* output) {
+    backend().setOutput(output);
+}
+
+void tt::log::flush() {
+    Backend& logBackend = backend();
+    logBackend.flush(logBackend.logged.load(std::memory_order_acquire));
+}
+
+uint64_t tt::log::getDroppedCount() {
+    return backend().dropped.load(std::memory_order_relaxed);
+}
+
+size_t tt::log::getBufferCount() {
+    return backend().getRingCount();
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+#include "TT/logging.h"
+
+namespace {
+    /// Captures everything logged during its lifetime
+    class CapturedLog {
+    public:
+        CapturedLog() :
+            file_(std::tmpfile()) {
+            tt::log::flush();
+            tt::log::setOutput(file_);
+        }
+
+        ~CapturedLog() {
+            tt::log::flush();
+            tt::log::setOutput(stdout);
+            std::fclose(file_);
+        }
+
+        std::string contents() {
+            tt::log::flush();
+            std::string text;
+            std::rewind(file_);
+            char buffer[256];
+            size_t count;
+            while ((count = std::fread(buffer, 1, sizeof(buffer), file_)) > 0) {
+                text.append(buffer, count);
+            }
+            return text;
+        }
+
+    private:
+        std::FILE* file_;
+    };
+}
+
+TEST(Logging, WritesConcatenatedParts) {
+    CapturedLog log;
+    const std::string name = "Radar";
+    tt::log::info("Read Handle: ", name, " << ", std::string_view("Environment.PhysicalEntities"));
+    tt::log::warning("late");
+    ASSERT_EQ("INFO: Read Handle: Radar << Environment.PhysicalEntities\nWARNING: late\n", log.contents());
+}
+
+TEST(Logging, FiltersLevels) {
+    CapturedLog log;
+    tt::log::debug("removed at compile time");
+    tt::log::setLevel(tt::log::Error);
+    tt::log::warning("removed at run time");
+    tt::log::error("kept");
+    tt::log::setLevel(tt::log::Info);
+    ASSERT_EQ("ERROR: kept\n", log.contents());
+}
+
+TEST(Logging, WritesMessagesFromExitedThreads) {
+    CapturedLog log;
+    std::thread([] { tt::log::info("from worker"); }).join();
+    ASSERT_EQ("INFO: from worker\n", log.contents());
+}
+
+TEST(Logging, FreesBuffersOfExitedThreads) {
+    CapturedLog log;
+    tt::log::info("main");
+    const size_t bufferCount = tt::log::getBufferCount();
+    for (int i = 0; i < 20; ++i) {
+        std::thread([] { tt::log::info("worker"); }).join();
+    }
+    tt::log::flush();
+    ASSERT_EQ(bufferCount, tt::log::getBufferCount());
+
+    const std::string text = log.contents();
+    size_t messages = 0;
+    for (size_t i = text.find("worker"); i != std::string::npos; i = text.find("worker", i + 1)) {
+        ++messages;
+    }
+    ASSERT_EQ(20, messages);
+}
+
+TEST(Logging, TruncatesLongMessages) {
+    CapturedLog log;
+    const std::string longMessage(tt::log::maximumMessageLength + 10, 'x');
+    tt::log::info(longMessage);
+    ASSERT_EQ("INFO: " + std::string(tt::log::maximumMessageLength, 'x') + "\n", log.contents());
+}
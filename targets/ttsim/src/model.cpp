@@ -6,7 +6,8 @@ namespace tt {
     Model::Model(const std::string_view& name, uint32_t targetFrameInterval) :
         name(name),
         targetFrameInterval(
-            (targetFrameInterval)) {
+            (targetFrameInterval)),
+        deltaTime_(0) {
     }
 
     bool Model::load() {
@@ -33,6 +34,14 @@ namespace tt {
         return true;
     }
 
+    bool Model::saveState(std::vector<uint8_t>&) const {
+        return true;
+    }
+
+    bool Model::restoreState(ByteReader&) {
+        return true;
+    }
+
     const std::string_view& Model::getName() const {
         return name;
     }
@@ -41,6 +50,43 @@ namespace tt {
         return targetFrameInterval;
     }
 
+    double Model::getDeltaTime() const {
+        return deltaTime_;
+    }
+
+    void Model::setDeltaTime(const double deltaTime) {
+        deltaTime_ = deltaTime;
+    }
+
+    void Model::addRead(const BusDataBase& busData) {
+        reads_.push_back(&busData);
+    }
+
+    void Model::addWrite(const BusDataBase& busData) {
+        writes_.push_back(&busData);
+    }
+
+    const std::vector<const BusDataBase*>& Model::getReads() const {
+        return reads_;
+    }
+
+    const std::vector<const BusDataBase*>& Model::getWrites() const {
+        return writes_;
+    }
+
+    BusDataBase::BusDataBase(const std::string_view name, const Buffering buffering) :
+        name_(name),
+        buffering_(buffering) {
+    }
+
+    const std::string_view& BusDataBase::getName() const {
+        return name_;
+    }
+
+    BusDataBase::Buffering BusDataBase::getBuffering() const {
+        return buffering_;
+    }
+
     DataChannel::DataChannel(const std::string_view& name) :
         name_(name) {
     }
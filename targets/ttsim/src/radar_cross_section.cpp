@@ -0,0 +1,169 @@
+#include "TT/radar_cross_section.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "TT/logging.h"
+#include "TT/serialisation.h"
+
+tt::RadarCrossSectionTable::RadarCrossSectionTable(const uint16_t azimuthCount, const uint16_t elevationCount,
+                                                   const float* values) :
+    azimuthCount_(azimuthCount),
+    elevationCount_(elevationCount),
+    azimuthScale_(azimuthCount / (2 * M_PI)),
+    elevationScale_((elevationCount - 1) / M_PI),
+    maximum_(0),
+    values_(static_cast<size_t>(azimuthCount + 1) * elevationCount) {
+    for (int32_t row = 0; row < elevationCount_; ++row) {
+        float* destination = values_.data() + row * (azimuthCount_ + 1);
+        std::memcpy(destination, values + row * azimuthCount_, azimuthCount_ * sizeof(float));
+        destination[azimuthCount_] = destination[0];
+        maximum_ = std::max(maximum_, *std::max_element(destination, destination + azimuthCount_));
+    }
+}
+
+uint16_t tt::RadarCrossSectionTable::getAzimuthCount() const {
+    return static_cast<uint16_t>(azimuthCount_);
+}
+
+uint16_t tt::RadarCrossSectionTable::getElevationCount() const {
+    return static_cast<uint16_t>(elevationCount_);
+}
+
+float tt::RadarCrossSectionTable::getMaximum() const {
+    return maximum_;
+}
+
+float tt::RadarCrossSectionTable::getSample(const uint16_t azimuth, const uint16_t elevation) const {
+    return values_[elevation * (azimuthCount_ + 1) + azimuth];
+}
+
+bool tt::RadarCrossSectionLibrary::add(const int16_t signatureIndex, const uint16_t azimuthCount,
+                                       const uint16_t elevationCount, const std::vector<float>& values) {
+    if (signatureIndex < 0 || azimuthCount < 1 || elevationCount < 2 ||
+        values.size() != static_cast<size_t>(azimuthCount) * elevationCount) {
+        log::error("RadarCrossSectionLibrary: invalid table for signature ", std::to_string(signatureIndex));
+        return false;
+    }
+    for (const float value : values) {
+        if (!(value >= 0 && std::isfinite(value))) {
+            log::error("RadarCrossSectionLibrary: invalid sample for signature ", std::to_string(signatureIndex));
+            return false;
+        }
+    }
+
+    if (static_cast<size_t>(signatureIndex) >= tableOfSignature_.size()) {
+        tableOfSignature_.resize(signatureIndex + 1, -1);
+    }
+    RadarCrossSectionTable table(azimuthCount, elevationCount, values.data());
+    if (tableOfSignature_[signatureIndex] >= 0) {
+        tables_[tableOfSignature_[signatureIndex]] = std::move(table);
+    }
+    else {
+        tableOfSignature_[signatureIndex] = static_cast<int32_t>(tables_.size());
+        tables_.push_back(std::move(table));
+        signatures_.push_back(signatureIndex);
+    }
+
+    maximum_ = 0;
+    for (const auto& existing : tables_) {
+        maximum_ = std::max(maximum_, existing.getMaximum());
+    }
+    return true;
+}
+
+float tt::RadarCrossSectionLibrary::getMaximum() const {
+    return maximum_;
+}
+
+size_t tt::RadarCrossSectionLibrary::size() const {
+    return tables_.size();
+}
+
+bool tt::RadarCrossSectionLibrary::empty() const {
+    return tables_.empty();
+}
+
+bool tt::RadarCrossSectionLibrary::load(const std::string& path) {
+    tables_.clear();
+    signatures_.clear();
+    tableOfSignature_.clear();
+    maximum_ = 0;
+
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        log::error("RadarCrossSectionLibrary: cannot open ", path);
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t count;
+    while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + count);
+    }
+    std::fclose(file);
+
+    ByteReader reader(data.data(), data.size());
+    char magic[4];
+    uint32_t version;
+    uint32_t tableCount;
+    if (!reader.read(magic, sizeof(magic)) || std::memcmp(magic, "TTRS", 4) != 0 ||
+        !reader.read(version) || version != fileVersion || !reader.read(tableCount)) {
+        log::error("RadarCrossSectionLibrary: ", path, " is not a signature library of version ",
+                   std::to_string(fileVersion));
+        return false;
+    }
+
+    std::vector<float> values;
+    for (uint32_t i = 0; i < tableCount; ++i) {
+        int16_t signatureIndex;
+        uint16_t azimuthCount;
+        uint16_t elevationCount;
+        if (!reader.read(signatureIndex) || !reader.read(azimuthCount) || !reader.read(elevationCount)) {
+            values.clear();
+        }
+        else {
+            values.resize(static_cast<size_t>(azimuthCount) * elevationCount);
+        }
+        if (values.empty() || !reader.read(values.data(), values.size() * sizeof(float)) ||
+            !add(signatureIndex, azimuthCount, elevationCount, values)) {
+            log::error("RadarCrossSectionLibrary: ", path, " holds an invalid or truncated table");
+            tables_.clear();
+            signatures_.clear();
+            tableOfSignature_.clear();
+            maximum_ = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool tt::RadarCrossSectionLibrary::save(const std::string& path) const {
+    std::vector<uint8_t> data;
+    appendBytes(data, "TTRS", 4);
+    appendBytes(data, fileVersion);
+    appendBytes(data, static_cast<uint32_t>(tables_.size()));
+    for (size_t i = 0; i < tables_.size(); ++i) {
+        const RadarCrossSectionTable& table = tables_[i];
+        appendBytes(data, signatures_[i]);
+        appendBytes(data, table.getAzimuthCount());
+        appendBytes(data, table.getElevationCount());
+        for (uint16_t elevation = 0; elevation < table.getElevationCount(); ++elevation) {
+            for (uint16_t azimuth = 0; azimuth < table.getAzimuthCount(); ++azimuth) {
+                appendBytes(data, table.getSample(azimuth, elevation));
+            }
+        }
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        log::error("RadarCrossSectionLibrary: cannot create ", path);
+        return false;
+    }
+    const bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    if (std::fclose(file) != 0 || !written) {
+        log::error("RadarCrossSectionLibrary: cannot write ", path);
+        return false;
+    }
+    return true;
+}
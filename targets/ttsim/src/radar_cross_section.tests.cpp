@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "TT/radar_cross_section.h"
+#include "TT/transform.h"
+
+namespace {
+    /// 8 azimuths every 45 degrees by 3 elevations (-90, 0 and 90 degrees), the sample at azimuth a and elevation e
+    /// being 10 * e + a
+    std::vector<float> getRampSamples() {
+        std::vector<float> values;
+        for (int elevation = 0; elevation < 3; ++elevation) {
+            for (int azimuth = 0; azimuth < 8; ++azimuth) {
+                values.push_back(static_cast<float>(10 * elevation + azimuth));
+            }
+        }
+        return values;
+    }
+}
+
+TEST(RadarCrossSection, InterpolatesSamples) {
+    tt::RadarCrossSectionLibrary library;
+    ASSERT_TRUE(library.add(3, 8, 3, getRampSamples()));
+    const tt::RadarCrossSectionTable* table = library.find(3);
+    ASSERT_NE(nullptr, table);
+    ASSERT_EQ(27, table->getMaximum());
+
+    // On the samples
+    ASSERT_FLOAT_EQ(0, table->lookup(-M_PI, -M_PI_2));
+    ASSERT_FLOAT_EQ(14, table->lookup(0, 0));
+    ASSERT_FLOAT_EQ(26, table->lookup(M_PI_2, M_PI_2));
+
+    // Between the samples
+    ASSERT_FLOAT_EQ(14.5, table->lookup(M_PI_4 / 2, 0));
+    ASSERT_FLOAT_EQ(19, table->lookup(0, M_PI_4));
+    ASSERT_FLOAT_EQ(19.5, table->lookup(M_PI_4 / 2, M_PI_4));
+
+    // Azimuth wraps from the last sample back to the first, elevation is clamped
+    ASSERT_FLOAT_EQ(13.5, table->lookup(M_PI - M_PI_4 / 2, 0));
+    ASSERT_FLOAT_EQ(10, table->lookup(M_PI, 0));
+    ASSERT_FLOAT_EQ(24, table->lookup(0, 2));
+}
+
+TEST(RadarCrossSection, LooksUpAspectOfOrientedPlatform) {
+    std::vector<float> values(36 * 19);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(i % 7 + i % 36);
+    }
+    tt::RadarCrossSectionLibrary library;
+    ASSERT_TRUE(library.add(0, 36, 19, values));
+    const tt::RadarCrossSectionTable& table = *library.find(0);
+
+    // The aspect matches the line of sight in the body frame of a Transform of the same orientation
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> angle(-3, 3);
+    std::uniform_real_distribution<double> coordinate(-1000, 1000);
+    for (int i = 0; i < 1000; ++i) {
+        const float psi = angle(random);
+        const float theta = angle(random) / 2;
+        const float phi = angle(random);
+        const tt::Transform platform(0, 0, 0, phi, theta, psi);
+        const Eigen::Vector3d lineOfSight(coordinate(random), coordinate(random), coordinate(random));
+        const Eigen::Vector3d body = platform.toLocalVector(lineOfSight);
+        const float expected = table.lookup(std::atan2(body.y(), body.x()),
+                                            std::atan2(-body.z(), std::hypot(body.x(), body.y())));
+        ASSERT_NEAR(expected, table.lookup(psi, theta, phi, lineOfSight.x(), lineOfSight.y(), lineOfSight.z()),
+                    1e-3);
+    }
+
+    // Seen from straight ahead, level
+    ASSERT_FLOAT_EQ(table.lookup(0, 0), table.lookup(0.0f, 0.0f, 0.0f, 1, 0, 0));
+    ASSERT_FLOAT_EQ(table.lookup(M_PI_2, 0), table.lookup(0.0f, 0.0f, 0.0f, 0, 1, 0));
+    ASSERT_FLOAT_EQ(table.lookup(0, M_PI_2), table.lookup(0.0f, 0.0f, 0.0f, 0, 0, -1));
+}
+
+TEST(RadarCrossSection, FindsSignatures) {
+    tt::RadarCrossSectionLibrary library;
+    ASSERT_TRUE(library.empty());
+    ASSERT_EQ(0, library.getMaximum());
+    ASSERT_EQ(nullptr, library.find(-1));
+    ASSERT_EQ(nullptr, library.find(0));
+
+    ASSERT_TRUE(library.add(5, 1, 2, {1, 2}));
+    ASSERT_TRUE(library.add(2, 2, 2, {3, 4, 5, 6}));
+    ASSERT_EQ(2, library.size());
+    ASSERT_EQ(6, library.getMaximum());
+    ASSERT_EQ(nullptr, library.find(-1));
+    ASSERT_EQ(nullptr, library.find(3));
+    ASSERT_EQ(nullptr, library.find(6));
+    ASSERT_EQ(1, library.find(5)->getAzimuthCount());
+    ASSERT_EQ(2, library.find(2)->getAzimuthCount());
+
+    // Replacing a table updates the maximum
+    ASSERT_TRUE(library.add(2, 1, 2, {1, 1}));
+    ASSERT_EQ(2, library.size());
+    ASSERT_EQ(2, library.getMaximum());
+
+    ASSERT_FALSE(library.add(-1, 1, 2, {1, 2}));
+    ASSERT_FALSE(library.add(7, 1, 1, {1}));
+    ASSERT_FALSE(library.add(7, 2, 2, {1, 2, 3}));
+    ASSERT_FALSE(library.add(7, 1, 2, {1, -2}));
+    ASSERT_EQ(2, library.size());
+}
+
+TEST(RadarCrossSection, LoadsSavedLibrary) {
+    const std::string path = testing::TempDir() + "LoadsSavedLibrary.ttrcs";
+    tt::RadarCrossSectionLibrary saved;
+    ASSERT_TRUE(saved.add(3, 8, 3, getRampSamples()));
+    ASSERT_TRUE(saved.add(1, 1, 2, {0.5f, 2}));
+    ASSERT_TRUE(saved.save(path));
+
+    tt::RadarCrossSectionLibrary loaded;
+    ASSERT_TRUE(loaded.load(path));
+    ASSERT_EQ(2, loaded.size());
+    ASSERT_EQ(27, loaded.getMaximum());
+    const tt::RadarCrossSectionTable* table = loaded.find(3);
+    ASSERT_NE(nullptr, table);
+    ASSERT_EQ(8, table->getAzimuthCount());
+    ASSERT_EQ(3, table->getElevationCount());
+    for (uint16_t elevation = 0; elevation < 3; ++elevation) {
+        for (uint16_t azimuth = 0; azimuth < 8; ++azimuth) {
+            ASSERT_EQ(10 * elevation + azimuth, table->getSample(azimuth, elevation));
+        }
+    }
+    ASSERT_EQ(0.5f, loaded.find(1)->getSample(0, 0));
+
+    // A truncated file leaves the library empty
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+    ASSERT_NE(nullptr, file);
+    std::fseek(file, 0, SEEK_END);
+    const long size = std::ftell(file);
+    std::fclose(file);
+    ASSERT_EQ(0, truncate(path.c_str(), size - 2));
+    ASSERT_FALSE(loaded.load(path));
+    ASSERT_TRUE(loaded.empty());
+    ASSERT_EQ(nullptr, loaded.find(3));
+    std::remove(path.c_str());
+
+    ASSERT_FALSE(loaded.load(path));
+}
@@ -0,0 +1,153 @@
+#include "TT/recorder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "TT/logging.h"
+
+namespace {
+    /// size of the chunk header: magic, payload size and frame count
+    constexpr size_t chunkHeaderSize = 12;
+}
+
+tt::Recorder::Recorder(const size_t chunkSize) :
+    chunkSize_(chunkSize),
+    file_(-1),
+    chunkFrameCount_(0),
+    frameCount_(0) {
+}
+
+tt::Recorder::~Recorder() {
+    if (isOpen()) {
+        close();
+    }
+}
+
+bool tt::Recorder::addBusData(const BusDataBase& busData) {
+    std::vector<uint8_t> probe;
+    if (!busData.serialise(probe)) {
+        log::error("Recorder: bus data ", busData.getName(), " cannot be serialised");
+        return false;
+    }
+    return addStream(busData.getName(), [&busData](std::vector<uint8_t>& buffer) {
+        busData.serialise(buffer);
+    });
+}
+
+bool tt::Recorder::addStream(const std::string_view name, Source source) {
+    if (isOpen()) {
+        log::error("Recorder: stream ", name, " added after the file was opened");
+        return false;
+    }
+    if (std::any_of(streams_.begin(), streams_.end(), [name](const Stream& stream) { return stream.name == name; })) {
+        log::error("Recorder: stream ", name, " added twice");
+        return false;
+    }
+    streams_.push_back({std::string(name), std::move(source)});
+    return true;
+}
+
+bool tt::Recorder::open(const std::string& path) {
+    if (isOpen()) {
+        return false;
+    }
+    file_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (file_ < 0) {
+        log::error("Recorder: cannot open ", path, ": ", std::strerror(errno));
+        return false;
+    }
+
+    std::vector<uint8_t> header;
+    appendBytes(header, "TTRC", 4);
+    appendBytes(header, fileVersion);
+    appendBytes(header, static_cast<uint32_t>(streams_.size()));
+    for (const auto& stream : streams_) {
+        appendBytes(header, static_cast<uint16_t>(stream.name.size()));
+        appendBytes(header, stream.name.data(), stream.name.size());
+    }
+    if (!writeAll(header)) {
+        ::close(file_);
+        file_ = -1;
+        return false;
+    }
+
+    chunk_.reserve(chunkSize_ + chunkHeaderSize);
+    chunk_.assign(chunkHeaderSize, 0);
+    chunkFrameCount_ = 0;
+    frameCount_ = 0;
+    return true;
+}
+
+bool tt::Recorder::recordFrame(const std::chrono::nanoseconds simulationTime) {
+    if (!isOpen()) {
+        return false;
+    }
+
+    appendBytes(chunk_, static_cast<int64_t>(simulationTime.count()));
+    for (const auto& stream : streams_) {
+        // The size is only known once the value has been appended
+        const size_t sizeOffset = chunk_.size();
+        chunk_.resize(sizeOffset + sizeof(uint32_t));
+        stream.source(chunk_);
+        const auto size = static_cast<uint32_t>(chunk_.size() - sizeOffset - sizeof(uint32_t));
+        std::memcpy(chunk_.data() + sizeOffset, &size, sizeof(size));
+    }
+    ++chunkFrameCount_;
+    ++frameCount_;
+
+    return chunk_.size() < chunkSize_ + chunkHeaderSize || writeChunk();
+}
+
+bool tt::Recorder::close() {
+    if (!isOpen()) {
+        return false;
+    }
+    const bool written = writeChunk();
+    const bool closed = ::close(file_) == 0;
+    file_ = -1;
+    return written && closed;
+}
+
+bool tt::Recorder::isOpen() const {
+    return file_ >= 0;
+}
+
+uint64_t tt::Recorder::getFrameCount() const {
+    return frameCount_;
+}
+
+bool tt::Recorder::writeChunk() {
+    if (chunkFrameCount_ == 0) {
+        return true;
+    }
+
+    const auto payloadSize = static_cast<uint32_t>(chunk_.size() - chunkHeaderSize);
+    std::memcpy(chunk_.data(), "TTCK", 4);
+    std::memcpy(chunk_.data() + 4, &payloadSize, sizeof(payloadSize));
+    std::memcpy(chunk_.data() + 8, &chunkFrameCount_, sizeof(chunkFrameCount_));
+    const bool written = writeAll(chunk_);
+
+    chunk_.resize(chunkHeaderSize);
+    chunkFrameCount_ = 0;
+    return written;
+}
+
+bool tt::Recorder::writeAll(const std::vector<uint8_t>& buffer) {
+    size_t offset = 0;
+    while (offset < buffer.size()) {
+        const ssize_t written = ::write(file_, buffer.data() + offset, buffer.size() - offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            log::error("Recorder: write failed: ", std::strerror(errno));
+            return false;
+        }
+        offset += static_cast<size_t>(written);
+    }
+    return true;
+}
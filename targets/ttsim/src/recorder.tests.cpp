@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <Eigen/Core>
+#include <unistd.h>
+
+#include "TT/recorder.h"
+#include "TT/replayer.h"
+#include "TT/simulation.h"
+
+namespace {
+    std::string getRecordingPath(const std::string& name) {
+        return testing::TempDir() + name + ".ttrec";
+    }
+
+    /// Records a counter and a vector derived from it over the supplied number of frames
+    void recordFrames(const std::string& path, const int frameCount, const size_t chunkSize) {
+        tt::BusData<double> counter(0, "Counter", tt::BusDataBase::DoubleBuffered);
+        tt::BusData<Eigen::Vector3d> position(Eigen::Vector3d::Zero(), "Position");
+        tt::Recorder recorder(chunkSize);
+        ASSERT_TRUE(recorder.addBusData(counter));
+        ASSERT_TRUE(recorder.addBusData(position));
+        ASSERT_TRUE(recorder.open(path));
+
+        const auto writeCounter = counter.getWriteHandle();
+        const auto writePosition = position.getWriteHandle();
+        for (int frame = 0; frame < frameCount; ++frame) {
+            *writeCounter = frame;
+            *writePosition = Eigen::Vector3d(frame, 2 * frame, 3 * frame);
+            counter.publish();
+            ASSERT_TRUE(recorder.recordFrame(std::chrono::milliseconds(10 * frame)));
+        }
+        ASSERT_EQ(frameCount, recorder.getFrameCount());
+        ASSERT_TRUE(recorder.close());
+    }
+}
+
+TEST(Recorder, ReplaysRecordedFrames) {
+    const std::string path = getRecordingPath("ReplaysRecordedFrames");
+    recordFrames(path, 100, 256); // several chunks
+
+    tt::Replayer replayer;
+    ASSERT_TRUE(replayer.open(path));
+    ASSERT_EQ(100, replayer.getFrameCount());
+    ASSERT_EQ(2, replayer.getStreamCount());
+    ASSERT_EQ("Counter", replayer.getStreamName(0));
+    size_t positionStream;
+    ASSERT_TRUE(replayer.findStream("Position", positionStream));
+    ASSERT_EQ(1, positionStream);
+    ASSERT_FALSE(replayer.findStream("Velocity", positionStream));
+
+    tt::BusData<double> counter(-1, "Counter", tt::BusDataBase::DoubleBuffered);
+    tt::BusData<Eigen::Vector3d> position(Eigen::Vector3d::Zero(), "Position");
+    const auto readCounter = counter.getReadHandle();
+    const auto readPosition = position.getReadHandle();
+    for (const size_t frame : {0, 42, 99, 7}) {
+        ASSERT_EQ(std::chrono::milliseconds(10 * frame), replayer.getFrameTime(frame));
+        ASSERT_TRUE(replayer.apply(frame, 0, counter));
+        ASSERT_TRUE(replayer.apply(frame, 1, position));
+        counter.publish();
+        ASSERT_EQ(frame, *readCounter);
+        ASSERT_EQ(Eigen::Vector3d(frame, 2 * frame, 3 * frame), *readPosition);
+    }
+
+    // A value of another type does not fit
+    ASSERT_FALSE(replayer.apply(0, 1, counter));
+    replayer.close();
+    std::remove(path.c_str());
+}
+
+TEST(Recorder, IgnoresIncompleteChunk) {
+    const std::string path = getRecordingPath("IgnoresIncompleteChunk");
+    recordFrames(path, 10, 0); // a chunk per frame
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    ASSERT_NE(nullptr, file);
+    std::fseek(file, 0, SEEK_END);
+    const long size = std::ftell(file);
+    std::fclose(file);
+    ASSERT_EQ(0, truncate(path.c_str(), size - 5));
+
+    tt::Replayer replayer;
+    ASSERT_TRUE(replayer.open(path));
+    ASSERT_EQ(9, replayer.getFrameCount());
+    replayer.close();
+    std::remove(path.c_str());
+}
+
+TEST(Recorder, RejectsInvalidStreams) {
+    struct Unserialisable {
+        std::vector<int> values;
+    };
+    tt::BusData<Unserialisable> unserialisable({}, "Unserialisable");
+    tt::BusData<double> value(0, "Value");
+
+    tt::Recorder recorder;
+    ASSERT_FALSE(recorder.addBusData(unserialisable));
+    ASSERT_TRUE(recorder.addBusData(value));
+    ASSERT_FALSE(recorder.addBusData(value));
+    ASSERT_FALSE(recorder.recordFrame(std::chrono::nanoseconds(0)));
+
+    const std::string path = getRecordingPath("RejectsInvalidStreams");
+    ASSERT_TRUE(recorder.open(path));
+    ASSERT_FALSE(recorder.addStream("Late", [](std::vector<uint8_t>&) {}));
+    ASSERT_TRUE(recorder.close());
+    std::remove(path.c_str());
+}
+
+TEST(Recorder, RejectsForeignFile) {
+    const std::string path = getRecordingPath("RejectsForeignFile");
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(nullptr, file);
+    std::fputs("not a recording", file);
+    std::fclose(file);
+
+    tt::Replayer replayer;
+    ASSERT_FALSE(replayer.open(path));
+    ASSERT_FALSE(replayer.isOpen());
+    std::remove(path.c_str());
+}
+
+TEST(Recorder, RejectsTruncatedHeader) {
+    // A valid recording cut off within the name of its first stream
+    const std::string path = getRecordingPath("RejectsTruncatedHeader");
+    recordFrames(path, 1, 0);
+    ASSERT_EQ(0, truncate(path.c_str(), 16));
+
+    tt::Replayer replayer;
+    ASSERT_FALSE(replayer.open(path));
+    ASSERT_FALSE(replayer.isOpen());
+
+    // A corrupt stream count far beyond what the file can hold
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(nullptr, file);
+    const uint32_t version = tt::Recorder::fileVersion;
+    const uint32_t streamCount = UINT32_MAX;
+    std::fwrite("TTRC", 1, 4, file);
+    std::fwrite(&version, sizeof(version), 1, file);
+    std::fwrite(&streamCount, sizeof(streamCount), 1, file);
+    std::fwrite("\0\0\0\0", 1, 4, file);
+    std::fclose(file);
+    ASSERT_FALSE(replayer.open(path));
+    ASSERT_EQ(0, replayer.getStreamCount());
+    std::remove(path.c_str());
+}
+
+TEST(Recorder, ReplayModelFeedsSimulation) {
+    class CopyModel final : public tt::Model {
+    public:
+        explicit CopyModel(const tt::BusData<double>& input) :
+            Model("CopyModel", 0),
+            input_(input.getReadHandle(this)) {
+        }
+
+        bool run() override {
+            values.push_back(*input_);
+            return true;
+        }
+
+        std::vector<double> values;
+
+    private:
+        const tt::ReadHandle<double> input_;
+    };
+
+    const std::string path = getRecordingPath("ReplayModelFeedsSimulation");
+    recordFrames(path, 20, 4096);
+    tt::Replayer replayer;
+    ASSERT_TRUE(replayer.open(path));
+
+    tt::BusData<double> counter(-1, "Counter", tt::BusDataBase::DoubleBuffered);
+    tt::ReplayModel replay(replayer);
+    ASSERT_TRUE(replay.bind(counter));
+    CopyModel copy(counter);
+
+    tt::Simulation simulation;
+    simulation.setClockMode(tt::Simulation::FreeRunning);
+    simulation.addModel(replay);
+    simulation.addModel(copy);
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(250)));
+    ASSERT_TRUE(replay.isFinished());
+
+    // Double buffered values reach the reader one frame later, after the replay the last value is kept
+    ASSERT_EQ(25, copy.values.size());
+    ASSERT_EQ(-1, copy.values[0]);
+    for (size_t frame = 1; frame <= 20; ++frame) {
+        ASSERT_EQ(frame - 1, copy.values[frame]);
+    }
+    ASSERT_EQ(19, copy.values.back());
+    replayer.close();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,213 @@
+#include "TT/replayer.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "TT/logging.h"
+#include "TT/recorder.h"
+
+namespace {
+    constexpr size_t chunkHeaderSize = 12;
+}
+
+tt::Replayer::Replayer() :
+    data_(nullptr),
+    size_(0) {
+}
+
+tt::Replayer::~Replayer() {
+    close();
+}
+
+bool tt::Replayer::open(const std::string& path) {
+    close();
+
+    const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        log::error("Replayer: cannot open ", path);
+        return false;
+    }
+    struct stat status{};
+    if (fstat(file, &status) != 0 || status.st_size == 0) {
+        log::error("Replayer: ", path, " is empty");
+        ::close(file);
+        return false;
+    }
+    void* mapping = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (mapping == MAP_FAILED) {
+        log::error("Replayer: cannot map ", path);
+        return false;
+    }
+    madvise(mapping, static_cast<size_t>(status.st_size), MADV_SEQUENTIAL);
+    data_ = static_cast<const uint8_t*>(mapping);
+    size_ = static_cast<size_t>(status.st_size);
+
+    ByteReader header(data_, size_);
+    char magic[4];
+    uint32_t version;
+    uint32_t streamCount;
+    if (!header.read(magic, sizeof(magic)) || std::memcmp(magic, "TTRC", 4) != 0 ||
+        !header.read(version) || version != Recorder::fileVersion || !header.read(streamCount)) {
+        log::error("Replayer: ", path, " is not a recording of version ", std::to_string(Recorder::fileVersion));
+        close();
+        return false;
+    }
+
+    // The stream count is not trusted, every stream name takes at least its size field
+    bool valid = streamCount <= header.getRemaining() / sizeof(uint16_t);
+    for (uint32_t i = 0; valid && i < streamCount; ++i) {
+        uint16_t nameSize = 0;
+        std::string name;
+        valid = header.read(nameSize) && nameSize <= header.getRemaining();
+        if (valid) {
+            name.resize(nameSize);
+            valid = header.read(name.data(), nameSize);
+        }
+        streamNames_.push_back(std::move(name));
+    }
+    if (!valid) {
+        log::error("Replayer: ", path, " has a truncated header");
+        close();
+        return false;
+    }
+
+    // Index every frame of every complete chunk
+    size_t offset = size_ - header.getRemaining();
+    while (size_ - offset >= chunkHeaderSize) {
+        ByteReader chunkHeader(data_ + offset, chunkHeaderSize);
+        uint32_t payloadSize;
+        uint32_t frameCount;
+        chunkHeader.read(magic, sizeof(magic));
+        chunkHeader.read(payloadSize);
+        chunkHeader.read(frameCount);
+        if (std::memcmp(magic, "TTCK", 4) != 0 || payloadSize > size_ - offset - chunkHeaderSize) {
+            break;
+        }
+
+        const size_t payloadEnd = offset + chunkHeaderSize + payloadSize;
+        ByteReader payload(data_ + offset + chunkHeaderSize, payloadSize);
+        for (uint32_t frame = 0; valid && frame < frameCount; ++frame) {
+            int64_t time;
+            valid = payload.read(time);
+            for (size_t stream = 0; valid && stream < streamNames_.size(); ++stream) {
+                valueOffsets_.push_back(payloadEnd - payload.getRemaining());
+                uint32_t valueSize;
+                valid = payload.read(valueSize) && payload.skip(valueSize);
+            }
+            if (valid) {
+                frameTimes_.push_back(time);
+            }
+        }
+        if (!valid) {
+            valueOffsets_.resize(frameTimes_.size() * streamNames_.size());
+            break;
+        }
+        offset = payloadEnd;
+    }
+    if (offset != size_) {
+        log::warning("Replayer: ignoring ", std::to_string(size_ - offset), " bytes of an incomplete chunk in ", path);
+    }
+    return true;
+}
+
+void tt::Replayer::close() {
+    if (data_ != nullptr) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    streamNames_.clear();
+    frameTimes_.clear();
+    valueOffsets_.clear();
+}
+
+bool tt::Replayer::isOpen() const {
+    return data_ != nullptr;
+}
+
+size_t tt::Replayer::getFrameCount() const {
+    return frameTimes_.size();
+}
+
+std::chrono::nanoseconds tt::Replayer::getFrameTime(const size_t frame) const {
+    return std::chrono::nanoseconds(frameTimes_[frame]);
+}
+
+size_t tt::Replayer::getStreamCount() const {
+    return streamNames_.size();
+}
+
+const std::string& tt::Replayer::getStreamName(const size_t stream) const {
+    return streamNames_[stream];
+}
+
+bool tt::Replayer::findStream(const std::string_view name, size_t& stream) const {
+    for (size_t i = 0; i < streamNames_.size(); ++i) {
+        if (streamNames_[i] == name) {
+            stream = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::pair<const uint8_t*, size_t> tt::Replayer::getData(const size_t frame, const size_t stream) const {
+    const uint8_t* value = data_ + valueOffsets_[frame * streamNames_.size() + stream];
+    uint32_t size;
+    std::memcpy(&size, value, sizeof(size));
+    return {value + sizeof(size), size};
+}
+
+bool tt::Replayer::apply(const size_t frame, const size_t stream, BusDataBase& busData) const {
+    const auto [value, size] = getData(frame, stream);
+    return busData.deserialise(value, size);
+}
+
+tt::ReplayModel::ReplayModel(const Replayer& replayer, const uint32_t targetFrameInterval) :
+    Model("Replay", targetFrameInterval),
+    replayer_(replayer),
+    frame_(0) {
+}
+
+bool tt::ReplayModel::bind(BusDataBase& busData) {
+    size_t stream;
+    if (!replayer_.findStream(busData.getName(), stream)) {
+        log::error("Replay: the recording has no stream ", busData.getName());
+        return false;
+    }
+    addWrite(busData);
+    bindings_.emplace_back(&busData, stream);
+    return true;
+}
+
+bool tt::ReplayModel::init() {
+    frame_ = 0;
+    return true;
+}
+
+bool tt::ReplayModel::run() {
+    if (isFinished()) {
+        return true;
+    }
+    for (const auto& [busData, stream] : bindings_) {
+        if (!replayer_.apply(frame_, stream, *busData)) {
+            log::error("Replay: frame ", std::to_string(frame_), " does not fit ", busData->getName());
+            return false;
+        }
+    }
+    ++frame_;
+    return true;
+}
+
+size_t tt::ReplayModel::getFrame() const {
+    return frame_;
+}
+
+bool tt::ReplayModel::isFinished() const {
+    return frame_ >= replayer_.getFrameCount();
+}
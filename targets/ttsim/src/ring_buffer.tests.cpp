@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "TT/ring_buffer.h"
+
+TEST(RingBuffer, PushesAndPopsInOrder) {
+    tt::RingBuffer<int> buffer(3);
+    ASSERT_EQ(4, buffer.capacity());
+    ASSERT_TRUE(buffer.empty());
+
+    const int items[] = {1, 2, 3};
+    ASSERT_EQ(3, buffer.push(items, 3));
+    ASSERT_TRUE(buffer.push(4));
+    ASSERT_EQ(4, buffer.size());
+
+    int item = 0;
+    ASSERT_TRUE(buffer.pop(item));
+    ASSERT_EQ(1, item);
+
+    int popped[8] = {};
+    ASSERT_EQ(3, buffer.pop(popped, 8));
+    ASSERT_EQ(2, popped[0]);
+    ASSERT_EQ(4, popped[2]);
+    ASSERT_FALSE(buffer.pop(item));
+}
+
+TEST(RingBuffer, CountsOverflows) {
+    tt::RingBuffer<int> buffer(4);
+    const int items[] = {1, 2, 3, 4, 5, 6};
+    ASSERT_EQ(4, buffer.push(items, 6));
+    ASSERT_FALSE(buffer.push(7));
+    ASSERT_EQ(3, buffer.getOverflowCount());
+
+    // Dropped items do not overwrite queued ones
+    int item = 0;
+    ASSERT_TRUE(buffer.pop(item));
+    ASSERT_EQ(1, item);
+
+    buffer.clear();
+    ASSERT_TRUE(buffer.empty());
+    ASSERT_TRUE(buffer.push(8));
+    ASSERT_TRUE(buffer.pop(item));
+    ASSERT_EQ(8, item);
+}
+
+TEST(RingBuffer, TransfersBetweenThreads) {
+    constexpr int itemCount = 100000;
+    tt::RingBuffer<int> buffer(64);
+
+    std::thread producer([&buffer] {
+        int next = 0;
+        int batch[16];
+        while (next < itemCount) {
+            int count = 0;
+            while (count < 16 && next + count < itemCount) {
+                batch[count] = next + count;
+                ++count;
+            }
+            // Only pushes what fits, so nothing is dropped and the rest is retried
+            const size_t free = buffer.capacity() - buffer.size();
+            next += static_cast<int>(buffer.push(batch, std::min<size_t>(count, free)));
+        }
+    });
+
+    std::vector<int> received;
+    int batch[16];
+    while (received.size() < itemCount) {
+        const size_t count = buffer.pop(batch, 16);
+        received.insert(received.end(), batch, batch + count);
+    }
+    producer.join();
+
+    ASSERT_EQ(0, buffer.getOverflowCount());
+    for (int i = 0; i < itemCount; ++i) {
+        ASSERT_EQ(i, received[i]);
+    }
+}
@@ -1,15 +1,55 @@
 #include "TT/simulation.h"
 
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <thread>
+
 #include "TT/logging.h"
 
+namespace {
+    /// Remaining wait time below which we spin instead of sleep. Sleeping typically overshoots by up to the scheduler
+    /// granularity of the OS, which is in the order of 50 - 100 microseconds on a modern Linux kernel.
+    constexpr std::chrono::microseconds spinThreshold(200);
+}
+
 tt::Simulation::Simulation() :
     currentState(PreLoad),
-    targetState_(PreLoad) {
+    targetState_(PreLoad),
+    baseFrameInterval_(std::chrono::milliseconds(10)),
+    clockMode_(RealTime),
+    timeScale_(1),
+    simulationTime_(0),
+    wallClockEpoch_(Clock::now()),
+    executionMode_(Sequential),
+    dependencyGraphValid_(false),
+    pendingModels_(0),
+    frameFailed_(false),
+    timingReportInterval_(0) {
 }
 
 void tt::Simulation::addModel(Model& model) {
-    SimModel simModel{model, PreLoad};
-    models.emplace_back(simModel);
+    const uint32_t targetFrameInterval = model.getTargetFrameInterval();
+    auto rateGroup = std::find_if(rateGroups.begin(), rateGroups.end(), [targetFrameInterval](const RateGroup& group) {
+        return group.targetFrameInterval == targetFrameInterval;
+    });
+    if (rateGroup == rateGroups.end()) {
+        rateGroup = rateGroups.insert(rateGroups.end(),
+                                      RateGroup{targetFrameInterval, simulationTime_, false, 0, simulationTime_, 0});
+    }
+
+    SimModel simModel{model, PreLoad, static_cast<size_t>(rateGroup - rateGroups.begin()), {}, {},
+                      std::make_unique<TimingStatistics>()};
+    models.emplace_back(std::move(simModel));
+    dependencyGraphValid_ = false;
+}
+
+tt::Simulation::State tt::Simulation::getCurrentState() {
+    return currentState;
+}
+
+tt::Simulation::State tt::Simulation::getTargetState() {
+    return targetState_;
 }
 
 bool tt::Simulation::setTargetState(const State targetState) {
@@ -19,28 +59,321 @@ bool tt::Simulation::setTargetState(const State targetState) {
     return true;
 }
 
+bool tt::Simulation::setBaseFrameInterval(const std::chrono::microseconds interval) {
+    if (interval <= std::chrono::microseconds::zero()) {
+        log::error("setBaseFrameInterval() requires an interval larger than 0");
+        return false;
+    }
+    baseFrameInterval_ = interval;
+    return true;
+}
+
+std::chrono::microseconds tt::Simulation::getBaseFrameInterval() const {
+    return baseFrameInterval_;
+}
+
+void tt::Simulation::setExecutionMode(const ExecutionMode mode, const size_t workerCount) {
+    executionMode_ = mode;
+    if (mode == Parallel && (threadPool_ == nullptr || threadPool_->getWorkerCount() != workerCount)) {
+        threadPool_ = std::make_unique<ThreadPool>(workerCount);
+    }
+    else if (mode == Sequential) {
+        threadPool_.reset();
+    }
+}
+
+tt::Simulation::ExecutionMode tt::Simulation::getExecutionMode() const {
+    return executionMode_;
+}
+
+bool tt::Simulation::setClockMode(const ClockMode mode, const double timeScale) {
+    if (mode == Scaled && !(timeScale > 0)) {
+        log::error("setClockMode() requires a time scale larger than 0");
+        return false;
+    }
+    clockMode_ = mode;
+    timeScale_ = mode == Scaled ? timeScale : mode == RealTime ? 1 : 0;
+    if (mode != FreeRunning) {
+        // Continue from the current simulated time, rather than catching up with the time spent in another mode
+        wallClockEpoch_ = Clock::now() -
+            std::chrono::duration_cast<Clock::duration>(simulationTime_ / timeScale_);
+    }
+    return true;
+}
+
+tt::Simulation::ClockMode tt::Simulation::getClockMode() const {
+    return clockMode_;
+}
+
+double tt::Simulation::getTimeScale() const {
+    return timeScale_;
+}
+
+std::chrono::nanoseconds tt::Simulation::getSimulationTime() const {
+    return simulationTime_;
+}
+
+bool tt::Simulation::runFor(const std::chrono::nanoseconds duration) {
+    if (baseFrameInterval_ == std::chrono::microseconds::zero() || rateGroups.empty()) {
+        log::error("runFor() requires models and a base frame interval larger than 0");
+        return false;
+    }
+
+    // Simulated time starts at 0 when the simulation starts running, otherwise continues with the next frame
+    const bool started = currentState == Running || currentState == Holding;
+    const std::chrono::nanoseconds end = (started ? getNextFrameTime() : std::chrono::nanoseconds(0)) + duration;
+
+    setTargetState(Running);
+    while (currentState != Running) {
+        const State previousState = currentState;
+        if (!advance() || currentState == previousState) {
+            return false;
+        }
+    }
+
+    while (getNextFrameTime() < end) {
+        if (clockMode_ != FreeRunning) {
+            waitUntil(toWallTime(getNextFrameTime()));
+        }
+        if (!advance()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool tt::Simulation::saveSnapshot(Snapshot& snapshot) {
+    if (currentState != Running && currentState != Holding) {
+        log::error("saveSnapshot() requires a running or holding simulation");
+        return false;
+    }
+    if (!dependencyGraphValid_) {
+        buildDependencyGraph();
+    }
+
+    // A snapshot of another simulation or of other models is rewritten from scratch
+    const size_t segmentCount = busData_.size() + models.size();
+    if (snapshot.owner_ != this || snapshot.segments_.size() != segmentCount) {
+        snapshot.segments_.clear();
+        snapshot.segments_.resize(segmentCount);
+    }
+    snapshot.owner_ = nullptr;
+
+    for (size_t i = 0; i < segmentCount; ++i) {
+        Snapshot::Segment& segment = snapshot.segments_[i];
+        const BusDataBase* busData = i < busData_.size() ? busData_[i] : nullptr;
+        const std::string_view name = busData != nullptr
+            ? busData->getName()
+            : models[i - busData_.size()].model.getName();
+        const bool sameSource = segment.data != nullptr && segment.name == name;
+        if (busData != nullptr && sameSource && busData->getBuffering() == BusDataBase::DoubleBuffered &&
+            segment.version == busData->getVersion()) {
+            continue;
+        }
+
+        if (!sameSource) {
+            segment.name = std::string(name);
+        }
+        if (segment.data == nullptr || segment.data.use_count() > 1) {
+            segment.data = std::make_shared<std::vector<uint8_t>>();
+        }
+        else {
+            segment.data->clear();
+        }
+
+        // Copy on write bus data is shared rather than serialised, and bus data without a Serialiser leaves its
+        // segment empty
+        if (busData != nullptr) {
+            segment.value = busData->share();
+            if (segment.value == nullptr) {
+                busData->serialise(*segment.data);
+            }
+            segment.version = busData->getVersion();
+        }
+        else if (!models[i - busData_.size()].model.saveState(*segment.data)) {
+            log::error("saveSnapshot(): ", name, " failed to save its state");
+            segment.data.reset();
+            return false;
+        }
+    }
+
+    snapshot.rateGroups_.clear();
+    for (const auto& rateGroup : rateGroups) {
+        snapshot.rateGroups_.push_back({rateGroup.targetFrameInterval, rateGroup.nextFrameTime,
+                                        rateGroup.previousFrameTime, rateGroup.deltaTime});
+    }
+    snapshot.simulationTime_ = simulationTime_;
+    snapshot.owner_ = this;
+    return true;
+}
+
+bool tt::Simulation::restoreSnapshot(const Snapshot& snapshot) {
+    if (currentState != Running && currentState != Holding) {
+        log::error("restoreSnapshot() requires a running or holding simulation");
+        return false;
+    }
+    if (!dependencyGraphValid_) {
+        buildDependencyGraph();
+    }
+
+    bool matches = snapshot.owner_ == this && snapshot.segments_.size() == busData_.size() + models.size() &&
+        snapshot.rateGroups_.size() == rateGroups.size();
+    for (size_t i = 0; matches && i < busData_.size(); ++i) {
+        matches = snapshot.segments_[i].name == busData_[i]->getName();
+    }
+    for (size_t i = 0; matches && i < models.size(); ++i) {
+        matches = snapshot.segments_[busData_.size() + i].name == models[i].model.getName();
+    }
+    for (size_t i = 0; matches && i < rateGroups.size(); ++i) {
+        matches = snapshot.rateGroups_[i].targetFrameInterval == rateGroups[i].targetFrameInterval;
+    }
+    if (!matches) {
+        log::error("restoreSnapshot(): the snapshot was not taken of this simulation and its models");
+        return false;
+    }
+
+    for (size_t i = 0; i < busData_.size(); ++i) {
+        const Snapshot::Segment& segment = snapshot.segments_[i];
+        const std::vector<uint8_t>& data = *segment.data;
+        const bool restored = segment.value != nullptr
+            ? busData_[i]->restoreShared(segment.value.get())
+            : data.empty() || busData_[i]->deserialise(data.data(), data.size());
+        if (!restored) {
+            log::error("restoreSnapshot(): ", busData_[i]->getName(), " cannot be restored");
+            return false;
+        }
+    }
+    // Readers see the restored values of DoubleBuffered bus data right away, as they did when the snapshot was taken
+    for (const BusDataBase* busData : busData_) {
+        busData->publish();
+    }
+
+    for (size_t i = 0; i < models.size(); ++i) {
+        const std::vector<uint8_t>& data = *snapshot.segments_[busData_.size() + i].data;
+        ByteReader reader(data.data(), data.size());
+        if (!models[i].model.restoreState(reader)) {
+            log::error("restoreSnapshot(): ", models[i].model.getName(), " cannot restore its state");
+            return false;
+        }
+    }
+
+    simulationTime_ = snapshot.simulationTime_;
+    for (size_t i = 0; i < rateGroups.size(); ++i) {
+        rateGroups[i].nextFrameTime = snapshot.rateGroups_[i].nextFrameTime;
+        rateGroups[i].previousFrameTime = snapshot.rateGroups_[i].previousFrameTime;
+        rateGroups[i].deltaTime = snapshot.rateGroups_[i].deltaTime;
+        // Restoring from a frame listener must not reschedule the groups which ran in the current frame
+        rateGroups[i].due = false;
+    }
+    // Continue pacing from the restored time, rather than catching up with or waiting for the wall clock
+    setClockMode(clockMode_, timeScale_);
+
+    for (auto& model : models) {
+        if (!model.model.reinit()) {
+            log::error("restoreSnapshot(): ", model.model.getName(), " failed to reinitialise");
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t tt::Simulation::getOverrunCount() const {
+    uint64_t overruns = 0;
+    for (const auto& rateGroup : rateGroups) {
+        overruns += rateGroup.overruns;
+    }
+    return overruns;
+}
+
+tt::TimingStatistics::Summary tt::Simulation::getFrameTiming() const {
+    return frameTiming_.getSummary();
+}
+
+tt::TimingStatistics::Summary tt::Simulation::getModelTiming(const Model& model) const {
+    const auto simModel = std::find_if(models.begin(), models.end(), [&model](const SimModel& candidate) {
+        return &candidate.model == &model;
+    });
+    if (simModel == models.end()) {
+        return TimingStatistics().getSummary();
+    }
+    return simModel->timing->getSummary();
+}
+
+void tt::Simulation::resetTiming() {
+    frameTiming_.reset();
+    for (auto& model : models) {
+        model.timing->reset();
+    }
+}
+
+void tt::Simulation::setTimingReport(const std::chrono::milliseconds interval) {
+    timingReportInterval_ = interval;
+    nextTimingReport_ = Clock::now() + interval;
+}
+
+void tt::Simulation::addFrameListener(FrameListener listener) {
+    frameListeners_.emplace_back(std::move(listener));
+}
+
 void tt::Simulation::step() {
+    advance();
+}
+
+bool tt::Simulation::advance() {
     // The most common case here for efficiency
     if (targetState_ == Running && (currentState == Running || currentState == Initialised)) {
-        if (run()) {
-            currentState = Running;
+        if (currentState == Initialised) {
+            // Models may have requested further bus data handles while loading or initialising
+            dependencyGraphValid_ = false;
+            simulationTime_ = std::chrono::nanoseconds::zero();
+            resetDeadlines();
+        }
+        if (!run()) {
+            return false;
+        }
+        currentState = Running;
+        return true;
+    }
+
+    if (targetState_ == Holding && currentState == Running) {
+        if (!hold()) {
+            return false;
+        }
+        currentState = Holding;
+        return true;
+    }
+
+    if (targetState_ == Running && currentState == Holding) {
+        // Continue from the current simulated time, rather than catching up with the time spent holding
+        setClockMode(clockMode_, timeScale_);
+        currentState = Running;
+        return true;
+    }
+
+    if (targetState_ == Unloaded && currentState != Unloaded) {
+        if (currentState >= Loaded && !unload()) {
+            return false;
         }
-        return;
+        currentState = Unloaded;
+        return true;
     }
 
     if (targetState_ >= Loaded && currentState < Loaded) {
-        if (load()) {
-            currentState = Loaded;
+        if (!load()) {
+            return false;
         }
-        return;
+        currentState = Loaded;
+        return true;
     }
 
     if (targetState_ >= Initialised && currentState < Initialised) {
-        if (init()) {
-            currentState = Initialised;
+        if (!init()) {
+            return false;
         }
-        return;
+        currentState = Initialised;
+        return true;
     }
+    return true;
 }
 
 void tt::Simulation::main() {
@@ -48,6 +381,19 @@ void tt::Simulation::main() {
 
     while (currentState != Unloaded) {
         step();
+
+        if (currentState == Running && clockMode_ != FreeRunning) {
+            if (rateGroups.empty()) {
+                std::this_thread::sleep_for(baseFrameInterval_);
+            }
+            else {
+                waitUntil(toWallTime(getNextFrameTime()));
+            }
+        }
+        else if (currentState == targetState_) {
+            // Nothing to do until someone requests a new state, there is no need to poll at more than the base rate
+            std::this_thread::sleep_for(baseFrameInterval_);
+        }
     }
 }
 
@@ -78,14 +424,213 @@ bool tt::Simulation::init() {
 }
 
 bool tt::Simulation::run() {
-    for (auto& model : models) {
-        if (model.model.run() == false) {
+    if (!dependencyGraphValid_) {
+        buildDependencyGraph();
+    }
+
+    // The next frame is executed once the wall clock reaches it, or right away when free running
+    const std::chrono::nanoseconds frameTime = getNextFrameTime();
+    const Clock::time_point frameStart = Clock::now();
+    if (rateGroups.empty() || (clockMode_ != FreeRunning && frameStart < toWallTime(frameTime))) {
+        return true;
+    }
+
+    simulationTime_ = frameTime;
+    for (auto& rateGroup : rateGroups) {
+        rateGroup.due = rateGroup.nextFrameTime <= frameTime;
+        if (rateGroup.due) {
+            rateGroup.deltaTime = std::chrono::duration<double>(frameTime - rateGroup.previousFrameTime).count();
+            rateGroup.previousFrameTime = frameTime;
+        }
+    }
+
+    if (executionMode_ == Parallel) {
+        if (!runParallel()) {
             return false;
         }
     }
+    else {
+        for (auto& model : models) {
+            if (rateGroups[model.rateGroup].due && runModel(model) == false) {
+                return false;
+            }
+        }
+    }
+
+    // No model is running now, so double buffered bus data can safely swap its buffers
+    for (const BusDataBase* busData : busData_) {
+        busData->publish();
+    }
+    // Schedule the next frame of each group which ran before the listeners, so a snapshot taken by one continues with
+    // the frame following this one
+    for (auto& rateGroup : rateGroups) {
+        if (rateGroup.due) {
+            rateGroup.nextFrameTime += getRateGroupInterval(rateGroup.targetFrameInterval);
+        }
+    }
+    for (const auto& listener : frameListeners_) {
+        listener(frameTime);
+    }
+
+    // If a group is still busy when the wall clock passes its next frame, the missed frames are skipped rather than
+    // executed back to back, keeping the group in phase with its rate. A listener restoring a snapshot clears due.
+    const Clock::time_point frameEnd = Clock::now();
+    const auto wallTimeEnd = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        (frameEnd - wallClockEpoch_) * timeScale_);
+    for (auto& rateGroup : rateGroups) {
+        if (!rateGroup.due) {
+            continue;
+        }
+        const std::chrono::nanoseconds interval = getRateGroupInterval(rateGroup.targetFrameInterval);
+        if (clockMode_ != FreeRunning && interval > std::chrono::nanoseconds::zero() &&
+            rateGroup.nextFrameTime <= wallTimeEnd) {
+            const auto missedFrames = (wallTimeEnd - rateGroup.nextFrameTime) / interval + 1;
+            rateGroup.nextFrameTime += missedFrames * interval;
+            rateGroup.overruns += missedFrames;
+        }
+    }
+
+    frameTiming_.record(frameEnd - frameStart, baseFrameInterval_);
+    if (timingReportInterval_ > Clock::duration::zero() && frameEnd >= nextTimingReport_) {
+        writeTimingReport();
+        nextTimingReport_ = frameEnd + timingReportInterval_;
+    }
     return true;
 }
 
+bool tt::Simulation::runModel(SimModel& model) {
+    model.model.setDeltaTime(rateGroups[model.rateGroup].deltaTime);
+    const Clock::time_point start = Clock::now();
+    const bool success = model.model.run();
+    model.timing->record(Clock::now() - start, getRateGroupInterval(rateGroups[model.rateGroup].targetFrameInterval));
+    return success;
+}
+
+void tt::Simulation::writeTimingReport() const {
+    // One message per line, formatted on the stack as logging does not allocate either
+    char line[log::maximumMessageLength];
+    const auto logLine = [&line](const int length) {
+        log::info(std::string_view(line, std::min<size_t>(std::max(length, 0), sizeof(line) - 1)));
+    };
+    const auto writeLine = [&](const std::string_view name, const TimingStatistics::Summary& summary) {
+        const auto toMicroseconds = [](const TimingStatistics::Duration duration) {
+            return std::chrono::duration<double, std::micro>(duration).count();
+        };
+        logLine(std::snprintf(line, sizeof(line), "%-32.*s %10" PRIu64 " %10.1f %10.1f %10.1f %10.1f %10" PRIu64,
+                              static_cast<int>(name.size()), name.data(), summary.count,
+                              toMicroseconds(summary.minimum), toMicroseconds(summary.average),
+                              toMicroseconds(summary.percentile99), toMicroseconds(summary.maximum),
+                              summary.overruns));
+    };
+
+    logLine(std::snprintf(line, sizeof(line), "%-32s %10s %10s %10s %10s %10s %10s",
+                          "Timing [us]", "count", "min", "avg", "p99", "max", "overruns"));
+    writeLine("Frame", frameTiming_.getSummary());
+    for (const auto& model : models) {
+        writeLine(model.model.getName(), model.timing->getSummary());
+    }
+}
+
+bool tt::Simulation::runParallel() {
+    // Models which are not due this frame are treated as already complete, so they do not hold back their successors
+    size_t dueModels = 0;
+    readyModels_.clear();
+    for (size_t i = 0; i < models.size(); ++i) {
+        if (!rateGroups[models[i].rateGroup].due) {
+            continue;
+        }
+        size_t duePredecessors = 0;
+        for (const size_t predecessor : models[i].predecessors) {
+            duePredecessors += rateGroups[models[predecessor].rateGroup].due ? 1 : 0;
+        }
+        pendingPredecessors_[i].store(duePredecessors, std::memory_order_relaxed);
+        if (duePredecessors == 0) {
+            readyModels_.push_back(i);
+        }
+        ++dueModels;
+    }
+    if (dueModels == 0) {
+        return true;
+    }
+
+    // The ready models are known before the first one is submitted. Once models run they release their successors,
+    // which must not be submitted a second time.
+    frameFailed_.store(false, std::memory_order_relaxed);
+    pendingModels_.store(dueModels, std::memory_order_release);
+    for (const size_t i : readyModels_) {
+        threadPool_->submit([this, i] { runParallelModel(i); });
+    }
+
+    threadPool_->waitUntil([this] {
+        return pendingModels_.load(std::memory_order_acquire) == 0;
+    });
+    return !frameFailed_.load(std::memory_order_relaxed);
+}
+
+void tt::Simulation::runParallelModel(const size_t index) {
+    // Unlike the sequential mode the frame is not aborted on failure, as other models may already be running
+    if (runModel(models[index]) == false) {
+        frameFailed_.store(true, std::memory_order_relaxed);
+    }
+
+    for (const size_t successor : models[index].successors) {
+        if (rateGroups[models[successor].rateGroup].due &&
+            pendingPredecessors_[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            threadPool_->submit([this, successor] { runParallelModel(successor); });
+        }
+    }
+    pendingModels_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void tt::Simulation::buildDependencyGraph() {
+    const auto intersects = [](const std::vector<const BusDataBase*>& a, const std::vector<const BusDataBase*>& b) {
+        return std::any_of(a.begin(), a.end(), [&b](const BusDataBase* busData) {
+            return std::find(b.begin(), b.end(), busData) != b.end();
+        });
+    };
+
+    // Readers of double buffered bus data see the previous frame, so only the writers have to be ordered
+    const auto readWriteIntersects = [](const std::vector<const BusDataBase*>& reads,
+                                        const std::vector<const BusDataBase*>& writes) {
+        return std::any_of(reads.begin(), reads.end(), [&writes](const BusDataBase* busData) {
+            return busData->getBuffering() == BusDataBase::Shared &&
+                std::find(writes.begin(), writes.end(), busData) != writes.end();
+        });
+    };
+
+    busData_.clear();
+    for (const auto& model : models) {
+        for (const auto* accesses : {&model.model.getReads(), &model.model.getWrites()}) {
+            for (const BusDataBase* busData : *accesses) {
+                if (std::find(busData_.begin(), busData_.end(), busData) == busData_.end()) {
+                    busData_.push_back(busData);
+                }
+            }
+        }
+    }
+
+    for (auto& model : models) {
+        model.predecessors.clear();
+        model.successors.clear();
+    }
+
+    for (size_t later = 0; later < models.size(); ++later) {
+        const Model& laterModel = models[later].model;
+        for (size_t earlier = 0; earlier < later; ++earlier) {
+            const Model& earlierModel = models[earlier].model;
+            if (readWriteIntersects(laterModel.getReads(), earlierModel.getWrites()) ||
+                readWriteIntersects(earlierModel.getReads(), laterModel.getWrites()) ||
+                intersects(earlierModel.getWrites(), laterModel.getWrites())) {
+                models[later].predecessors.push_back(earlier);
+                models[earlier].successors.push_back(later);
+            }
+        }
+    }
+
+    pendingPredecessors_ = std::make_unique<std::atomic<size_t>[]>(models.size());
+    dependencyGraphValid_ = true;
+}
+
 bool tt::Simulation::hold() {
     for (auto& model : models) {
         if (model.model.hold() == false) {
@@ -103,3 +648,40 @@ bool tt::Simulation::unload() {
     }
     return true;
 }
+
+void tt::Simulation::resetDeadlines() {
+    for (auto& rateGroup : rateGroups) {
+        rateGroup.nextFrameTime = simulationTime_;
+        // The first frame integrates over a single interval
+        rateGroup.previousFrameTime = simulationTime_ - getRateGroupInterval(rateGroup.targetFrameInterval);
+    }
+    setClockMode(clockMode_, timeScale_);
+}
+
+std::chrono::nanoseconds tt::Simulation::getNextFrameTime() const {
+    std::chrono::nanoseconds nextFrameTime = std::chrono::nanoseconds::max();
+    for (const auto& rateGroup : rateGroups) {
+        nextFrameTime = std::min(nextFrameTime, rateGroup.nextFrameTime);
+    }
+    return nextFrameTime;
+}
+
+tt::Simulation::Clock::time_point tt::Simulation::toWallTime(const std::chrono::nanoseconds simulationTime) const {
+    return wallClockEpoch_ + std::chrono::duration_cast<Clock::duration>(simulationTime / timeScale_);
+}
+
+void tt::Simulation::waitUntil(const Clock::time_point deadline) {
+    if (Clock::now() + spinThreshold < deadline) {
+        std::this_thread::sleep_until(deadline - spinThreshold);
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+std::chrono::nanoseconds tt::Simulation::getRateGroupInterval(const uint32_t targetFrameInterval) const {
+    if (targetFrameInterval == 0) {
+        return baseFrameInterval_;
+    }
+    return std::chrono::milliseconds(targetFrameInterval);
+}
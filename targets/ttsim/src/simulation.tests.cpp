@@ -0,0 +1,732 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TT/entity_store.h"
+#include "TT/logging.h"
+#include "TT/simulation.h"
+
+namespace {
+    class CountingModel final : public tt::Model {
+    public:
+        explicit CountingModel(const uint32_t targetFrameInterval) :
+            Model("CountingModel", targetFrameInterval) {
+        }
+
+        bool run() override {
+            ++runs;
+            return true;
+        }
+
+        int runs = 0;
+    };
+
+    void stepFor(tt::Simulation& simulation, const std::chrono::milliseconds duration) {
+        const auto end = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < end) {
+            simulation.step();
+        }
+    }
+}
+
+TEST(Simulation, ReachesRunningState) {
+    CountingModel model(0);
+    tt::Simulation simulation;
+    simulation.addModel(model);
+    simulation.setTargetState(tt::Simulation::Running);
+
+    simulation.step(); // load
+    simulation.step(); // init
+    ASSERT_EQ(0, model.runs);
+    simulation.step(); // first frame, every rate group is due
+    ASSERT_EQ(1, model.runs);
+}
+
+TEST(Simulation, ModelsSeeTimeSincePreviousRun) {
+    class DeltaTimeModel final : public tt::Model {
+    public:
+        DeltaTimeModel() :
+            Model("DeltaTimeModel", 20) {
+        }
+
+        bool run() override {
+            deltaTimes.push_back(getDeltaTime());
+            return true;
+        }
+
+        std::vector<double> deltaTimes;
+    };
+
+    DeltaTimeModel model;
+    tt::Simulation simulation;
+    simulation.addModel(model);
+    simulation.setTargetState(tt::Simulation::Running);
+    stepFor(simulation, std::chrono::milliseconds(70));
+
+    ASSERT_GE(model.deltaTimes.size(), 3);
+    for (const double deltaTime : model.deltaTimes) {
+        ASSERT_NEAR(0.02, deltaTime, 0.005);
+    }
+}
+
+TEST(Simulation, RateGroupsHonourTargetFrameInterval) {
+    CountingModel fastModel(0);
+    CountingModel slowModel(50);
+    tt::Simulation simulation;
+    ASSERT_TRUE(simulation.setBaseFrameInterval(std::chrono::milliseconds(5)));
+    simulation.addModel(fastModel);
+    simulation.addModel(slowModel);
+    simulation.setTargetState(tt::Simulation::Running);
+
+    // Stepping in a tight loop must not run the models more often than their rate group allows. A loaded machine may
+    // only make the models run less often, so the counts are bounded from above by the time actually spent stepping.
+    const auto start = std::chrono::steady_clock::now();
+    stepFor(simulation, std::chrono::milliseconds(120));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_GE(slowModel.runs, 1);
+    ASSERT_LE(slowModel.runs, elapsed / std::chrono::milliseconds(50) + 1);
+    ASSERT_GE(fastModel.runs, 1);
+    ASSERT_LE(fastModel.runs, elapsed / std::chrono::milliseconds(5) + 1);
+}
+
+TEST(Simulation, RejectsNonPositiveBaseFrameInterval) {
+    tt::Simulation simulation;
+    ASSERT_FALSE(simulation.setBaseFrameInterval(std::chrono::microseconds(0)));
+    ASSERT_FALSE(simulation.setBaseFrameInterval(std::chrono::microseconds(-5)));
+    ASSERT_EQ(std::chrono::milliseconds(10), simulation.getBaseFrameInterval());
+    ASSERT_TRUE(simulation.setBaseFrameInterval(std::chrono::milliseconds(5)));
+    ASSERT_EQ(std::chrono::milliseconds(5), simulation.getBaseFrameInterval());
+}
+
+TEST(Simulation, FreeRunningRunsForSimulatedTime) {
+    CountingModel fastModel(0);
+    CountingModel slowModel(100);
+    tt::Simulation simulation;
+    simulation.addModel(fastModel);
+    simulation.addModel(slowModel);
+    simulation.setClockMode(tt::Simulation::FreeRunning);
+
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(simulation.runFor(std::chrono::seconds(60)));
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+
+    // Every frame of the minute is executed, none is skipped
+    ASSERT_EQ(6000, fastModel.runs);
+    ASSERT_EQ(600, slowModel.runs);
+    ASSERT_EQ(std::chrono::milliseconds(59990), simulation.getSimulationTime());
+    ASSERT_EQ(0, simulation.getOverrunCount());
+
+    ASSERT_TRUE(simulation.runFor(std::chrono::seconds(1)));
+    ASSERT_EQ(6100, fastModel.runs);
+}
+
+TEST(Simulation, ScaledClockRunsFasterThanRealTime) {
+    CountingModel model(0);
+    tt::Simulation simulation;
+    simulation.addModel(model);
+    simulation.setClockMode(tt::Simulation::Scaled, 10);
+    ASSERT_EQ(10, simulation.getTimeScale());
+
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(500)));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    // Paced by the wall clock, the last frame at 490 ms of simulated time cannot start before 49 ms. The upper bound
+    // leaves a wide margin for a loaded machine and only checks that the simulation ran faster than real time.
+    ASSERT_GE(elapsed, std::chrono::milliseconds(49));
+    ASSERT_LT(elapsed, std::chrono::milliseconds(490));
+    // Frames missed on a loaded machine are skipped, but every frame is either executed or counted as an overrun
+    ASSERT_EQ(50, model.runs + simulation.getOverrunCount());
+    ASSERT_EQ(std::chrono::milliseconds(490), simulation.getSimulationTime());
+}
+
+TEST(Simulation, RejectsNonPositiveTimeScale) {
+    tt::Simulation simulation;
+    ASSERT_FALSE(simulation.setClockMode(tt::Simulation::Scaled, 0));
+    ASSERT_FALSE(simulation.setClockMode(tt::Simulation::Scaled, -2));
+    ASSERT_FALSE(simulation.setClockMode(tt::Simulation::Scaled, std::numeric_limits<double>::quiet_NaN()));
+    ASSERT_EQ(tt::Simulation::RealTime, simulation.getClockMode());
+    ASSERT_EQ(1, simulation.getTimeScale());
+
+    // The time scale only matters in Scaled mode
+    ASSERT_TRUE(simulation.setClockMode(tt::Simulation::FreeRunning, 0));
+    ASSERT_TRUE(simulation.setClockMode(tt::Simulation::Scaled, 0.5));
+    ASSERT_EQ(0.5, simulation.getTimeScale());
+}
+
+namespace {
+    class SleepingModel final : public tt::Model {
+    public:
+        SleepingModel(const uint32_t targetFrameInterval, const std::chrono::milliseconds sleep) :
+            Model("SleepingModel", targetFrameInterval),
+            sleep_(sleep) {
+        }
+
+        bool run() override {
+            std::this_thread::sleep_for(sleep_);
+            return true;
+        }
+
+    private:
+        const std::chrono::milliseconds sleep_;
+    };
+}
+
+TEST(Simulation, RecordsModelAndFrameTiming) {
+    CountingModel fastModel(0);
+    SleepingModel slowModel(0, std::chrono::milliseconds(3));
+    CountingModel unknownModel(0);
+    tt::Simulation simulation;
+    simulation.setBaseFrameInterval(std::chrono::milliseconds(2));
+    simulation.addModel(fastModel);
+    simulation.addModel(slowModel);
+    simulation.setTargetState(tt::Simulation::Running);
+    stepFor(simulation, std::chrono::milliseconds(30));
+
+    const auto fastTiming = simulation.getModelTiming(fastModel);
+    ASSERT_EQ(fastModel.runs, fastTiming.count);
+    ASSERT_EQ(0, fastTiming.overruns);
+
+    const auto slowTiming = simulation.getModelTiming(slowModel);
+    ASSERT_EQ(fastTiming.count, slowTiming.count);
+    ASSERT_GE(slowTiming.minimum, std::chrono::milliseconds(3));
+    ASSERT_EQ(slowTiming.count, slowTiming.overruns);
+
+    const auto frameTiming = simulation.getFrameTiming();
+    ASSERT_EQ(fastTiming.count, frameTiming.count);
+    ASSERT_GE(frameTiming.maximum, slowTiming.maximum);
+    ASSERT_EQ(frameTiming.count, frameTiming.overruns);
+
+    ASSERT_EQ(0, simulation.getModelTiming(unknownModel).count);
+
+    simulation.resetTiming();
+    ASSERT_EQ(0, simulation.getFrameTiming().count);
+    ASSERT_EQ(0, simulation.getModelTiming(slowModel).count);
+}
+
+TEST(Simulation, LogsTimingReport) {
+    std::FILE* file = std::tmpfile();
+    tt::log::flush();
+    tt::log::setOutput(file);
+
+    CountingModel model(0);
+    tt::Simulation simulation;
+    simulation.setBaseFrameInterval(std::chrono::milliseconds(1));
+    simulation.setTimingReport(std::chrono::milliseconds(1));
+    simulation.addModel(model);
+    simulation.setTargetState(tt::Simulation::Running);
+    stepFor(simulation, std::chrono::milliseconds(10));
+
+    tt::log::flush();
+    tt::log::setOutput(stdout);
+    std::string text;
+    std::rewind(file);
+    char buffer[256];
+    size_t count;
+    while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, count);
+    }
+    std::fclose(file);
+
+    // Every line of the report is a message of its own
+    ASSERT_NE(std::string::npos, text.find("INFO: Timing [us]"));
+    ASSERT_NE(std::string::npos, text.find("\nINFO: Frame "));
+    ASSERT_NE(std::string::npos, text.find("\nINFO: CountingModel "));
+}
+
+namespace {
+    class WriterModel final : public tt::Model {
+    public:
+        explicit WriterModel(tt::BusData<int>& value) :
+            Model("Writer", 0),
+            outValue(value.getWriteHandle(this)) {
+        }
+
+        bool run() override {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++*outValue;
+            return true;
+        }
+
+    private:
+        const tt::WriteHandle<int> outValue;
+    };
+
+    class ReaderModel final : public tt::Model {
+    public:
+        explicit ReaderModel(const tt::BusData<int>& value) :
+            Model("Reader", 0),
+            inValue(value.getReadHandle(this)) {
+        }
+
+        bool run() override {
+            seen.push_back(*inValue);
+            return true;
+        }
+
+        std::vector<int> seen;
+
+    private:
+        const tt::ReadHandle<int> inValue;
+    };
+}
+
+TEST(Simulation, ParallelModeRespectsBusDataDependencies) {
+    tt::BusData<int> value(0, "Test.Value");
+    tt::BusData<int> otherValue(0, "Test.OtherValue");
+    WriterModel writer(value);
+    WriterModel independentWriter(otherValue);
+    ReaderModel reader(value);
+
+    tt::Simulation simulation;
+    simulation.setBaseFrameInterval(std::chrono::milliseconds(1));
+    simulation.setExecutionMode(tt::Simulation::Parallel, 2);
+    simulation.addModel(writer);
+    simulation.addModel(independentWriter);
+    simulation.addModel(reader);
+    simulation.setTargetState(tt::Simulation::Running);
+
+    stepFor(simulation, std::chrono::milliseconds(50));
+
+    // The reader must always run after the writer of the same frame
+    ASSERT_FALSE(reader.seen.empty());
+    for (size_t frame = 0; frame < reader.seen.size(); ++frame) {
+        ASSERT_EQ(static_cast<int>(frame) + 1, reader.seen[frame]);
+    }
+}
+
+TEST(BusData, DoubleBufferedPublishesAtFrameEnd) {
+    tt::BusData<int> value(0, "Test.Value", tt::BusData<int>::DoubleBuffered);
+    const auto reader = value.getReadHandle();
+    const auto writer = value.getWriteHandle();
+
+    *writer = 5;
+    ASSERT_EQ(0, *reader);
+    ASSERT_EQ(0, reader.getVersion());
+
+    value.publish();
+    ASSERT_EQ(5, *reader);
+    ASSERT_EQ(1, reader.getVersion());
+
+    // The back buffer continues from the published value
+    ASSERT_EQ(5, *writer);
+    *writer += 1;
+    ASSERT_EQ(5, *reader);
+    value.publish();
+    ASSERT_EQ(6, *reader);
+}
+
+namespace {
+    /// Counts how often values are copied
+    struct Counted {
+        Counted() = default;
+
+        Counted(const Counted& other) :
+            value(other.value) {
+            ++copies;
+        }
+
+        Counted& operator=(const Counted& other) {
+            value = other.value;
+            ++copies;
+            return *this;
+        }
+
+        int value = 0;
+
+        static inline int copies = 0;
+    };
+}
+
+TEST(BusData, DoubleBufferedPublishCopiesOnFirstWrite) {
+    tt::BusData<Counted> data(Counted(), "Test.Counted", tt::BusDataBase::DoubleBuffered);
+    const auto reader = data.getReadHandle();
+    const auto writer = data.getWriteHandle();
+    Counted::copies = 0;
+
+    // Publishing does not copy, neither do frames without writes
+    writer->value = 5;
+    data.publish();
+    data.publish();
+    ASSERT_EQ(0, Counted::copies);
+    ASSERT_EQ(5, reader->value);
+
+    // The first write after a publish carries the published value over, once
+    ASSERT_EQ(5, writer->value);
+    writer->value += 1;
+    ASSERT_EQ(1, Counted::copies);
+    ASSERT_EQ(5, reader->value);
+    data.publish();
+    ASSERT_EQ(6, reader->value);
+    ASSERT_EQ(1, Counted::copies);
+}
+
+TEST(Simulation, DoubleBufferedReadersSeePreviousFrame) {
+    tt::BusData<int> value(0, "Test.Value", tt::BusData<int>::DoubleBuffered);
+    WriterModel writer(value);
+    ReaderModel reader(value);
+
+    tt::Simulation simulation;
+    simulation.setBaseFrameInterval(std::chrono::milliseconds(1));
+    simulation.setExecutionMode(tt::Simulation::Parallel, 2);
+    simulation.addModel(writer);
+    simulation.addModel(reader);
+    simulation.setTargetState(tt::Simulation::Running);
+
+    stepFor(simulation, std::chrono::milliseconds(50));
+
+    ASSERT_FALSE(reader.seen.empty());
+    for (size_t frame = 0; frame < reader.seen.size(); ++frame) {
+        ASSERT_EQ(static_cast<int>(frame), reader.seen[frame]);
+    }
+}
+
+TEST(Simulation, FrameListenersSeeEveryFrame) {
+    CountingModel fast(0);
+    CountingModel slow(50);
+    tt::Simulation simulation;
+    simulation.setClockMode(tt::Simulation::FreeRunning);
+    simulation.addModel(fast);
+    simulation.addModel(slow);
+
+    std::vector<std::chrono::nanoseconds> frameTimes;
+    simulation.addFrameListener([&frameTimes](const std::chrono::nanoseconds simulationTime) {
+        frameTimes.push_back(simulationTime);
+    });
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(100)));
+
+    ASSERT_EQ(10, frameTimes.size());
+    for (size_t i = 0; i < frameTimes.size(); ++i) {
+        ASSERT_EQ(std::chrono::milliseconds(10 * i), frameTimes[i]);
+    }
+}
+
+TEST(Simulation, HoldStopsFramesUntilResumed) {
+    CountingModel model(0);
+    tt::Simulation simulation;
+    simulation.setClockMode(tt::Simulation::FreeRunning);
+    simulation.addModel(model);
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(100)));
+    ASSERT_EQ(10, model.runs);
+
+    simulation.setTargetState(tt::Simulation::Holding);
+    simulation.step();
+    ASSERT_EQ(tt::Simulation::Holding, simulation.getCurrentState());
+    for (int i = 0; i < 10; ++i) {
+        simulation.step();
+    }
+    ASSERT_EQ(10, model.runs);
+
+    // Simulated time continues where it stopped
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(100)));
+    ASSERT_EQ(20, model.runs);
+    ASSERT_EQ(std::chrono::milliseconds(190), simulation.getSimulationTime());
+}
+
+TEST(Simulation, UnloadEndsMain) {
+    class UnloadModel final : public tt::Model {
+    public:
+        UnloadModel() :
+            Model("UnloadModel", 0) {
+        }
+
+        bool unload() override {
+            unloaded = true;
+            return true;
+        }
+
+        std::atomic<bool> unloaded = false;
+    };
+
+    UnloadModel model;
+    tt::Simulation simulation;
+    simulation.setClockMode(tt::Simulation::FreeRunning);
+    simulation.addModel(model);
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(10)));
+    simulation.setTargetState(tt::Simulation::Unloaded);
+    simulation.main();
+    ASSERT_EQ(tt::Simulation::Unloaded, simulation.getCurrentState());
+    ASSERT_TRUE(model.unloaded);
+}
+
+namespace {
+    /// Integrates its input into an internal sum, and publishes the number of runs
+    class IntegratingModel final : public tt::Model {
+    public:
+        IntegratingModel(const tt::BusData<double>& input, tt::BusData<int>& output,
+                         const uint32_t targetFrameInterval = 0) :
+            Model("IntegratingModel", targetFrameInterval),
+            input_(input.getReadHandle(this)),
+            output_(output.getWriteHandle(this)) {
+        }
+
+        bool run() override {
+            sum += *input_ * getDeltaTime();
+            ++*output_;
+            return true;
+        }
+
+        bool saveState(std::vector<uint8_t>& buffer) const override {
+            tt::appendBytes(buffer, sum);
+            return true;
+        }
+
+        bool restoreState(tt::ByteReader& reader) override {
+            return reader.read(sum);
+        }
+
+        bool reinit() override {
+            ++reinits;
+            return true;
+        }
+
+        double sum = 0;
+
+        int reinits = 0;
+
+    private:
+        const tt::ReadHandle<double> input_;
+
+        const tt::WriteHandle<int> output_;
+    };
+}
+
+TEST(Simulation, RestoresSnapshot) {
+    tt::BusData<double> input(2, "Input");
+    tt::BusData<int> runs(0, "Runs", tt::BusDataBase::DoubleBuffered);
+    IntegratingModel model(input, runs);
+    const auto readRuns = runs.getReadHandle();
+
+    tt::Simulation simulation;
+    simulation.setClockMode(tt::Simulation::FreeRunning);
+    simulation.addModel(model);
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(100)));
+
+    tt::Snapshot snapshot;
+    ASSERT_TRUE(snapshot.empty());
+    ASSERT_TRUE(simulation.saveSnapshot(snapshot));
+    ASSERT_FALSE(snapshot.empty());
+    ASSERT_EQ(std::chrono::milliseconds(90), snapshot.getSimulationTime());
+
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(100)));
+    const double continuedSum = model.sum;
+    ASSERT_EQ(20, *readRuns);
+
+    // Diverge from the saved scenario, then return to it
+    *input.getWriteHandle() = 5;
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(50)));
+    ASSERT_TRUE(simulation.restoreSnapshot(snapshot));
+    ASSERT_EQ(1, model.reinits);
+    ASSERT_EQ(std::chrono::milliseconds(90), simulation.getSimulationTime());
+    ASSERT_EQ(10, *readRuns);
+    ASSERT_EQ(2, *input.getReadHandle());
+    ASSERT_DOUBLE_EQ(0.2, model.sum);
+
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(100)));
+    ASSERT_EQ(20, *readRuns);
+    ASSERT_EQ(continuedSum, model.sum);
+    ASSERT_EQ(std::chrono::milliseconds(190), simulation.getSimulationTime());
+}
+
+TEST(Simulation, SnapshotsFromFrameListenersContinueWithTheNextFrame) {
+    struct Scenario {
+        tt::BusData<double> input{2, "Input"};
+        tt::BusData<int> runs{0, "Runs", tt::BusDataBase::DoubleBuffered};
+        tt::BusData<int> slowRuns{0, "SlowRuns", tt::BusDataBase::DoubleBuffered};
+        IntegratingModel model{input, runs};
+        IntegratingModel slowModel{input, slowRuns, 30};
+        tt::Simulation simulation;
+
+        Scenario() {
+            simulation.setClockMode(tt::Simulation::FreeRunning);
+            simulation.addModel(model);
+            simulation.addModel(slowModel);
+        }
+    };
+
+    // Both rate groups run in the frames the snapshot is taken and restored in
+    Scenario uninterrupted;
+    ASSERT_TRUE(uninterrupted.simulation.runFor(std::chrono::milliseconds(200)));
+
+    // Restoring between steps
+    Scenario betweenSteps;
+    tt::Snapshot snapshot;
+    betweenSteps.simulation.addFrameListener([&](const std::chrono::nanoseconds frameTime) {
+        if (frameTime == std::chrono::milliseconds(90)) {
+            ASSERT_TRUE(betweenSteps.simulation.saveSnapshot(snapshot));
+        }
+    });
+    ASSERT_TRUE(betweenSteps.simulation.runFor(std::chrono::milliseconds(160)));
+    *betweenSteps.input.getWriteHandle() = 5;
+    ASSERT_TRUE(betweenSteps.simulation.runFor(std::chrono::milliseconds(30)));
+    ASSERT_TRUE(betweenSteps.simulation.restoreSnapshot(snapshot));
+    ASSERT_TRUE(betweenSteps.simulation.runFor(std::chrono::milliseconds(100)));
+
+    // Restoring from a frame listener, in the frame after diverging from the saved scenario
+    Scenario fromListener;
+    tt::Snapshot listenerSnapshot;
+    bool restored = false;
+    fromListener.simulation.addFrameListener([&](const std::chrono::nanoseconds frameTime) {
+        if (frameTime == std::chrono::milliseconds(90) && !restored) {
+            ASSERT_TRUE(fromListener.simulation.saveSnapshot(listenerSnapshot));
+        }
+        else if (frameTime == std::chrono::milliseconds(150) && !restored) {
+            *fromListener.input.getWriteHandle() = 5;
+        }
+        else if (frameTime == std::chrono::milliseconds(180) && !restored) {
+            ASSERT_TRUE(fromListener.simulation.restoreSnapshot(listenerSnapshot));
+            restored = true;
+        }
+    });
+    ASSERT_TRUE(fromListener.simulation.runFor(std::chrono::milliseconds(200)));
+    ASSERT_TRUE(restored);
+
+    for (const Scenario* scenario : {&betweenSteps, &fromListener}) {
+        ASSERT_EQ(uninterrupted.simulation.getSimulationTime(), scenario->simulation.getSimulationTime());
+        ASSERT_EQ(*uninterrupted.runs.getReadHandle(), *scenario->runs.getReadHandle());
+        ASSERT_EQ(*uninterrupted.slowRuns.getReadHandle(), *scenario->slowRuns.getReadHandle());
+        ASSERT_DOUBLE_EQ(uninterrupted.model.sum, scenario->model.sum);
+        ASSERT_DOUBLE_EQ(uninterrupted.slowModel.sum, scenario->slowModel.sum);
+    }
+    ASSERT_EQ(std::chrono::milliseconds(190), uninterrupted.simulation.getSimulationTime());
+    ASSERT_DOUBLE_EQ(0.4, uninterrupted.model.sum);
+}
+
+TEST(Simulation, SnapshotCopiesSurviveRetaking) {
+    tt::BusData<double> input(1, "Input");
+    tt::BusData<int> runs(0, "Runs", tt::BusDataBase::DoubleBuffered);
+    IntegratingModel model(input, runs);
+    const auto readRuns = runs.getReadHandle();
+
+    tt::Simulation simulation;
+    simulation.setClockMode(tt::Simulation::FreeRunning);
+    simulation.addModel(model);
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(50)));
+
+    tt::Snapshot snapshot;
+    ASSERT_TRUE(simulation.saveSnapshot(snapshot));
+    const tt::Snapshot early = snapshot;
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(50)));
+    ASSERT_TRUE(simulation.saveSnapshot(snapshot));
+
+    ASSERT_TRUE(simulation.restoreSnapshot(early));
+    ASSERT_EQ(5, *readRuns);
+    ASSERT_TRUE(simulation.restoreSnapshot(snapshot));
+    ASSERT_EQ(10, *readRuns);
+    ASSERT_EQ(std::chrono::milliseconds(90), simulation.getSimulationTime());
+}
+
+TEST(Simulation, SnapshotsShareCopyOnWriteBusData) {
+    class SpawningModel final : public tt::Model {
+    public:
+        explicit SpawningModel(tt::BusData<tt::EntityStore>& entities) :
+            Model("Spawning", 0),
+            entities_(entities.getWriteHandle(this)) {
+        }
+
+        bool run() override {
+            tt::rpr_fom::PhysicalEntity entity;
+            entity.Spatial.SpatialRVW.WorldLocation.X = static_cast<double>(entities_->size());
+            entities_->add(entity);
+            return true;
+        }
+
+    private:
+        const tt::WriteHandle<tt::EntityStore> entities_;
+    };
+
+    tt::BusData<tt::EntityStore> entities({}, "Entities");
+    SpawningModel model(entities);
+    const auto readEntities = entities.getReadHandle();
+    tt::Simulation simulation;
+    simulation.setClockMode(tt::Simulation::FreeRunning);
+    simulation.addModel(model);
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(100)));
+
+    // The store is kept in the snapshot without being serialised
+    tt::Snapshot snapshot;
+    ASSERT_TRUE(simulation.saveSnapshot(snapshot));
+    ASSERT_EQ(0, snapshot.getSize());
+    const double* savedPositions = readEntities->getPositions().x;
+
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(50)));
+    ASSERT_EQ(15, readEntities->size());
+    const uint64_t revision = readEntities->getRevision();
+
+    // Restoring shares the columns of the snapshot again, and consumers of the store start over
+    ASSERT_TRUE(simulation.restoreSnapshot(snapshot));
+    ASSERT_EQ(10, readEntities->size());
+    ASSERT_EQ(savedPositions, readEntities->getPositions().x);
+    ASSERT_GT(readEntities->getRevision(), revision);
+    ASSERT_FALSE(readEntities->getChanges().covers(revision));
+    for (size_t i = 0; i < readEntities->size(); ++i) {
+        ASSERT_EQ(static_cast<double>(i), readEntities->getPositions().x[i]);
+    }
+
+    // Writing the restored store leaves the snapshot as it was
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(50)));
+    ASSERT_NE(savedPositions, readEntities->getPositions().x);
+    ASSERT_TRUE(simulation.restoreSnapshot(snapshot));
+    ASSERT_EQ(10, readEntities->size());
+    ASSERT_EQ(savedPositions, readEntities->getPositions().x);
+}
+
+TEST(Simulation, RejectsForeignSnapshot) {
+    CountingModel model(0);
+    CountingModel otherModel(0);
+    tt::Simulation simulation;
+    tt::Simulation other;
+    for (auto* sim : {&simulation, &other}) {
+        sim->setClockMode(tt::Simulation::FreeRunning);
+    }
+    simulation.addModel(model);
+    other.addModel(otherModel);
+
+    tt::Snapshot snapshot;
+    ASSERT_FALSE(simulation.saveSnapshot(snapshot)); // not running yet
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(10)));
+    ASSERT_TRUE(other.runFor(std::chrono::milliseconds(10)));
+    ASSERT_TRUE(simulation.saveSnapshot(snapshot));
+    ASSERT_FALSE(other.restoreSnapshot(snapshot));
+    ASSERT_FALSE(other.restoreSnapshot(tt::Snapshot()));
+}
+
+TEST(Simulation, FailedSnapshotHasNoState) {
+    class UnsavableModel final : public tt::Model {
+    public:
+        UnsavableModel() :
+            Model("Unsavable", 0) {
+        }
+
+        bool run() override {
+            return true;
+        }
+
+        bool saveState(std::vector<uint8_t>&) const override {
+            return false;
+        }
+    };
+
+    tt::BusData<double> input(1, "Input");
+    tt::BusData<int> runs(0, "Runs", tt::BusDataBase::DoubleBuffered);
+    IntegratingModel model(input, runs);
+    UnsavableModel unsavable;
+    tt::Simulation simulation;
+    simulation.setClockMode(tt::Simulation::FreeRunning);
+    simulation.addModel(model);
+    simulation.addModel(unsavable);
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(10)));
+
+    tt::Snapshot snapshot;
+    ASSERT_EQ(0, snapshot.getSize());
+    ASSERT_FALSE(simulation.saveSnapshot(snapshot));
+    ASSERT_TRUE(snapshot.empty());
+    ASSERT_GT(snapshot.getSize(), 0); // the bus data saved before the failure
+    ASSERT_FALSE(simulation.restoreSnapshot(snapshot));
+}
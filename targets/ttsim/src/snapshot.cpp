@@ -0,0 +1,18 @@
+#include "TT/snapshot.h"
+
+bool tt::Snapshot::empty() const {
+    return owner_ == nullptr;
+}
+
+std::chrono::nanoseconds tt::Snapshot::getSimulationTime() const {
+    return simulationTime_;
+}
+
+size_t tt::Snapshot::getSize() const {
+    size_t size = 0;
+    for (const auto& segment : segments_) {
+        // A segment is empty after a failed save
+        size += segment.data != nullptr ? segment.data->size() : 0;
+    }
+    return size;
+}
@@ -0,0 +1,218 @@
+#include "TT/spatial_grid.h"
+
+#include <cmath>
+
+namespace {
+    /// Cell coordinates are packed into 21 bits per axis, which covers the earth with cells down to a few meters
+    constexpr int64_t cellBits = 21;
+    constexpr int64_t cellOffset = int64_t(1) << (cellBits - 1);
+    constexpr uint64_t cellMask = (uint64_t(1) << cellBits) - 1;
+}
+
+tt::SpatialGrid::SpatialGrid(const double cellSize) :
+    cellSize_(cellSize),
+    size_(0),
+    synchronisedRevision_(0),
+    synchronisePass_(0) {
+}
+
+void tt::SpatialGrid::update(const EntityHandle handle, const Eigen::Vector3d& position) {
+    if (handle.slot >= entries_.size()) {
+        entries_.resize(handle.slot + 1);
+    }
+    Entry& entry = entries_[handle.slot];
+    const CellKey cell = cellOf(position);
+
+    if (entry.present && entry.generation == handle.generation && entry.cell == cell) {
+        return;
+    }
+    if (entry.present) {
+        // Either the entity changed cell, or the slot is now used by a different entity
+        removeFromCell(entry);
+    }
+    else {
+        ++size_;
+    }
+
+    std::vector<EntityHandle>& handles = cells_[cell];
+    entry.generation = handle.generation;
+    entry.present = true;
+    entry.cell = cell;
+    entry.indexInCell = static_cast<uint32_t>(handles.size());
+    handles.push_back(handle);
+}
+
+bool tt::SpatialGrid::remove(const EntityHandle handle) {
+    if (handle.slot >= entries_.size()) {
+        return false;
+    }
+    Entry& entry = entries_[handle.slot];
+    if (!entry.present || entry.generation != handle.generation) {
+        return false;
+    }
+    removeFromCell(entry);
+    entry.present = false;
+    --size_;
+    return true;
+}
+
+void tt::SpatialGrid::clear() {
+    cells_.clear();
+    entries_.clear();
+    size_ = 0;
+}
+
+void tt::SpatialGrid::synchronise(const EntityStore& entities) {
+    if (entities.getRevision() == synchronisedRevision_) {
+        return;
+    }
+
+    // Catch up from the change set when it covers everything since the last synchronisation, which only visits the
+    // entities which changed unless every position may have changed
+    const EntityChangeSet& changes = entities.getChanges();
+    if (changes.covers(synchronisedRevision_)) {
+        const auto positions = entities.getPositions();
+        const bool allPositions = (changes.getFieldsOfAll(synchronisedRevision_) & PositionField) != 0;
+        changes.forEachSince(synchronisedRevision_, [&](const EntityChange& change) {
+            if (change.kind == EntityChange::Removed) {
+                remove(change.handle);
+            }
+            else if (!allPositions && (change.fields & PositionField) != 0) {
+                const size_t i = entities.indexOf(change.handle);
+                update(change.handle, {positions.x[i], positions.y[i], positions.z[i]});
+            }
+        });
+        if (allPositions) {
+            for (size_t i = 0; i < entities.size(); ++i) {
+                update(entities.handleAt(i), {positions.x[i], positions.y[i], positions.z[i]});
+            }
+        }
+        synchronisedRevision_ = entities.getRevision();
+        return;
+    }
+
+    ++synchronisePass_;
+    const auto positions = entities.getPositions();
+    for (size_t i = 0; i < entities.size(); ++i) {
+        const EntityHandle handle = entities.handleAt(i);
+        update(handle, {positions.x[i], positions.y[i], positions.z[i]});
+        entries_[handle.slot].lastSeen = synchronisePass_;
+    }
+
+    if (size_ != entities.size()) {
+        for (uint32_t slot = 0; slot < entries_.size(); ++slot) {
+            if (entries_[slot].present && entries_[slot].lastSeen != synchronisePass_) {
+                remove({slot, entries_[slot].generation});
+            }
+        }
+    }
+    synchronisedRevision_ = entities.getRevision();
+}
+
+uint64_t tt::SpatialGrid::getSynchronisedRevision() const {
+    return synchronisedRevision_;
+}
+
+void tt::SpatialGrid::queryCone(const Eigen::Vector3d& apex, const Eigen::Vector3d& axis, const double halfAngle,
+                                const double range, std::vector<EntityHandle>& result) const {
+    const double cellRadius = cellSize_ * std::sqrt(3.0) * 0.5;
+    const bool directional = halfAngle < M_PI_2;
+    const double sinHalfAngle = std::sin(halfAngle);
+    const double cosHalfAngle = std::cos(halfAngle);
+
+    forEachCellNear(apex, range, [&](const CellKey cell, const std::vector<EntityHandle>& handles) {
+        // Test the bounding sphere of the cell against the range and the cone
+        const Eigen::Vector3d offset = cellCenter(cell) - apex;
+        const double distance = offset.norm();
+        if (distance - cellRadius > range) {
+            return;
+        }
+        if (directional && distance > cellRadius) {
+            const double along = offset.dot(axis);
+            const double across = (offset - along * axis).norm();
+            // Distance of the cell center from the cone surface, negative inside the cone
+            if (across * cosHalfAngle - along * sinHalfAngle > cellRadius) {
+                return;
+            }
+        }
+        result.insert(result.end(), handles.begin(), handles.end());
+    });
+}
+
+void tt::SpatialGrid::querySphere(const Eigen::Vector3d& center, const double radius,
+                                  std::vector<EntityHandle>& result) const {
+    const double cellRadius = cellSize_ * std::sqrt(3.0) * 0.5;
+    forEachCellNear(center, radius, [&](const CellKey cell, const std::vector<EntityHandle>& handles) {
+        if ((cellCenter(cell) - center).norm() - cellRadius <= radius) {
+            result.insert(result.end(), handles.begin(), handles.end());
+        }
+    });
+}
+
+size_t tt::SpatialGrid::size() const {
+    return size_;
+}
+
+double tt::SpatialGrid::getCellSize() const {
+    return cellSize_;
+}
+
+tt::SpatialGrid::CellKey tt::SpatialGrid::cellOf(const Eigen::Vector3d& position) const {
+    return packCell(static_cast<int64_t>(std::floor(position.x() / cellSize_)),
+                    static_cast<int64_t>(std::floor(position.y() / cellSize_)),
+                    static_cast<int64_t>(std::floor(position.z() / cellSize_)));
+}
+
+Eigen::Vector3d tt::SpatialGrid::cellCenter(const CellKey cell) const {
+    const auto unpack = [cell](const int64_t shift) {
+        return static_cast<double>(static_cast<int64_t>((cell >> shift) & cellMask) - cellOffset) + 0.5;
+    };
+    return Eigen::Vector3d(unpack(2 * cellBits), unpack(cellBits), unpack(0)) * cellSize_;
+}
+
+tt::SpatialGrid::CellKey tt::SpatialGrid::packCell(const int64_t x, const int64_t y, const int64_t z) {
+    return (static_cast<uint64_t>(x + cellOffset) & cellMask) << (2 * cellBits) |
+        (static_cast<uint64_t>(y + cellOffset) & cellMask) << cellBits |
+        (static_cast<uint64_t>(z + cellOffset) & cellMask);
+}
+
+void tt::SpatialGrid::removeFromCell(const Entry& entry) {
+    const auto cell = cells_.find(entry.cell);
+    std::vector<EntityHandle>& handles = cell->second;
+    const EntityHandle moved = handles.back();
+    handles[entry.indexInCell] = moved;
+    entries_[moved.slot].indexInCell = entry.indexInCell;
+    handles.pop_back();
+    if (handles.empty()) {
+        cells_.erase(cell);
+    }
+}
+
+template <typename Visitor>
+void tt::SpatialGrid::forEachCellNear(const Eigen::Vector3d& center, const double radius, Visitor&& visit) const {
+    const Eigen::Vector3d low = ((center.array() - radius) / cellSize_).floor();
+    const Eigen::Vector3d high = ((center.array() + radius) / cellSize_).floor();
+    const Eigen::Vector3d extent = high - low + Eigen::Vector3d::Ones();
+
+    // For large volumes it is cheaper to test every occupied cell than to look up every cell in the volume
+    if (extent.prod() > static_cast<double>(cells_.size())) {
+        for (const auto& [cell, handles] : cells_) {
+            const Eigen::Vector3d index = (cellCenter(cell) / cellSize_).array().floor();
+            if ((index.array() >= low.array()).all() && (index.array() <= high.array()).all()) {
+                visit(cell, handles);
+            }
+        }
+        return;
+    }
+
+    for (auto x = static_cast<int64_t>(low.x()); x <= static_cast<int64_t>(high.x()); ++x) {
+        for (auto y = static_cast<int64_t>(low.y()); y <= static_cast<int64_t>(high.y()); ++y) {
+            for (auto z = static_cast<int64_t>(low.z()); z <= static_cast<int64_t>(high.z()); ++z) {
+                const auto cell = cells_.find(packCell(x, y, z));
+                if (cell != cells_.end()) {
+                    visit(cell->first, cell->second);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "TT/spatial_grid.h"
+
+namespace {
+    tt::rpr_fom::PhysicalEntity entityAt(const double x, const double y, const double z) {
+        tt::rpr_fom::PhysicalEntity entity;
+        entity.Spatial.SpatialRVW.WorldLocation = {x, y, z};
+        return entity;
+    }
+
+    bool containsHandle(const std::vector<tt::EntityHandle>& handles, const tt::EntityHandle handle) {
+        return std::find(handles.begin(), handles.end(), handle) != handles.end();
+    }
+}
+
+TEST(SpatialGrid, SynchroniseTracksStore) {
+    tt::EntityStore store;
+    const auto near = store.add(entityAt(100, 0, 0));
+    const auto far = store.add(entityAt(50000, 0, 0));
+
+    tt::SpatialGrid grid(1000);
+    grid.synchronise(store);
+    ASSERT_EQ(2, grid.size());
+    ASSERT_EQ(store.getRevision(), grid.getSynchronisedRevision());
+
+    std::vector<tt::EntityHandle> found;
+    grid.querySphere({0, 0, 0}, 500, found);
+    ASSERT_TRUE(containsHandle(found, near));
+    ASSERT_FALSE(containsHandle(found, far));
+
+    // Move the far entity close and remove the near one
+    store.getPositions().x[store.indexOf(far)] = -200;
+    store.remove(near);
+    grid.synchronise(store);
+    ASSERT_EQ(1, grid.size());
+
+    found.clear();
+    grid.querySphere({0, 0, 0}, 500, found);
+    ASSERT_FALSE(containsHandle(found, near));
+    ASSERT_TRUE(containsHandle(found, far));
+}
+
+TEST(SpatialGrid, ConeQueryCullsByDirectionAndRange) {
+    tt::EntityStore store;
+    const auto ahead = store.add(entityAt(10000, 100, 0));
+    const auto behind = store.add(entityAt(-10000, 0, 0));
+    const auto aside = store.add(entityAt(0, 10000, 0));
+    const auto beyond = store.add(entityAt(40000, 0, 0));
+
+    tt::SpatialGrid grid(1000);
+    grid.synchronise(store);
+
+    std::vector<tt::EntityHandle> found;
+    grid.queryCone({0, 0, 0}, {1, 0, 0}, 0.3, 20000, found);
+    ASSERT_TRUE(containsHandle(found, ahead));
+    ASSERT_FALSE(containsHandle(found, behind));
+    ASSERT_FALSE(containsHandle(found, aside));
+    ASSERT_FALSE(containsHandle(found, beyond));
+
+    // A half angle of 90 degrees or more only culls by range
+    found.clear();
+    grid.queryCone({0, 0, 0}, {1, 0, 0}, M_PI, 20000, found);
+    ASSERT_EQ(3, found.size());
+}
+
+TEST(SpatialGrid, SynchroniseAppliesChangeSet) {
+    tt::EntityStore store;
+    std::vector<tt::EntityHandle> handles;
+    for (int i = 0; i < 100; ++i) {
+        handles.push_back(store.add(entityAt(i * 500, 0, 0)));
+    }
+    tt::SpatialGrid grid(1000);
+    grid.synchronise(store);
+
+    // A frame of churn, applied from the change set, leaves the grid as a synchronisation from scratch would
+    for (int frame = 0; frame < 3; ++frame) {
+        for (int i = 0; i < 10; ++i) {
+            const size_t victim = (frame * 31 + i * 7) % handles.size();
+            ASSERT_TRUE(store.remove(handles[victim]));
+            handles[victim] = store.add(entityAt(-i * 800.0, 1000, 0));
+            ASSERT_TRUE(store.update(handles[(victim + 1) % handles.size()], entityAt(i * 900.0, -2000, 0)));
+        }
+        if (frame == 2) {
+            store.getPositions().y[0] = 5000;
+        }
+        ASSERT_TRUE(store.getChanges().covers(grid.getSynchronisedRevision()));
+        grid.synchronise(store);
+
+        tt::SpatialGrid reference(1000);
+        reference.synchronise(tt::EntityStore(store));
+        ASSERT_EQ(reference.size(), grid.size());
+        for (const tt::EntityHandle handle : handles) {
+            const size_t i = store.indexOf(handle);
+            const auto positions = std::as_const(store).getPositions();
+            const Eigen::Vector3d position(positions.x[i], positions.y[i], positions.z[i]);
+            std::vector<tt::EntityHandle> found;
+            grid.querySphere(position, 1, found);
+            ASSERT_TRUE(containsHandle(found, handle));
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#include "TT/thread_pool.h"
+
+#include <chrono>
+
+namespace {
+    /// index of the worker queue owned by the current thread, if the current thread is a worker of a pool
+    thread_local const tt::ThreadPool* currentPool = nullptr;
+    thread_local size_t currentWorker = 0;
+
+    /// upper bound for how long an idle worker sleeps before checking the queues again
+    constexpr std::chrono::milliseconds idleTimeout(100);
+}
+
+tt::ThreadPool::ThreadPool(const size_t workerCount) :
+    queuedTasks_(0),
+    nextQueue_(0),
+    stopping_(false) {
+    const size_t count = workerCount > 0 ? workerCount : 1;
+    for (size_t i = 0; i < count; ++i) {
+        queues_.emplace_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < count; ++i) {
+        workers_.emplace_back(&ThreadPool::workerMain, this, i);
+    }
+}
+
+tt::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wakeUp_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void tt::ThreadPool::submit(Task task) {
+    const size_t index = currentPool == this
+        ? currentWorker
+        : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard lock(queues_[index]->mutex);
+        queues_[index]->tasks.emplace_back(std::move(task));
+    }
+    queuedTasks_.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders the notification after any worker which has checked queuedTasks_ and is about to sleep
+    { std::lock_guard lock(sleepMutex_); }
+    wakeUp_.notify_one();
+}
+
+void tt::ThreadPool::waitUntil(const std::function<bool()>& done) {
+    Task task;
+    while (!done()) {
+        if (popOrSteal(queues_.size(), task)) {
+            task();
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+size_t tt::ThreadPool::getWorkerCount() const {
+    return workers_.size();
+}
+
+void tt::ThreadPool::workerMain(const size_t index) {
+    currentPool = this;
+    currentWorker = index;
+
+    Task task;
+    while (true) {
+        if (popOrSteal(index, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock lock(sleepMutex_);
+        wakeUp_.wait_for(lock, idleTimeout, [this] {
+            return stopping_ || queuedTasks_.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping_) {
+            return;
+        }
+    }
+}
+
+bool tt::ThreadPool::popOrSteal(const size_t index, Task& task) {
+    if (queuedTasks_.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    if (index < queues_.size()) {
+        WorkQueue& queue = *queues_[index];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            queuedTasks_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    for (size_t offset = 1; offset <= queues_.size(); ++offset) {
+        WorkQueue& victim = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queuedTasks_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,108 @@
+#include "TT/timing_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+tt::TimingStatistics::TimingStatistics() {
+    reset();
+}
+
+void tt::TimingStatistics::record(const Duration duration, const Duration budget) {
+    const auto nanoseconds = static_cast<uint64_t>(std::max(duration.count(), Duration::rep(0)));
+
+    buckets_[getBucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    total_.fetch_add(nanoseconds, std::memory_order_relaxed);
+    if (duration > budget) {
+        overruns_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t minimum = minimum_.load(std::memory_order_relaxed);
+    while (nanoseconds < minimum && !minimum_.compare_exchange_weak(minimum, nanoseconds, std::memory_order_relaxed)) {
+    }
+    uint64_t maximum = maximum_.load(std::memory_order_relaxed);
+    while (nanoseconds > maximum && !maximum_.compare_exchange_weak(maximum, nanoseconds, std::memory_order_relaxed)) {
+    }
+
+    // Counted last, so readers which see the count also see the other fields of the record
+    count_.fetch_add(1, std::memory_order_release);
+}
+
+tt::TimingStatistics::Summary tt::TimingStatistics::getSummary() const {
+    const uint64_t count = count_.load(std::memory_order_acquire);
+    if (count == 0) {
+        return {0, Duration(0), Duration(0), Duration(0), Duration(0), 0};
+    }
+    return {
+        count,
+        Duration(minimum_.load(std::memory_order_relaxed)),
+        Duration(total_.load(std::memory_order_relaxed) / count),
+        getPercentile(0.99),
+        Duration(maximum_.load(std::memory_order_relaxed)),
+        overruns_.load(std::memory_order_relaxed)
+    };
+}
+
+tt::TimingStatistics::Duration tt::TimingStatistics::getPercentile(const double fraction) const {
+    const uint64_t count = count_.load(std::memory_order_acquire);
+    if (count == 0) {
+        return Duration(0);
+    }
+
+    const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * count)));
+    // The extremes are known exactly
+    if (rank == 1) {
+        return Duration(minimum_.load(std::memory_order_relaxed));
+    }
+    if (rank >= count) {
+        return Duration(maximum_.load(std::memory_order_relaxed));
+    }
+
+    uint64_t seen = 0;
+    size_t bucket = 0;
+    for (; bucket < bucketCount - 1; ++bucket) {
+        seen += buckets_[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            break;
+        }
+    }
+
+    // Keeps the bucket midpoint from exceeding the range actually recorded
+    const uint64_t value = std::clamp(getBucketValue(bucket),
+                                      minimum_.load(std::memory_order_relaxed),
+                                      maximum_.load(std::memory_order_relaxed));
+    return Duration(value);
+}
+
+void tt::TimingStatistics::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    total_.store(0, std::memory_order_relaxed);
+    minimum_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    maximum_.store(0, std::memory_order_relaxed);
+    overruns_.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_release);
+}
+
+size_t tt::TimingStatistics::getBucket(const uint64_t nanoseconds) {
+    if (nanoseconds < subBucketCount) {
+        return nanoseconds;
+    }
+    // Position of the highest set bit selects the logarithmic bucket, the next bits the linear sub bucket
+    unsigned exponent = 63;
+    while ((nanoseconds >> exponent) == 0) {
+        --exponent;
+    }
+    const uint64_t subBucket = (nanoseconds >> (exponent - subBucketBits)) & (subBucketCount - 1);
+    return (exponent - subBucketBits + 1) * subBucketCount + subBucket;
+}
+
+uint64_t tt::TimingStatistics::getBucketValue(const size_t bucket) {
+    if (bucket < subBucketCount) {
+        return bucket;
+    }
+    const unsigned shift = static_cast<unsigned>(bucket / subBucketCount) - 1;
+    const uint64_t lowest = (subBucketCount + bucket % subBucketCount) << shift;
+    return lowest + ((uint64_t(1) << shift) >> 1);
+}
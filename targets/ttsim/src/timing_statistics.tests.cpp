@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "TT/timing_statistics.h"
+
+using namespace std::chrono_literals;
+
+TEST(TimingStatistics, EmptySummaryIsZero) {
+    const tt::TimingStatistics statistics;
+    const auto summary = statistics.getSummary();
+    ASSERT_EQ(0, summary.count);
+    ASSERT_EQ(0ns, summary.maximum);
+    ASSERT_EQ(0ns, statistics.getPercentile(0.5));
+}
+
+TEST(TimingStatistics, SummarisesRecordedDurations) {
+    tt::TimingStatistics statistics;
+    for (int i = 1; i <= 1000; ++i) {
+        statistics.record(std::chrono::microseconds(i), 900us);
+    }
+
+    const auto summary = statistics.getSummary();
+    ASSERT_EQ(1000, summary.count);
+    ASSERT_EQ(1us, summary.minimum);
+    ASSERT_EQ(1000us, summary.maximum);
+    ASSERT_EQ(500500ns, summary.average);
+    ASSERT_EQ(100, summary.overruns);
+
+    // Percentiles are exact to within the width of a sub bucket
+    ASSERT_NEAR(990000, summary.percentile99.count(), 990000 / 16);
+    ASSERT_NEAR(500000, statistics.getPercentile(0.5).count(), 500000 / 16);
+    ASSERT_EQ(1us, statistics.getPercentile(0));
+    ASSERT_EQ(1000us, statistics.getPercentile(1));
+
+    statistics.reset();
+    ASSERT_EQ(0, statistics.getSummary().count);
+}
+
+TEST(TimingStatistics, RecordsConcurrently) {
+    tt::TimingStatistics statistics;
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&statistics, thread] {
+            for (int i = 0; i < 10000; ++i) {
+                statistics.record(std::chrono::nanoseconds(thread * 10000 + i + 1), 1s);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto summary = statistics.getSummary();
+    ASSERT_EQ(40000, summary.count);
+    ASSERT_EQ(1ns, summary.minimum);
+    ASSERT_EQ(40000ns, summary.maximum);
+    ASSERT_EQ(0, summary.overruns);
+}
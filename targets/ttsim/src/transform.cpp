@@ -1,13 +1,36 @@
 #include "TT/transform.h"
 
+#include <atomic>
+
+namespace {
+  /// Source of world transform stamps. Stamps are unique over all Transforms, so a copied or reassigned parent can
+  /// never be mistaken for the one a child cache was computed from.
+  std::atomic<uint64_t> nextWorldStamp(1);
+
+  /// Tolerance used to decide whether a supplied matrix is a pure rotation
+  constexpr double rigidPrecision = 1e-12;
+}
+
 tt::Transform::Transform() :
   xform_(Eigen::Matrix4d::Identity()),
-  parent_(nullptr) {
+  parent_(nullptr),
+  rigid_(true),
+  worldValid_(false),
+  inverseValid_(false),
+  worldRigid_(true),
+  cachedParentStamp_(0),
+  worldStamp_(0) {
 }
 
 tt::Transform::Transform(const double x, const double y, const double z, const double roll, const double pitch,
                          const double yaw, const Transform* parent) :
-  parent_(parent) {
+  parent_(parent),
+  rigid_(true),
+  worldValid_(false),
+  inverseValid_(false),
+  worldRigid_(true),
+  cachedParentStamp_(0),
+  worldStamp_(0) {
   xform_ = Eigen::Translation3d(x, y, z) *
     Eigen::Matrix3d(
       Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()) *
@@ -22,23 +45,60 @@ tt::Transform::Transform(const Eigen::Vector3d& translation, const Eigen::Vector
 
 tt::Transform::Transform(const Eigen::Transform<double, 3, Eigen::Affine>& xform, const Transform* parent) :
   xform_(xform),
-  parent_(parent) {
+  parent_(parent),
+  rigid_(xform.linear().isUnitary(rigidPrecision)),
+  worldValid_(false),
+  inverseValid_(false),
+  worldRigid_(false),
+  cachedParentStamp_(0),
+  worldStamp_(0) {
 }
 
 tt::Transform tt::Transform::toLocalTransform(const Transform& worldSpaceTransform) const {
-  return Transform(xform_.inverse() * worldSpaceTransform.xform_);
+  return Transform(worldInverseXform() * worldSpaceTransform.xform_);
 }
 
 Eigen::Vector3d tt::Transform::toLocalVector(const Eigen::Vector3d& worldSpaceVector) const {
-  const Eigen::Vector4d inVector{worldSpaceVector.x(), worldSpaceVector.y(), worldSpaceVector.z(), 0};
-  return (xform_.inverse() * inVector).block<3, 1>(0, 0);
+  return worldInverseXform().linear() * worldSpaceVector;
+}
+
+Eigen::Vector3d tt::Transform::toLocalPosition(const Eigen::Vector3d& worldSpacePosition) const {
+  return worldInverseXform() * worldSpacePosition;
+}
+
+void tt::Transform::toLocalPositions(const Eigen::Ref<const Eigen::Matrix3Xd>& worldSpacePositions,
+                                     Eigen::Ref<Eigen::Matrix3Xd> localSpacePositions) const {
+  const Affine& inverse = worldInverseXform();
+  localSpacePositions.noalias() = inverse.linear() * worldSpacePositions;
+  localSpacePositions.colwise() += inverse.translation();
+}
+
+void tt::Transform::toLocalVectors(const Eigen::Ref<const Eigen::Matrix3Xd>& worldSpaceVectors,
+                                   Eigen::Ref<Eigen::Matrix3Xd> localSpaceVectors) const {
+  localSpaceVectors.noalias() = worldInverseXform().linear() * worldSpaceVectors;
+}
+
+bool tt::Transform::isRigid() const {
+  return rigid_;
 }
 
 tt::Transform tt::Transform::toWorldTransform() const {
   if (parent_ == nullptr) {
     return *this;
   }
-  return Transform(parent_->toWorldTransform().xform_ * xform_);
+  return Transform(worldXform());
+}
+
+tt::Transform tt::Transform::toWorldTransform(const Transform& localSpaceTransform) const {
+  return Transform(worldXform() * localSpaceTransform.xform_);
+}
+
+Eigen::Vector3d tt::Transform::toWorldVector(const Eigen::Vector3d& localSpaceVector) const {
+  return worldXform().linear() * localSpaceVector;
+}
+
+Eigen::Vector3d tt::Transform::toWorldPosition(const Eigen::Vector3d& localSpacePosition) const {
+  return worldXform() * localSpacePosition;
 }
 
 Eigen::Vector3d tt::Transform::getLocalTranslation() const {
@@ -47,6 +107,7 @@ Eigen::Vector3d tt::Transform::getLocalTranslation() const {
 
 void tt::Transform::setParent(const Transform* parent) {
   this->parent_ = parent;
+  invalidate();
 }
 
 const tt::Transform* tt::Transform::getParent() const {
@@ -54,11 +115,15 @@ const tt::Transform* tt::Transform::getParent() const {
 }
 
 Eigen::Transform<double, 3, Eigen::Affine>& tt::Transform::data() {
+  // The caller may modify the transform through the reference at any time
+  rigid_ = false;
+  invalidate();
   return xform_;
 }
 
 void tt::Transform::setLocalTranslation(const Eigen::Vector3d& translation) {
   xform_.translation() = translation;
+  invalidate();
 }
 
 Eigen::Matrix3d tt::Transform::getLocalRotationMatrix() const {
@@ -71,6 +136,8 @@ Eigen::Vector3d tt::Transform::getLocalRotationEuler() const {
 
 void tt::Transform::setLocalRotationMatrix(const Eigen::Matrix3d& rotation) {
   xform_.matrix().block<3, 3>(0, 0) = rotation;
+  rigid_ = rotation.isUnitary(rigidPrecision);
+  invalidate();
 }
 
 void tt::Transform::setLocalRotationEuler(const Eigen::Vector3d& rotation) {
@@ -78,16 +145,65 @@ void tt::Transform::setLocalRotationEuler(const Eigen::Vector3d& rotation) {
     Eigen::AngleAxisd(rotation.z(), Eigen::Vector3d::UnitZ()) *
     Eigen::AngleAxisd(rotation.y(), Eigen::Vector3d::UnitY()) *
     Eigen::AngleAxisd(rotation.x(), Eigen::Vector3d::UnitX()));
+  rigid_ = true;
+  invalidate();
 }
 
 Eigen::Vector3d tt::Transform::getWorldTranslation() const {
-  return toWorldTransform().getLocalTranslation();
+  return worldXform().translation();
 }
 
 Eigen::Matrix3d tt::Transform::getWorldRotationMatrix() const {
-  return toWorldTransform().getLocalRotationMatrix();
+  return worldXform().rotation();
 }
 
 Eigen::Vector3d tt::Transform::getWorldRotationEuler() const {
-  return toWorldTransform().getLocalRotationEuler();
+  return worldXform().rotation().eulerAngles(2, 1, 0).reverse();
+}
+
+uint64_t tt::Transform::updateWorldCache() const {
+  if (parent_ == nullptr) {
+    // The world transform of a root is its local transform, only the stamp has to follow changes
+    if (!worldValid_) {
+      worldStamp_ = nextWorldStamp.fetch_add(1, std::memory_order_relaxed);
+      worldValid_ = true;
+      inverseValid_ = false;
+      worldRigid_ = rigid_;
+    }
+    return worldStamp_;
+  }
+
+  const uint64_t parentStamp = parent_->updateWorldCache();
+  if (!worldValid_ || parentStamp != cachedParentStamp_) {
+    worldCache_ = parent_->cachedWorldXform() * xform_;
+    worldRigid_ = rigid_ && parent_->worldRigid_;
+    cachedParentStamp_ = parentStamp;
+    worldStamp_ = nextWorldStamp.fetch_add(1, std::memory_order_relaxed);
+    worldValid_ = true;
+    inverseValid_ = false;
+  }
+  return worldStamp_;
+}
+
+const tt::Transform::Affine& tt::Transform::cachedWorldXform() const {
+  return parent_ == nullptr ? xform_ : worldCache_;
+}
+
+const tt::Transform::Affine& tt::Transform::worldXform() const {
+  updateWorldCache();
+  return cachedWorldXform();
+}
+
+const tt::Transform::Affine& tt::Transform::worldInverseXform() const {
+  const Affine& world = worldXform();
+  if (!inverseValid_) {
+    // The inverse of a rotation is its transpose, which is far cheaper than a general 4x4 inverse
+    worldInverseCache_ = world.inverse(worldRigid_ ? Eigen::Isometry : Eigen::Affine);
+    inverseValid_ = true;
+  }
+  return worldInverseCache_;
+}
+
+void tt::Transform::invalidate() {
+  worldValid_ = false;
 }
@@ -77,3 +77,85 @@ TEST(Translation, SetLocalTranslation) {
     parent.setLocalTranslation({2, 5, 9});
     ASSERT_EQ(Eigen::Vector3d(2, 5, 9), parent.getLocalTranslation());
 }
+
+TEST(Parent, WorldCacheFollowsParentChanges) {
+    tt::Transform parent(5, 10, 15, 0, 0, 0);
+    tt::Transform child(2, 3, 4, 0, 0, 0, &parent);
+    const tt::Transform grandChild(1, 1, 1, 0, 0, 0, &child);
+
+    ASSERT_EQ(Eigen::Vector3d(8, 14, 20), grandChild.getWorldTranslation());
+    ASSERT_EQ(Eigen::Vector3d(8, 14, 20), grandChild.getWorldTranslation());
+
+    parent.setLocalTranslation({0, 0, 0});
+    ASSERT_EQ(Eigen::Vector3d(3, 4, 5), grandChild.getWorldTranslation());
+
+    child.setLocalTranslation({0, 0, 0});
+    ASSERT_EQ(Eigen::Vector3d(1, 1, 1), grandChild.getWorldTranslation());
+
+    const tt::Transform other(100, 0, 0, 0, 0, 0);
+    child.setParent(&other);
+    ASSERT_EQ(Eigen::Vector3d(101, 1, 1), grandChild.getWorldTranslation());
+}
+
+TEST(Parent, ToLocalTransformUsesWorldTransform) {
+    const tt::Transform parent(0, 0, 10, 0, 0, M_PI_2);
+    const tt::Transform child(10, 0, 0, 0, 0, 0, &parent);
+    const tt::Transform target(0, 20, 10, 0, 0, 0);
+
+    // The child sits at {0, 10, 10} looking along world Y, so the target is 10 meters ahead of it
+    const Eigen::Vector3d offset = child.toLocalTransform(target).getLocalTranslation();
+    ASSERT_NEAR(10, offset.x(), tolerance);
+    ASSERT_NEAR(0, offset.y(), tolerance);
+    ASSERT_NEAR(0, offset.z(), tolerance);
+}
+
+TEST(Conversion, WorldAndLocalPositionsRoundTrip) {
+    const tt::Transform parent(100, -50, 20, 0.3, -0.2, 1.1);
+    const tt::Transform child(5, 1, -2, -0.4, 0.1, 0.2, &parent);
+    const Eigen::Vector3d local(12, -7, 3);
+
+    const Eigen::Vector3d world = child.toWorldPosition(local);
+    const Eigen::Vector3d roundTrip = child.toLocalPosition(world);
+    ASSERT_NEAR(local.x(), roundTrip.x(), tolerance);
+    ASSERT_NEAR(local.y(), roundTrip.y(), tolerance);
+    ASSERT_NEAR(local.z(), roundTrip.z(), tolerance);
+
+    const Eigen::Vector3d worldVector = child.toWorldVector(local);
+    ASSERT_NEAR(local.norm(), worldVector.norm(), tolerance);
+    ASSERT_TRUE(child.toLocalVector(worldVector).isApprox(local, tolerance));
+
+    const tt::Transform worldXform = child.toWorldTransform(tt::Transform(local, Eigen::Vector3d::Zero()));
+    ASSERT_TRUE(worldXform.getLocalTranslation().isApprox(world, tolerance));
+}
+
+TEST(Conversion, BatchMatchesSingle) {
+    const tt::Transform parent(100, -50, 20, 0.3, -0.2, 1.1);
+    const tt::Transform child(5, 1, -2, -0.4, 0.1, 0.2, &parent);
+
+    Eigen::Matrix3Xd world = Eigen::Matrix3Xd::Random(3, 64) * 1000;
+    Eigen::Matrix3Xd positions(3, 64);
+    Eigen::Matrix3Xd vectors(3, 64);
+    child.toLocalPositions(world, positions);
+    child.toLocalVectors(world, vectors);
+
+    for (Eigen::Index i = 0; i < world.cols(); ++i) {
+        ASSERT_TRUE(positions.col(i).isApprox(child.toLocalPosition(world.col(i)), tolerance));
+        ASSERT_TRUE(vectors.col(i).isApprox(child.toLocalVector(world.col(i)), tolerance));
+    }
+}
+
+TEST(Conversion, RigidInverseMatchesGeneralInverse) {
+    tt::Transform rigid(100, -50, 20, 0.3, -0.2, 1.1);
+    ASSERT_TRUE(rigid.isRigid());
+
+    tt::Transform general(rigid.data());
+    general.data().linear() *= 2;
+    ASSERT_FALSE(general.isRigid());
+
+    const Eigen::Vector3d point(1, 2, 3);
+    const tt::Transform reference(100, -50, 20, 0.3, -0.2, 1.1);
+    ASSERT_TRUE(reference.toLocalPosition(point).isApprox(
+        Eigen::Vector3d((reference.toWorldTransform().data().matrix().inverse() * point.homogeneous()).head<3>()),
+        tolerance));
+    ASSERT_TRUE(general.toLocalPosition(general.toWorldPosition(point)).isApprox(point, tolerance));
+}
@@ -0,0 +1,338 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Eigen/Geometry>
+#include <TT/logging.h>
+#include <TT/simulation.h>
+#include <TT/thread_pool.h>
+#include "data.h"
+#include "model_dead_reckoning.h"
+#include "model_radar.h"
+#include "model_spatial_index.h"
+
+namespace tt::simship {
+  /// The engagement shared by all runs of a batch. Each run places its targets differently, drawn from its seed.
+  struct EngagementScenario {
+    /// simulated time each run lasts
+    std::chrono::nanoseconds duration = std::chrono::seconds(120);
+
+    /// base frame interval of each run, the rate at which targets are dead reckoned. Must divide the 100 ms frame
+    /// interval of the radar, so every echo is attributed to the frame of the radar which produced it.
+    std::chrono::microseconds frameInterval = std::chrono::milliseconds(100);
+
+    /// world location (meters) of the ownship, which holds its position during the engagement
+    Eigen::Vector3d ownshipPosition = Eigen::Vector3d::Zero();
+
+    /// number of targets in each run
+    uint32_t targetCount = 50;
+
+    /// targets start at a distance from the ownship drawn from this interval (meters)
+    double minimumTargetRange = 5e3;
+
+    double maximumTargetRange = 40e3;
+
+    /// targets start within a cone of this half angle (radian) around the world x axis, which is the boresight of the
+    /// radar of an unrotated ownship
+    double targetSectorHalfAngle = 0.5;
+
+    /// targets fly straight towards the ownship with a speed drawn from this interval (meters per second)
+    double minimumTargetSpeed = 100;
+
+    double maximumTargetSpeed = 300;
+  };
+
+  /// The radar parameters of a single run. Runs with the same seed place the same targets.
+  struct EngagementRun {
+    uint32_t index = 0;
+
+    uint64_t seed = 0;
+
+    double power = 1500; // watt
+
+    double gain = 1; // scalar
+
+    double minimumDetectableSignal = 9.0e-14; // watt
+  };
+
+  struct EngagementResult {
+    EngagementRun run;
+
+    /// number of echoes over all frames
+    uint32_t detectionCount = 0;
+
+    /// simulated seconds until the first echo, NaN without any echo
+    float firstDetectionTime = std::numeric_limits<float>::quiet_NaN();
+
+    /// longest range (meters) of the echoes in the frame of the first echo, NaN without any echo
+    float firstDetectionRange = std::numeric_limits<float>::quiet_NaN();
+
+    /// longest range (meters) of any echo, NaN without any echo
+    float maximumDetectionRange = std::numeric_limits<float>::quiet_NaN();
+
+    /// false if the simulation of the run failed, in which case the detections are incomplete
+    bool succeeded = false;
+  };
+
+  /// Executes a single engagement in its own simulation and channels, so any number of engagements may run
+  /// concurrently. The ownship is scripted rather than flown by the flight dynamics, which keeps a run free of the
+  /// JSBSim model load.
+  ///
+  /// \param scenario the engagement to run
+  /// \param run the radar parameters and the seed to place the targets with
+  /// \return the detections of the radar
+  inline EngagementResult runEngagement(const EngagementScenario& scenario, const EngagementRun& run) {
+    EngagementResult result;
+    result.run = run;
+
+    OwnshipChannel ownshipChannel;
+    EnvironmentChannel environmentChannel;
+    RadarChannel radarChannel;
+
+    *ownshipChannel.aircraftPosition.getWriteHandle() = scenario.ownshipPosition;
+    ownshipChannel.aircraftPosition.publish();
+    *radarChannel.power.getWriteHandle() = run.power;
+    *radarChannel.gain.getWriteHandle() = run.gain;
+    *radarChannel.minimumDetectableSignal.getWriteHandle() = run.minimumDetectableSignal;
+
+    std::mt19937_64 random(run.seed);
+    std::uniform_real_distribution<double> unit(0, 1);
+    EntityStore& targets = *environmentChannel.physicalEntities.getWriteHandle();
+    for (uint32_t i = 0; i < scenario.targetCount; ++i) {
+      // Uniformly distributed over the spherical cap of the sector
+      const double cosPolar = 1 - unit(random) * (1 - std::cos(scenario.targetSectorHalfAngle));
+      const double sinPolar = std::sqrt(1 - cosPolar * cosPolar);
+      const double azimuth = unit(random) * 2 * M_PI;
+      const Eigen::Vector3d direction(cosPolar, sinPolar * std::cos(azimuth), sinPolar * std::sin(azimuth));
+      const double range = scenario.minimumTargetRange +
+        unit(random) * (scenario.maximumTargetRange - scenario.minimumTargetRange);
+      const double speed = scenario.minimumTargetSpeed +
+        unit(random) * (scenario.maximumTargetSpeed - scenario.minimumTargetSpeed);
+      const Eigen::Vector3d position = scenario.ownshipPosition + direction * range;
+      const Eigen::Vector3f velocity = (-direction * speed).cast<float>();
+
+      rpr_fom::PhysicalEntity target;
+      target.EntityIdentifier.EntityNumber = static_cast<uint16_t>(i + 1);
+      target.Spatial.DeadReckoningAlgorithm = rpr_fom::DeadReckoningAlgorithmEnum8::DRM_FVW;
+      target.Spatial.SpatialRVW.WorldLocation = {position.x(), position.y(), position.z()};
+      target.Spatial.SpatialRVW.VelocityVector = {velocity.x(), velocity.y(), velocity.z()};
+      targets.add(target);
+    }
+
+    DeadReckoningModel deadReckoning(environmentChannel);
+    SpatialIndexModel spatialIndex(environmentChannel);
+    RadarModel radar(ownshipChannel, environmentChannel, radarChannel);
+
+    Simulation simulation;
+    simulation.setClockMode(Simulation::FreeRunning);
+    simulation.setBaseFrameInterval(scenario.frameInterval);
+    simulation.addModel(deadReckoning);
+    simulation.addModel(spatialIndex);
+    simulation.addModel(radar);
+
+    // One base frame at a time, so every echo is attributed to the frame which produced it. Without a frame interval
+    // a single attempt is made, which fails as simulated time cannot advance.
+    const int64_t frameCount = scenario.frameInterval.count() > 0 ? scenario.duration / scenario.frameInterval : 1;
+    std::vector<Echo> echoes(radarChannel.echoes.capacity());
+    for (int64_t frame = 0; frame < frameCount; ++frame) {
+      if (!simulation.runFor(scenario.frameInterval)) {
+        return result;
+      }
+
+      const size_t echoCount = radarChannel.echoes.pop(echoes.data(), echoes.size());
+      if (echoCount == 0) {
+        continue;
+      }
+      double frameRange = 0;
+      for (size_t i = 0; i < echoCount; ++i) {
+        frameRange = std::max(frameRange, echoes[i].range);
+      }
+      if (result.detectionCount == 0) {
+        result.firstDetectionTime = std::chrono::duration<float>(simulation.getSimulationTime()).count();
+        result.firstDetectionRange = static_cast<float>(frameRange);
+        result.maximumDetectionRange = static_cast<float>(frameRange);
+      }
+      result.maximumDetectionRange = std::max(result.maximumDetectionRange, static_cast<float>(frameRange));
+      result.detectionCount += static_cast<uint32_t>(echoCount);
+    }
+
+    result.succeeded = true;
+    return result;
+  }
+
+  /// Runs batches of independent engagements in parallel, e.g. to tune radar parameters over thousands of variations
+  /// within a single process.
+  ///
+  /// Results can be streamed to a compact binary file while the batch runs. The file starts with a 16 byte header of
+  /// the magic "TTMC" followed by the format version, the record size and the number of runs as little endian uint32.
+  /// Each run then appends a record of recordSize bytes in the order the runs complete, all little endian:
+  ///
+  /// | Offset | Type    | Field                   |
+  /// |--------|---------|-------------------------|
+  /// | 0      | uint64  | seed                    |
+  /// | 8      | float64 | power                   |
+  /// | 16     | float64 | gain                    |
+  /// | 24     | float64 | minimumDetectableSignal |
+  /// | 32     | uint32  | index                   |
+  /// | 36     | uint32  | detectionCount          |
+  /// | 40     | float32 | firstDetectionTime      |
+  /// | 44     | float32 | firstDetectionRange     |
+  /// | 48     | float32 | maximumDetectionRange   |
+  /// | 52     | uint8   | succeeded               |
+  /// | 53     |         | 3 bytes padding         |
+  class BatchRunner {
+  public:
+    static constexpr uint32_t fileVersion = 1;
+
+    static constexpr size_t headerSize = 16;
+
+    static constexpr size_t recordSize = 56;
+
+    /// \param workerCount number of threads executing runs. The thread calling run() also executes runs.
+    explicit BatchRunner(const size_t workerCount = std::thread::hardware_concurrency()) :
+      threadPool(workerCount) {
+    }
+
+    /// Derives the seed of a run from the seed of its batch, so neighbouring runs get unrelated random sequences.
+    ///
+    /// \param batchSeed the seed of the whole batch
+    /// \param index the index of the run within the batch
+    /// \return the seed of the run
+    static uint64_t getRunSeed(const uint64_t batchSeed, const uint32_t index) {
+      // SplitMix64
+      uint64_t z = batchSeed + (static_cast<uint64_t>(index) + 1) * 0x9e3779b97f4a7c15ull;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+      return z ^ (z >> 31);
+    }
+
+    /// Executes all runs and blocks until they completed.
+    ///
+    /// \param scenario the engagement shared by all runs
+    /// \param runs the radar parameters and seed of each run
+    /// \param output stream to write the results to as they complete, or nullptr. The stream is not closed.
+    /// \return the result of each run, in the order of the runs
+    std::vector<EngagementResult> run(const EngagementScenario& scenario, const std::vector<EngagementRun>& runs,
+                                      std::FILE* const output = nullptr) {
+      std::vector<EngagementResult> results(runs.size());
+      std::mutex outputMutex;
+      bool outputFailed = false;
+      if (output != nullptr) {
+        uint8_t header[headerSize] = {'T', 'T', 'M', 'C'};
+        writeLittleEndian(header + 4, fileVersion);
+        writeLittleEndian(header + 8, static_cast<uint32_t>(recordSize));
+        writeLittleEndian(header + 12, static_cast<uint32_t>(runs.size()));
+        outputFailed = std::fwrite(header, headerSize, 1, output) != 1;
+      }
+
+      std::atomic<size_t> completed(0);
+      for (size_t i = 0; i < runs.size(); ++i) {
+        threadPool.submit([&, i] {
+          results[i] = runEngagement(scenario, runs[i]);
+          if (!results[i].succeeded) {
+            log::error("Engagement run ", std::to_string(runs[i].index), " failed");
+          }
+          if (output != nullptr) {
+            uint8_t record[recordSize];
+            encode(results[i], record);
+            std::lock_guard lock(outputMutex);
+            outputFailed = outputFailed || std::fwrite(record, recordSize, 1, output) != 1;
+          }
+          completed.fetch_add(1, std::memory_order_release);
+        });
+      }
+      threadPool.waitUntil([&] {
+        return completed.load(std::memory_order_acquire) == runs.size();
+      });
+
+      if (outputFailed) {
+        log::error("Failed to write the engagement results");
+      }
+      return results;
+    }
+
+    /// Reads results written by run().
+    ///
+    /// \param input stream positioned at the start of the header
+    /// \param results receives the results in the order they were written
+    /// \return false if the stream is not a result file of this version or ends within a record
+    static bool readResults(std::FILE* const input, std::vector<EngagementResult>& results) {
+      uint8_t header[headerSize];
+      if (std::fread(header, headerSize, 1, input) != 1 || !std::equal(header, header + 4, "TTMC") ||
+          readLittleEndian<uint32_t>(header + 4) != fileVersion ||
+          readLittleEndian<uint32_t>(header + 8) != recordSize) {
+        return false;
+      }
+
+      results.clear();
+      uint8_t record[recordSize];
+      size_t read;
+      while ((read = std::fread(record, 1, recordSize, input)) == recordSize) {
+        results.push_back(decode(record));
+      }
+      return read == 0;
+    }
+
+  private:
+    template <typename T>
+    static void writeLittleEndian(uint8_t* const destination, const T value) {
+      uint64_t bits = 0;
+      std::memcpy(&bits, &value, sizeof(T));
+      for (size_t i = 0; i < sizeof(T); ++i) {
+        destination[i] = static_cast<uint8_t>(bits >> (8 * i));
+      }
+    }
+
+    template <typename T>
+    static T readLittleEndian(const uint8_t* const source) {
+      uint64_t bits = 0;
+      for (size_t i = 0; i < sizeof(T); ++i) {
+        bits |= static_cast<uint64_t>(source[i]) << (8 * i);
+      }
+      T value;
+      std::memcpy(&value, &bits, sizeof(T));
+      return value;
+    }
+
+    static void encode(const EngagementResult& result, uint8_t* const record) {
+      writeLittleEndian(record, result.run.seed);
+      writeLittleEndian(record + 8, result.run.power);
+      writeLittleEndian(record + 16, result.run.gain);
+      writeLittleEndian(record + 24, result.run.minimumDetectableSignal);
+      writeLittleEndian(record + 32, result.run.index);
+      writeLittleEndian(record + 36, result.detectionCount);
+      writeLittleEndian(record + 40, result.firstDetectionTime);
+      writeLittleEndian(record + 44, result.firstDetectionRange);
+      writeLittleEndian(record + 48, result.maximumDetectionRange);
+      record[52] = result.succeeded ? 1 : 0;
+      std::fill(record + 53, record + recordSize, 0);
+    }
+
+    static EngagementResult decode(const uint8_t* const record) {
+      EngagementResult result;
+      result.run.seed = readLittleEndian<uint64_t>(record);
+      result.run.power = readLittleEndian<double>(record + 8);
+      result.run.gain = readLittleEndian<double>(record + 16);
+      result.run.minimumDetectableSignal = readLittleEndian<double>(record + 24);
+      result.run.index = readLittleEndian<uint32_t>(record + 32);
+      result.detectionCount = readLittleEndian<uint32_t>(record + 36);
+      result.firstDetectionTime = readLittleEndian<float>(record + 40);
+      result.firstDetectionRange = readLittleEndian<float>(record + 44);
+      result.maximumDetectionRange = readLittleEndian<float>(record + 48);
+      result.succeeded = record[52] != 0;
+      return result;
+    }
+
+    ThreadPool threadPool;
+  };
+}
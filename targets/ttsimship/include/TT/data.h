@@ -1,10 +1,17 @@
 #pragma once
 
-#include <list>
-#include <queue>
+#include <cstdint>
+#include <vector>
+
 #include <Eigen/Core>
 
+#include "TT/entity_store.h"
+#include "TT/interest_management.h"
+#include "TT/model.h"
+#include "TT/radar_cross_section.h"
+#include "TT/ring_buffer.h"
 #include "TT/rpr_fom.h"
+#include "TT/spatial_grid.h"
 
 struct Echo {
     double range = 0; // meter
@@ -14,6 +21,19 @@ struct Echo {
     double radialVelocity = 0; // meters per second along the line of sight of the radar to the object
 };
 
+struct Track {
+    uint32_t id = 0; // unique for the lifetime of the track manager
+    bool confirmed = false; // associated with enough consecutive scans to be reported to the avionics
+    uint16_t hitCount = 0; // scans an echo was associated with the track
+    uint16_t missCount = 0; // consecutive scans without an associated echo
+    double x = 0; // meter, world space
+    double y = 0; // meter, world space
+    double z = 0; // meter, world space
+    double velocityX = 0; // meters per second, world space
+    double velocityY = 0; // meters per second, world space
+    double velocityZ = 0; // meters per second, world space
+};
+
 namespace tt::simship {
     /// A Common Synthetic Environment Channel holding information about our simulated Aircraft.
     class OwnshipChannel final : public DataChannel {
@@ -24,41 +44,114 @@ namespace tt::simship {
 
         BusData<Eigen::Vector3d> aircraftVelocity;
 
+        /// Height above mean sea level in meters
+        BusData<double> aircraftAltitude;
+
         BusData<Eigen::Vector3d> radarOffset;
 
         BusData<Eigen::Vector3d> radarRotation;
 
+        /// Normalised pilot commands, -1 to 1 for the control surfaces and 0 to 1 for the throttle
+        BusData<double> aileronCommand;
+
+        BusData<double> elevatorCommand;
+
+        BusData<double> rudderCommand;
+
+        BusData<double> throttleCommand;
+
     public:
         OwnshipChannel() :
             DataChannel("OwnshipChannel"),
-            aircraftPosition(Eigen::Vector3d(0, 0, 0), "Ownship.Position"),
-            aircraftRotation(Eigen::Vector3d(0, 0, 0), "Ownship.Rotation"),
-            aircraftVelocity(Eigen::Vector3d(0, 0, 0), "Ownship.Velocity"),
+            aircraftPosition(Eigen::Vector3d(0, 0, 0), "Ownship.Position", BusDataBase::DoubleBuffered),
+            aircraftRotation(Eigen::Vector3d(0, 0, 0), "Ownship.Rotation", BusDataBase::DoubleBuffered),
+            aircraftVelocity(Eigen::Vector3d(0, 0, 0), "Ownship.Velocity", BusDataBase::DoubleBuffered),
+            aircraftAltitude(0, "Ownship.Altitude", BusDataBase::DoubleBuffered),
             radarOffset(Eigen::Vector3d(0, 0, 0), "Radar.Offset"),
-            radarRotation(Eigen::Vector3d(0, 0, 0), "Radar.Rotation") {
+            radarRotation(Eigen::Vector3d(0, 0, 0), "Radar.Rotation"),
+            aileronCommand(0, "Ownship.AileronCommand"),
+            elevatorCommand(0, "Ownship.ElevatorCommand"),
+            rudderCommand(0, "Ownship.RudderCommand"),
+            throttleCommand(0, "Ownship.ThrottleCommand") {
         }
     };
 
     /// A Common Synthetic Environment Channel holding information about federation entities.
     class EnvironmentChannel final : public DataChannel {
     public:
-        BusData<std::list<rpr_fom::PhysicalEntity>> physicalEntities;
+        /// All federation entities in a structure of arrays layout, along with a log of the changes made to them for
+        /// consumers to catch up from the revision they last saw
+        BusData<EntityStore> physicalEntities;
+
+        /// Spatial index over physicalEntities, maintained by the SpatialIndexModel
+        BusData<SpatialGrid> entityIndex;
+
+        /// Aspect dependent radar cross sections of the platforms, by RadarCrossSectionSignatureIndex
+        BusData<RadarCrossSectionLibrary> radarCrossSections;
+
+        /// Per subscriber views of physicalEntities, maintained by the InterestManagementModel
+        BusData<InterestManager> interest;
 
     public:
         EnvironmentChannel() :
             DataChannel("EnvironmentChannel"),
-            physicalEntities({}, "Environment.Entities") {
+            physicalEntities({}, "Environment.Entities"),
+            entityIndex(SpatialGrid(), "Environment.EntityIndex"),
+            radarCrossSections({}, "Environment.RadarCrossSections"),
+            interest({}, "Environment.Interest") {
         }
     };
-}
 
-// Avionic Channel
-namespace radarChannel {
-    double horizontalFieldOfView = 50; // radian
-    double verticalFieldOfView = 50; // radian
-    double power = 1500; // watt
-    double gain = 1; // scalar (send antenna)
-    double effectiveArea = 1; // meters squared (recieve antenna)
-    double minimumDetectableSignal = 9.0e-14; // watt
-    std::queue<Echo> echos;
+    /// An Avionic Channel holding the parameters and output of a single radar. Each radar instance uses its own
+    /// channel.
+    class RadarChannel final : public DataChannel {
+    public:
+        BusData<double> horizontalFieldOfView; // radian
+
+        BusData<double> verticalFieldOfView; // radian
+
+        BusData<double> power; // watt
+
+        BusData<double> gain; // scalar (send antenna)
+
+        BusData<double> effectiveArea; // meters squared (recieve antenna)
+
+        BusData<double> minimumDetectableSignal; // watt
+
+        /// Echoes produced by the radar each frame, for a single consumer which may run on another thread. Echoes are
+        /// dropped and counted when the consumer does not keep up.
+        RingBuffer<Echo> echoes;
+
+        /// Number of scans whose echoes have been pushed to the echo buffer. The radar writes it after each scan and
+        /// the consumer of the echoes reads it, so the dependency graph of a Parallel simulation runs the consumer
+        /// after the radar, which it cannot tell from the echo buffer.
+        BusData<uint64_t> scanCount;
+
+    public:
+        /// \param echoCapacity the maximum number of echoes waiting to be consumed
+        explicit RadarChannel(const size_t echoCapacity = 4096) :
+            DataChannel("RadarChannel"),
+            horizontalFieldOfView(50, "Radar.HorizontalFieldOfView"),
+            verticalFieldOfView(50, "Radar.VerticalFieldOfView"),
+            power(1500, "Radar.Power"),
+            gain(1, "Radar.Gain"),
+            effectiveArea(1, "Radar.EffectiveArea"),
+            minimumDetectableSignal(9.0e-14, "Radar.MinimumDetectableSignal"),
+            echoes(echoCapacity),
+            scanCount(0, "Radar.ScanCount") {
+        }
+    };
+
+    /// An Avionic Channel holding the tracks a track manager maintains from the echoes of a radar.
+    class TrackChannel final : public DataChannel {
+    public:
+        /// Tentative and confirmed tracks, ordered by id
+        BusData<std::vector<Track>> tracks;
+
+    public:
+        TrackChannel() :
+            DataChannel("TrackChannel"),
+            tracks({}, "Tracks.Table") {
+        }
+    };
 }
@@ -0,0 +1,97 @@
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+#include <TT/logging.h>
+#include <TT/model.h>
+#include <JSBSim/input_output/FGPropertyManager.h>
+
+namespace tt::simship {
+  /// A JSBSim property which is looked up in the property tree once, so that reading and writing it afterwards is a
+  /// pointer dereference instead of a walk of the property tree by path.
+  class PropertyBinding {
+  public:
+    explicit PropertyBinding(std::string path) :
+      path_(std::move(path)) {
+    }
+
+    /// Looks the property up. Must be called after the aircraft has been loaded, e.g. in Model::init().
+    ///
+    /// \param properties the property tree of the FDM
+    /// \return false if the property does not exist
+    bool resolve(JSBSim::FGPropertyManager& properties) {
+      node_ = properties.GetNode(path_);
+      if (node_ == nullptr) {
+        log::error("Unknown JSBSim property: ", path_);
+      }
+      return node_ != nullptr;
+    }
+
+    [[nodiscard]] double get() const {
+      return node_->getDoubleValue();
+    }
+
+    void set(const double value) const {
+      node_->setDoubleValue(value);
+    }
+
+    [[nodiscard]] const std::string& getPath() const {
+      return path_;
+    }
+
+  private:
+    std::string path_;
+
+    JSBSim::FGPropertyNode* node_ = nullptr;
+  };
+
+  /// Copies scalar BusData to JSBSim properties before each FDM step (inputs), and JSBSim properties to scalar BusData
+  /// after each step (outputs), through pre-resolved property nodes.
+  class PropertyBindings {
+  public:
+    /// \param path the property written from the bus data
+    /// \param source the bus data read each frame
+    void addInput(std::string path, const ReadHandle<double>& source) {
+      inputs_.push_back({PropertyBinding(std::move(path)), source});
+    }
+
+    /// \param path the property read into the bus data
+    /// \param target the bus data written each frame
+    void addOutput(std::string path, const WriteHandle<double>& target) {
+      outputs_.push_back({PropertyBinding(std::move(path)), target});
+    }
+
+    /// Resolves all bound properties.
+    ///
+    /// \see PropertyBinding::resolve
+    ///
+    /// \return false if any property does not exist
+    bool resolve(JSBSim::FGPropertyManager& properties) {
+      bool resolved = true;
+      for (auto& input : inputs_) {
+        resolved = input.first.resolve(properties) && resolved;
+      }
+      for (auto& output : outputs_) {
+        resolved = output.first.resolve(properties) && resolved;
+      }
+      return resolved;
+    }
+
+    void writeInputs() const {
+      for (const auto& [property, source] : inputs_) {
+        property.set(*source);
+      }
+    }
+
+    void readOutputs() const {
+      for (const auto& [property, target] : outputs_) {
+        *target = property.get();
+      }
+    }
+
+  private:
+    std::vector<std::pair<PropertyBinding, ReadHandle<double>>> inputs_;
+
+    std::vector<std::pair<PropertyBinding, WriteHandle<double>>> outputs_;
+  };
+}
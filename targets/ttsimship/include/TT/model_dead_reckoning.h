@@ -0,0 +1,24 @@
+#pragma once
+#include <TT/dead_reckoning.h>
+#include <TT/model.h>
+#include "data.h"
+
+namespace tt::simship {
+  /// Dead reckons all federation entities every frame, so sensors see them move smoothly between the updates from
+  /// their simulators. Add this model after the models which update entities and before the spatial index and sensors.
+  class DeadReckoningModel final : public Model {
+  public:
+    explicit DeadReckoningModel(EnvironmentChannel& environmentChannel) :
+      Model("DeadReckoning", 0),
+      outEnvironmentEntities(environmentChannel.physicalEntities.getWriteHandle(this)) {
+    }
+
+    bool run() override {
+      advanceDeadReckoning(*outEnvironmentEntities, getDeltaTime());
+      return true;
+    }
+
+  private:
+    const WriteHandle<EntityStore> outEnvironmentEntities;
+  };
+}
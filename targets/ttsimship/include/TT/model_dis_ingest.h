@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <TT/dis_receiver.h>
+#include <TT/model.h>
+#include "data.h"
+
+namespace tt::simship {
+  /// Feeds federation entities from DIS Entity State PDUs received over UDP into the environment channel. PDUs are
+  /// received and decoded on a thread of their own from init() on, and applied once per frame: unknown entities are
+  /// added, known ones updated, and deactivated ones removed. Add this model before all other models writing entities.
+  class DisIngestModel final : public Model {
+  public:
+    /// \param port the UDP port to receive DIS on, 0 binds to a free port
+    /// \param address the local IPv4 address to bind to
+    DisIngestModel(EnvironmentChannel& environmentChannel, const uint16_t port, std::string address = "0.0.0.0") :
+      Model("DisIngest", 0),
+      outEnvironmentEntities(environmentChannel.physicalEntities.getWriteHandle(this)),
+      port(port),
+      address(std::move(address)),
+      batch(256) {
+    }
+
+    bool init() override {
+      return receiver.isRunning() || receiver.start(port, address);
+    }
+
+    bool run() override {
+      EntityStore& entities = *outEnvironmentEntities;
+      size_t count;
+      while ((count = receiver.getUpdates().pop(batch.data(), batch.size())) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+          apply(entities, batch[i]);
+        }
+      }
+      return true;
+    }
+
+    /// Saves which store handle belongs to which entity identifier, so updates after a restore find their entities.
+    bool saveState(std::vector<uint8_t>& buffer) const override {
+      appendBytes(buffer, static_cast<uint64_t>(handles.size()));
+      for (const auto& [key, handle] : handles) {
+        appendBytes(buffer, key);
+        appendBytes(buffer, handle);
+      }
+      return true;
+    }
+
+    bool restoreState(ByteReader& reader) override {
+      handles.clear();
+      uint64_t count;
+      if (!reader.read(count)) {
+        return false;
+      }
+      for (uint64_t i = 0; i < count; ++i) {
+        uint64_t key;
+        EntityHandle handle;
+        if (!reader.read(key) || !reader.read(handle)) {
+          return false;
+        }
+        handles[key] = handle;
+      }
+      return true;
+    }
+
+    bool unload() override {
+      receiver.stop();
+      return true;
+    }
+
+    [[nodiscard]] const dis::Receiver& getReceiver() const {
+      return receiver;
+    }
+
+  private:
+    static uint64_t toKey(const rpr_fom::EntityIdentifierStruct& identifier) {
+      return uint64_t(identifier.FederateIdentifier.SiteID) << 32 |
+        uint64_t(identifier.FederateIdentifier.ApplicationID) << 16 |
+        identifier.EntityNumber;
+    }
+
+    void apply(EntityStore& entities, const dis::EntityState& state) {
+      const uint64_t key = toKey(state.entity.EntityIdentifier);
+      const auto found = handles.find(key);
+      if (state.deactivated) {
+        if (found != handles.end()) {
+          entities.remove(found->second);
+          handles.erase(found);
+        }
+        return;
+      }
+      if (found == handles.end() || !entities.update(found->second, state.entity)) {
+        handles[key] = entities.add(state.entity);
+      }
+    }
+
+    dis::Receiver receiver;
+
+    /// store handle of each entity known from DIS, by entity identifier
+    std::unordered_map<uint64_t, EntityHandle> handles;
+
+  private:
+    const WriteHandle<EntityStore> outEnvironmentEntities;
+
+    const uint16_t port;
+
+    const std::string address;
+
+    std::vector<dis::EntityState> batch;
+  };
+}
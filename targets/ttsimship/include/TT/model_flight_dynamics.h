@@ -1,11 +1,15 @@
 #pragma once
+#include "TT/geodesy.h"
 #include "TT/model.h"
 
+#include <cmath>
 #include <Eigen/Core>
+#include <Eigen/Geometry>
 #include <FGFDMExec.h>
-#include <JSBSim/math/FGLocation.h>
+#include <JSBSim/initialization/FGInitialCondition.h>
 
 #include "data.h"
+#include "jsbsim_properties.h"
 
 namespace tt::simship {
   class AircraftModel final : public Model {
@@ -13,7 +17,13 @@ namespace tt::simship {
     explicit AircraftModel(OwnshipChannel& ownshipChannel) :
       Model("AircraftModel", 0),
       outAircraftPosition_(ownshipChannel.aircraftPosition.getWriteHandle(this)),
-      outAircraftRotation_(ownshipChannel.aircraftRotation.getWriteHandle(this)) {
+      outAircraftRotation_(ownshipChannel.aircraftRotation.getWriteHandle(this)),
+      outAircraftVelocity_(ownshipChannel.aircraftVelocity.getWriteHandle(this)) {
+      properties_.addInput("fcs/aileron-cmd-norm", ownshipChannel.aileronCommand.getReadHandle(this));
+      properties_.addInput("fcs/elevator-cmd-norm", ownshipChannel.elevatorCommand.getReadHandle(this));
+      properties_.addInput("fcs/rudder-cmd-norm", ownshipChannel.rudderCommand.getReadHandle(this));
+      properties_.addInput("fcs/throttle-cmd-norm", ownshipChannel.throttleCommand.getReadHandle(this));
+      properties_.addOutput("position/h-sl-meters", ownshipChannel.aircraftAltitude.getWriteHandle(this));
     }
 
     bool load() override {
@@ -27,35 +37,106 @@ namespace tt::simship {
     bool init() override {
       auto a = fdmExec_.GetPropertyCatalog();
       for (const auto& prop : a) {
-        tt::log::info(prop);
+        tt::log::debug(prop);
       }
-      return fdmExec_.RunIC();
+      if (!fdmExec_.RunIC()) {
+        return false;
+      }
+
+      // Every property used per frame is looked up once here, so run() only dereferences nodes
+      JSBSim::FGPropertyManager& propertyManager = *fdmExec_.GetPropertyManager();
+      bool resolved = properties_.resolve(propertyManager);
+      for (PropertyBinding* property : {&longitude_, &geodeticLatitude_, &geodeticAltitude_, &altitude_, &roll_,
+                                        &pitch_, &heading_, &velocityNorth_, &velocityEast_, &velocityDown_}) {
+        resolved = property->resolve(propertyManager) && resolved;
+      }
+      return resolved;
     }
 
     bool run() override {
-      // TODO: Update input
+      properties_.writeInputs();
 
       bool result = fdmExec_.Run(); // execute JSBSim
 
-      // TODO: Update output
+      properties_.readOutputs();
 
-      const JSBSim::FGLocation pos(fdmExec_.GetPropertyValue("position/long-gc-deg"),
-                                   fdmExec_.GetPropertyValue("position/lat-gc-deg"),
-                                   fdmExec_.GetPropertyValue("position/radius-to-vehicle-ft"));
-      JSBSim::FGColumnVector3 ecef = pos;
-      outAircraftPosition_->x() = JSBSim::FGFDMExec::FeetToMeters(ecef.Entry(1));
-      outAircraftPosition_->y() = JSBSim::FGFDMExec::FeetToMeters(ecef.Entry(2));
-      outAircraftPosition_->z() = JSBSim::FGFDMExec::FeetToMeters(ecef.Entry(3));
+      const double longitude = longitude_.get();
+      const double latitude = geodeticLatitude_.get();
+      *outAircraftPosition_ =
+        math::geodeticToEcef(latitude, longitude, JSBSim::FGFDMExec::FeetToMeters(geodeticAltitude_.get()));
+
+      // JSBSim reports attitude and velocity in the local North East Down frame, the ownship channel in ECEF
+      const Eigen::Matrix3d nedToEcef = math::getNedToEcef(latitude, longitude);
+      const Eigen::Matrix3d bodyToNed = Eigen::Matrix3d(
+        Eigen::AngleAxisd(heading_.get(), Eigen::Vector3d::UnitZ()) *
+        Eigen::AngleAxisd(pitch_.get(), Eigen::Vector3d::UnitY()) *
+        Eigen::AngleAxisd(roll_.get(), Eigen::Vector3d::UnitX()));
+      // Same convention as tt::Transform::getLocalRotationEuler, i.e. roll, pitch and yaw about the ECEF axes
+      *outAircraftRotation_ = (nedToEcef * bodyToNed).eulerAngles(2, 1, 0).reverse();
+
+      const Eigen::Vector3d velocityNed(velocityNorth_.get(), velocityEast_.get(), velocityDown_.get());
+      *outAircraftVelocity_ = nedToEcef * velocityNed * JSBSim::FGFDMExec::FeetToMeters(1);
 
       return result;
     }
 
+    /// Saves the position, attitude and velocity of the aircraft. Restoring re-initialises JSBSim at the saved state,
+    /// while engine and system states start over from their initial condition.
+    bool saveState(std::vector<uint8_t>& buffer) const override {
+      for (const PropertyBinding* property : {&longitude_, &geodeticLatitude_, &altitude_, &roll_, &pitch_, &heading_,
+                                              &velocityNorth_, &velocityEast_, &velocityDown_}) {
+        appendBytes(buffer, property->get());
+      }
+      return true;
+    }
+
+    bool restoreState(ByteReader& reader) override {
+      double state[9];
+      if (!reader.read(state)) {
+        return false;
+      }
+      JSBSim::FGInitialCondition& initialCondition = *fdmExec_.GetIC();
+      initialCondition.SetLongitudeRadIC(state[0]);
+      initialCondition.SetGeodLatitudeRadIC(state[1]);
+      initialCondition.SetAltitudeASLFtIC(state[2]);
+      initialCondition.SetPhiRadIC(state[3]);
+      initialCondition.SetThetaRadIC(state[4]);
+      initialCondition.SetPsiRadIC(state[5]);
+      initialCondition.SetVNorthFpsIC(state[6]);
+      initialCondition.SetVEastFpsIC(state[7]);
+      initialCondition.SetVDownFpsIC(state[8]);
+      return fdmExec_.RunIC();
+    }
+
   private:
     JSBSim::FGFDMExec fdmExec_;
 
-    const std::shared_ptr<Eigen::Vector3d> outAircraftPosition_;
+    PropertyBindings properties_;
 
-    const std::shared_ptr<Eigen::Vector3d> outAircraftRotation_;
+    PropertyBinding longitude_{"position/long-gc-rad"};
+
+    PropertyBinding geodeticLatitude_{"position/lat-geod-rad"};
+
+    PropertyBinding geodeticAltitude_{"position/geod-alt-ft"};
+
+    PropertyBinding altitude_{"position/h-sl-ft"};
+
+    PropertyBinding roll_{"attitude/phi-rad"};
+
+    PropertyBinding pitch_{"attitude/theta-rad"};
+
+    PropertyBinding heading_{"attitude/psi-rad"};
+
+    PropertyBinding velocityNorth_{"velocities/v-north-fps"};
+
+    PropertyBinding velocityEast_{"velocities/v-east-fps"};
+
+    PropertyBinding velocityDown_{"velocities/v-down-fps"};
+
+    const WriteHandle<Eigen::Vector3d> outAircraftPosition_;
+
+    const WriteHandle<Eigen::Vector3d> outAircraftRotation_;
+
+    const WriteHandle<Eigen::Vector3d> outAircraftVelocity_;
   };
 }
-
@@ -0,0 +1,128 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <TT/interest_management.h>
+#include <TT/model.h>
+#include <Eigen/Core>
+#include "data.h"
+#include "model_radar.h"
+
+namespace tt::simship {
+  /// Keeps the interest views of the environment channel up to date with its entities, moving the regions of
+  /// subscriptions which follow an ownship or a radar beforehand. Add this model after the SpatialIndexModel and before
+  /// the models reading the views, at the rate of the fastest of them.
+  class InterestManagementModel final : public Model {
+  public:
+    using SubscriptionId = InterestManager::SubscriptionId;
+
+    /// \param environmentChannel the entities and the interest manager whose views are kept up to date
+    /// \param targetFrameInterval in milliseconds, that of the fastest model reading the views. The default is the
+    ///                            rate of the RadarModel.
+    explicit InterestManagementModel(EnvironmentChannel& environmentChannel, const uint32_t targetFrameInterval = 100) :
+      Model("InterestManagement", targetFrameInterval),
+      inEnvironmentEntities(environmentChannel.physicalEntities.getReadHandle(this)),
+      inEntityIndex(environmentChannel.entityIndex.getReadHandle(this)),
+      inRadarCrossSections(environmentChannel.radarCrossSections.getReadHandle(this)),
+      outInterest(environmentChannel.interest.getWriteHandle(this)) {
+    }
+
+    /// Subscribes to a fixed region. Subscriptions must be added before the model is added to a simulation.
+    ///
+    /// \param region the region of interest
+    /// \return the id of the subscription in the interest manager of the environment channel
+    SubscriptionId subscribe(const InterestRegion& region) {
+      return outInterest->subscribe(region);
+    }
+
+    /// Subscribes to the entities within range of an ownship.
+    ///
+    /// \param ownshipChannel the platform the region follows, which must outlive the model
+    /// \param range radius of the region, in meters
+    /// \param entityTypes the entity types of interest, \see InterestRegion::entityTypes
+    /// \return the id of the subscription in the interest manager of the environment channel
+    SubscriptionId subscribeAroundOwnship(const OwnshipChannel& ownshipChannel, const double range,
+                                          std::vector<rpr_fom::EntityTypeStruct> entityTypes = {}) {
+      InterestRegion region = InterestRegion::sphere(Eigen::Vector3d::Zero(), range);
+      region.entityTypes = std::move(entityTypes);
+      const SubscriptionId subscription = outInterest->subscribe(region);
+      ownshipSubscriptions.push_back({subscription, ownshipChannel.aircraftPosition.getReadHandle(this)});
+      return subscription;
+    }
+
+    /// Subscribes to the volume a radar may detect entities in, i.e. the cone around its field of view out to its
+    /// maximum range. Pass the id to RadarModel::setInterest so the radar only tests the entities of the view.
+    ///
+    /// \param ownshipChannel the platform carrying the radar, which must outlive the model
+    /// \param radarChannel the parameters of the radar, which must outlive the model
+    /// \param entityTypes the entity types the radar may detect, \see InterestRegion::entityTypes
+    /// \return the id of the subscription in the interest manager of the environment channel
+    SubscriptionId subscribeRadar(const OwnshipChannel& ownshipChannel, const RadarChannel& radarChannel,
+                                  std::vector<rpr_fom::EntityTypeStruct> entityTypes = {}) {
+      InterestRegion region;
+      region.entityTypes = std::move(entityTypes);
+      const SubscriptionId subscription = outInterest->subscribe(region);
+      radarSubscriptions.push_back(
+        {subscription, std::make_unique<RadarParameters>(this, ownshipChannel, radarChannel), region.entityTypes});
+      return subscription;
+    }
+
+    bool load() override {
+      for (const RadarSubscription& radarSubscription : radarSubscriptions) {
+        radarSubscription.parameters->load();
+      }
+      return true;
+    }
+
+    bool run() override {
+      InterestManager& interest = *outInterest;
+      for (const OwnshipSubscription& ownshipSubscription : ownshipSubscriptions) {
+        InterestRegion region = *interest.getRegion(ownshipSubscription.subscription);
+        region.center = *ownshipSubscription.inAircraftPosition;
+        interest.setRegion(ownshipSubscription.subscription, region);
+      }
+
+      const RadarCrossSectionLibrary* signatures = inRadarCrossSections->empty() ? nullptr : &*inRadarCrossSections;
+      for (const RadarSubscription& radarSubscription : radarSubscriptions) {
+        // The same frame the radar builds from the same inputs, so the view encloses everything it can detect
+        const RadarDetectionFrame frame = radarSubscription.parameters->makeFrame(signatures);
+        InterestRegion region = InterestRegion::cone(frame.radarPosition, frame.worldToRadar.row(0).transpose(),
+                                                     frame.getConeHalfAngle(), frame.getMaximumRange());
+        region.entityTypes = radarSubscription.entityTypes;
+        interest.setRegion(radarSubscription.subscription, region);
+      }
+
+      interest.synchronise(*inEnvironmentEntities, *inEntityIndex);
+      return true;
+    }
+
+  private:
+    struct OwnshipSubscription {
+      SubscriptionId subscription;
+
+      ReadHandle<Eigen::Vector3d> inAircraftPosition;
+    };
+
+    struct RadarSubscription {
+      SubscriptionId subscription;
+
+      std::unique_ptr<RadarParameters> parameters;
+
+      std::vector<rpr_fom::EntityTypeStruct> entityTypes;
+    };
+
+    std::vector<OwnshipSubscription> ownshipSubscriptions;
+
+    std::vector<RadarSubscription> radarSubscriptions;
+
+  private:
+    const ReadHandle<EntityStore> inEnvironmentEntities;
+
+    const ReadHandle<SpatialGrid> inEntityIndex;
+
+    const ReadHandle<RadarCrossSectionLibrary> inRadarCrossSections;
+
+    const WriteHandle<InterestManager> outInterest;
+  };
+}
@@ -1,137 +1,404 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
 #include <TT/model.h>
+#include <TT/serialisation.h>
 #include <TT/transform.h>
 #include <Eigen/Core>
 #include "data.h"
+#include "radar_detection.h"
 
 namespace tt::simship {
-  class RadarModel final : public Model {
+  /// The inputs and transforms of a single radar, from which the detection frame of the radar is built.
+  class RadarParameters {
   public:
-    explicit RadarModel(const OwnshipChannel& ownshipChannel, const EnvironmentChannel& environmentChannel) :
-      Model("Radar", 100),
-      inAircraftPosition(ownshipChannel.aircraftPosition.getReadHandle(this)),
-      inAircraftRotation(ownshipChannel.aircraftRotation.getReadHandle(this)),
-      inAircraftVelocity(ownshipChannel.aircraftVelocity.getReadHandle(this)),
-      inRadarOffset(ownshipChannel.radarOffset.getReadHandle(this)),
-      inRadarRotation(ownshipChannel.radarRotation.getReadHandle(this)),
-      inEnvironmentEntities(environmentChannel.physicalEntities.getReadHandle(this)),
-      inHorizontalFieldOfView(&radarChannel::horizontalFieldOfView),
-      inVerticalFieldOfView(&radarChannel::verticalFieldOfView),
-      inPower(&radarChannel::power),
-      inGain(&radarChannel::gain),
-      inEffectiveArea(&radarChannel::effectiveArea),
-      inMinimumDetectableSignal(&radarChannel::minimumDetectableSignal),
-      outEchos(&radarChannel::echos) {
+    /// \param model the model reading the inputs of the radar
+    /// \param ownshipChannel the platform carrying the radar
+    /// \param radarChannel the parameters of the radar
+    RadarParameters(Model* const model, const OwnshipChannel& ownshipChannel, const RadarChannel& radarChannel) :
+      inAircraftPosition(ownshipChannel.aircraftPosition.getReadHandle(model)),
+      inAircraftRotation(ownshipChannel.aircraftRotation.getReadHandle(model)),
+      inAircraftVelocity(ownshipChannel.aircraftVelocity.getReadHandle(model)),
+      inRadarOffset(ownshipChannel.radarOffset.getReadHandle(model)),
+      inRadarRotation(ownshipChannel.radarRotation.getReadHandle(model)),
+      inHorizontalFieldOfView(radarChannel.horizontalFieldOfView.getReadHandle(model)),
+      inVerticalFieldOfView(radarChannel.verticalFieldOfView.getReadHandle(model)),
+      inPower(radarChannel.power.getReadHandle(model)),
+      inGain(radarChannel.gain.getReadHandle(model)),
+      inEffectiveArea(radarChannel.effectiveArea.getReadHandle(model)),
+      inMinimumDetectableSignal(radarChannel.minimumDetectableSignal.getReadHandle(model)) {
     }
 
-    bool load() override {
+    RadarParameters(const RadarParameters&) = delete;
+
+    RadarParameters& operator=(const RadarParameters&) = delete;
+
+    void load() {
       ownshipXform = tt::Transform(*inAircraftPosition, *inAircraftRotation);
       radarXform = tt::Transform(*inRadarOffset, *inRadarRotation);
       radarXform.setParent(&ownshipXform);
-      return true;
     }
 
-    bool run() override {
-      // Update xforms
+    /// Updates the transforms from the inputs.
+    ///
+    /// \param signatures the radar cross sections of the platforms, or nullptr if there are none
+    /// \return everything the detection kernel needs to know about the radar in this frame
+    RadarDetectionFrame makeFrame(const RadarCrossSectionLibrary* const signatures) {
       ownshipXform.setLocalTranslation(*inAircraftPosition);
       ownshipXform.setLocalRotationEuler(*inAircraftRotation);
       radarXform.setLocalTranslation(*inRadarOffset);
       radarXform.setLocalRotationEuler(*inRadarRotation);
 
-      // Pre-compute useful values
-      const double halfHorizontalFieldOfView = *inHorizontalFieldOfView * 0.5;
-      const double halfVerticalFieldOfView = *inVerticalFieldOfView * 0.5;
-
-      for (auto entity = inEnvironmentEntities->begin(); entity != inEnvironmentEntities->end(); ++entity) {
-        const tt::Transform entityWorldXform(
-          entity->Spatial.SpatialRVW.WorldLocation.X,
-          entity->Spatial.SpatialRVW.WorldLocation.Y,
-          entity->Spatial.SpatialRVW.WorldLocation.Z,
-          entity->Spatial.SpatialRVW.Orientation.Phi,
-          entity->Spatial.SpatialRVW.Orientation.Theta,
-          entity->Spatial.SpatialRVW.Orientation.Psi);
-        const tt::Transform entityInRadarSpace(radarXform.toLocalTransform(entityWorldXform));
-        const auto otherOffset = entityInRadarSpace.getLocalTranslation();
-
-        // Is the entity behind us?
-        if (otherOffset.x() < 0) {
-          continue;
-        }
-
-        // Is the entity within our beam?
-        const double horizontalAngle = std::atan2(otherOffset.y(), otherOffset.x());
-        const double verticalAngle = std::atan2(otherOffset.z(), otherOffset.x());
-        if (abs(horizontalAngle) > halfHorizontalFieldOfView || abs(verticalAngle) > halfVerticalFieldOfView) {
-          continue;
-        }
-
-        // Radar Cross Section Check
-        const double radarCrossSection = 3.5;
-        const double distance = otherOffset.norm();
-        // const double radarCrossSection = getRadarCrossSection(entity);
-        // TODO: Apply weather reduction to the radar power
-        // TODO: Consider a function which can produce a more accurate Radar Cross Section
-        const double returnPower = ((*inPower * *inGain) / (M_PI_4 * (distance * distance)))
-          * radarCrossSection
-          * (1.0 / (M_PI_4 * (distance * distance)))
-          * *inEffectiveArea;
-
-        if (returnPower < *inMinimumDetectableSignal) {
-          continue;
-        }
-
-        // Calculate radial velocity
-        const Eigen::Vector3d entityWorldVelocity(entity->Spatial.SpatialRVW.VelocityVector.XVelocity,
-                                                  entity->Spatial.SpatialRVW.VelocityVector.YVelocity,
-                                                  entity->Spatial.SpatialRVW.VelocityVector.ZVelocity);
-        const Eigen::Vector3d entityVelocityInRadarSpace(radarXform.toLocalVector(entityWorldVelocity));
-        const Eigen::Vector3d radarVelocityInRadarSpace(radarXform.toLocalVector(*inAircraftVelocity));
-        const Eigen::Vector3d entityVelocityRelativeToRadar(entityVelocityInRadarSpace - radarVelocityInRadarSpace);
-
-        // If we are here, the radar would have a good chance of an Echo
-        Echo radarEcho;
-        radarEcho.range = distance;
-        radarEcho.horizontalAngle = horizontalAngle;
-        radarEcho.verticalAngle = verticalAngle;
-        radarEcho.radialVelocity = entityVelocityRelativeToRadar.x();
-        radarEcho.returnPower = returnPower;
-
-        outEchos->push(radarEcho);
+      // Everything which does not depend on the entity is computed once per frame
+      RadarDetectionFrame frame = RadarDetectionFrame::fromWorldTransform(
+        radarXform.getWorldRotationMatrix(), radarXform.getWorldTranslation(), *inAircraftVelocity);
+      frame.halfHorizontalFieldOfView = *inHorizontalFieldOfView * 0.5;
+      frame.halfVerticalFieldOfView = *inVerticalFieldOfView * 0.5;
+      frame.power = *inPower;
+      frame.gain = *inGain;
+      frame.effectiveArea = *inEffectiveArea;
+      frame.minimumDetectableSignal = *inMinimumDetectableSignal;
+      // TODO: Apply weather reduction to the radar power
+      // Entities without a signature table fall back to a typical fighter sized radar cross section
+      frame.radarCrossSection = 3.5;
+      frame.signatures = signatures;
+      return frame;
+    }
+
+  private:
+    tt::Transform ownshipXform;
+
+    tt::Transform radarXform;
+
+  private:
+    const ReadHandle<Eigen::Vector3d> inAircraftPosition;
+
+    const ReadHandle<Eigen::Vector3d> inAircraftRotation;
+
+    const ReadHandle<Eigen::Vector3d> inAircraftVelocity;
+
+    const ReadHandle<Eigen::Vector3d> inRadarOffset;
+
+    const ReadHandle<Eigen::Vector3d> inRadarRotation;
+
+    const ReadHandle<double> inHorizontalFieldOfView;
+
+    const ReadHandle<double> inVerticalFieldOfView;
+
+    const ReadHandle<double> inPower;
+
+    const ReadHandle<double> inGain;
+
+    const ReadHandle<double> inEffectiveArea;
+
+    const ReadHandle<double> inMinimumDetectableSignal;
+  };
+
+  /// The inputs, transforms and echo output of a single radar, evaluated by a RadarModel or a RadarBatchModel.
+  class RadarSensor {
+  public:
+    /// \param model the model reading the inputs of the radar and writing its echoes
+    /// \param ownshipChannel the platform carrying the radar
+    /// \param radarChannel the parameters and echoes of the radar
+    RadarSensor(Model* const model, const OwnshipChannel& ownshipChannel, RadarChannel& radarChannel) :
+      parameters(model, ownshipChannel, radarChannel),
+      outEchoes(&radarChannel.echoes),
+      outScanCount(radarChannel.scanCount.getWriteHandle(model)) {
+    }
+
+    RadarSensor(const RadarSensor&) = delete;
+
+    RadarSensor& operator=(const RadarSensor&) = delete;
+
+    void load() {
+      parameters.load();
+    }
+
+    /// Updates the transforms from the inputs and starts a new frame of echoes.
+    ///
+    /// \param signatures the radar cross sections of the platforms, or nullptr if there are none
+    /// \return everything the detection kernel needs to know about the radar in this frame
+    RadarDetectionFrame beginFrame(const RadarCrossSectionLibrary* const signatures) {
+      pendingEchoCount = 0;
+      frameEchoes.clear();
+      ++frameCount;
+      return parameters.makeFrame(signatures);
+    }
+
+    /// Echoes are handed to the consumer in batches, so it sees fewer updates of the ring buffer indices.
+    void emit(const Echo& radarEcho) {
+      frameEchoes.push_back(radarEcho);
+      pendingEchoes[pendingEchoCount++] = radarEcho;
+      if (pendingEchoCount == pendingEchoes.size()) {
+        outEchoes->push(pendingEchoes.data(), pendingEchoCount);
+        pendingEchoCount = 0;
       }
+    }
+
+    /// Hands the remaining echoes of the frame to the consumer and completes the scan.
+    void endFrame() {
+      outEchoes->push(pendingEchoes.data(), pendingEchoCount);
+      pendingEchoCount = 0;
+      ++*outScanCount;
+    }
+
+    /// \return the echoes produced by the latest frame
+    [[nodiscard]] const std::vector<Echo>& getEchoes() const {
+      return frameEchoes;
+    }
+
+    /// \return the number of frames evaluated so far, which tells the echoes of a new frame from those already seen
+    [[nodiscard]] uint64_t getFrameCount() const {
+      return frameCount;
+    }
+
+    /// Serialises the echoes of the latest frame if they were not recorded yet, and an empty list otherwise. The
+    /// simulation is usually recorded every base frame while the radar runs less often, so every echo is recorded
+    /// exactly once, in the frame the radar produced it.
+    void recordEchoes(std::vector<uint8_t>& buffer) {
+      static const std::vector<Echo> noEchoes;
+      Serialiser<std::vector<Echo>>::write(recordedFrameCount == frameCount ? noEchoes : frameEchoes, buffer);
+      recordedFrameCount = frameCount;
+    }
+
+  private:
+    RadarParameters parameters;
+
+    std::array<Echo, 64> pendingEchoes;
+
+    size_t pendingEchoCount = 0;
+
+    std::vector<Echo> frameEchoes;
+
+    uint64_t frameCount = 0;
+
+    /// frameCount when the echoes were last recorded
+    uint64_t recordedFrameCount = 0;
+
+  private:
+    RingBuffer<Echo>* outEchoes;
+
+    const WriteHandle<uint64_t> outScanCount;
+  };
+
+  namespace detail {
+    /// Gets the dense indices of the entities of the index within the cone of any of the frames, sorted and unique.
+    inline void queryCandidates(const RadarDetectionFrame* const frames, const size_t frameCount,
+                                const EntityStore& entities, const SpatialGrid& entityIndex,
+                                std::vector<EntityHandle>& candidateHandles, std::vector<uint32_t>& candidateIndices) {
+      candidateHandles.clear();
+      for (size_t radar = 0; radar < frameCount; ++radar) {
+        const RadarDetectionFrame& frame = frames[radar];
+        // The boresight is the first row of the transposed radar rotation
+        entityIndex.queryCone(frame.radarPosition, frame.worldToRadar.row(0).transpose(),
+                              frame.getConeHalfAngle(), frame.getMaximumRange(), candidateHandles);
+      }
+      candidateIndices.clear();
+      for (const EntityHandle handle : candidateHandles) {
+        candidateIndices.push_back(static_cast<uint32_t>(entities.indexOf(handle)));
+      }
+      std::sort(candidateIndices.begin(), candidateIndices.end());
+      if (frameCount > 1) {
+        candidateIndices.erase(std::unique(candidateIndices.begin(), candidateIndices.end()), candidateIndices.end());
+      }
+    }
+  }
+
+  class RadarModel final : public Model {
+  public:
+    RadarModel(const OwnshipChannel& ownshipChannel, const EnvironmentChannel& environmentChannel,
+               RadarChannel& radarChannel) :
+      Model("Radar", 100),
+      sensor(this, ownshipChannel, radarChannel),
+      inEnvironmentEntities(environmentChannel.physicalEntities.getReadHandle(this)),
+      inEntityIndex(environmentChannel.entityIndex.getReadHandle(this)),
+      inRadarCrossSections(environmentChannel.radarCrossSections.getReadHandle(this)),
+      inInterest(environmentChannel.interest.getReadHandle(this)) {
+    }
+
+    /// Restricts the radar to the entities in the view of a subscription, which then replaces the spatial index query.
+    ///
+    /// \param interestSubscription an id returned by InterestManagementModel::subscribeRadar for this radar
+    void setInterest(const InterestManager::SubscriptionId interestSubscription) {
+      subscription = interestSubscription;
+    }
+
+    bool load() override {
+      sensor.load();
+      return true;
+    }
+
+    bool run() override {
+      const RadarDetectionFrame frame =
+        sensor.beginFrame(inRadarCrossSections->empty() ? nullptr : &*inRadarCrossSections);
+      const auto emit = [this](const Echo& radarEcho) {
+        sensor.emit(radarEcho);
+      };
+
+      // An up to date interest view already holds the candidates
+      const EntityStore& entities = *inEnvironmentEntities;
+      const InterestView* view =
+        subscription == InterestManager::invalidSubscription ? nullptr : inInterest->getView(subscription);
+      if (view != nullptr && view->getRevision() == entities.getRevision()) {
+        detectEchoes(frame, entities, view->getIndices(), emit);
+        sensor.endFrame();
+        return true;
+      }
+
+      // Without an up to date spatial index (e.g. no SpatialIndexModel is running), every entity is tested
+      const SpatialGrid& entityIndex = *inEntityIndex;
+      if (entityIndex.getSynchronisedRevision() != entities.getRevision()) {
+        detectEchoes(frame, entities, emit);
+        sensor.endFrame();
+        return true;
+      }
+
+      detail::queryCandidates(&frame, 1, entities, entityIndex, candidateHandles, candidateIndices);
+      detectEchoes(frame, entities, candidateIndices, emit);
+      sensor.endFrame();
 
       return true;
     }
 
+    /// Gets the echoes of the latest frame, e.g. to record them. Unlike the echoes in the radar channel these are not
+    /// consumed by reading them.
+    ///
+    /// \return the echoes produced by the latest run
+    [[nodiscard]] const std::vector<Echo>& getEchoes() const {
+      return sensor.getEchoes();
+    }
+
+    /// \return the number of times the radar ran so far
+    [[nodiscard]] uint64_t getFrameCount() const {
+      return sensor.getFrameCount();
+    }
+
+    /// Records the echoes of the latest run once, e.g. as a Recorder stream.
+    ///
+    /// \see RadarSensor::recordEchoes
+    void recordEchoes(std::vector<uint8_t>& buffer) {
+      sensor.recordEchoes(buffer);
+    }
+
   private:
-    tt::Transform ownshipXform;
+    RadarSensor sensor;
 
-    tt::Transform radarXform;
+    /// spatial index query results, kept to avoid allocating every frame
+    std::vector<EntityHandle> candidateHandles;
+
+    std::vector<uint32_t> candidateIndices;
+
+    InterestManager::SubscriptionId subscription = InterestManager::invalidSubscription;
 
   private:
-    const std::shared_ptr<const Eigen::Vector3d> inAircraftPosition;
+    const ReadHandle<EntityStore> inEnvironmentEntities;
 
-    const std::shared_ptr<const Eigen::Vector3d> inAircraftRotation;
+    const ReadHandle<SpatialGrid> inEntityIndex;
 
-    const std::shared_ptr<const Eigen::Vector3d> inAircraftVelocity;
+    const ReadHandle<RadarCrossSectionLibrary> inRadarCrossSections;
 
-    const std::shared_ptr<const Eigen::Vector3d> inRadarOffset;
+    const ReadHandle<InterestManager> inInterest;
+  };
+
+  /// Evaluates several radars, e.g. of several ownships or several antennas of one platform, in a single pass over
+  /// the entities per frame rather than one pass per radar. Each radar emits the same echoes into its own channel as a
+  /// RadarModel would.
+  class RadarBatchModel final : public Model {
+  public:
+    explicit RadarBatchModel(const EnvironmentChannel& environmentChannel) :
+      Model("RadarBatch", 100),
+      inEnvironmentEntities(environmentChannel.physicalEntities.getReadHandle(this)),
+      inEntityIndex(environmentChannel.entityIndex.getReadHandle(this)),
+      inRadarCrossSections(environmentChannel.radarCrossSections.getReadHandle(this)) {
+    }
+
+    /// Adds a radar. Radars must be added before the model is added to a simulation.
+    ///
+    /// \param ownshipChannel the platform carrying the radar, which must outlive the model
+    /// \param radarChannel the parameters and echoes of the radar, which must outlive the model
+    /// \return the index of the radar
+    size_t addRadar(const OwnshipChannel& ownshipChannel, RadarChannel& radarChannel) {
+      sensors.push_back(std::make_unique<RadarSensor>(this, ownshipChannel, radarChannel));
+      return sensors.size() - 1;
+    }
+
+    [[nodiscard]] size_t getRadarCount() const {
+      return sensors.size();
+    }
+
+    bool load() override {
+      for (const auto& sensor : sensors) {
+        sensor->load();
+      }
+      return true;
+    }
+
+    bool run() override {
+      const RadarCrossSectionLibrary* signatures = inRadarCrossSections->empty() ? nullptr : &*inRadarCrossSections;
+      frames.clear();
+      for (const auto& sensor : sensors) {
+        frames.push_back(sensor->beginFrame(signatures));
+      }
+      const auto emit = [this](const size_t radar, const Echo& radarEcho) {
+        sensors[radar]->emit(radarEcho);
+      };
 
-    const std::shared_ptr<const Eigen::Vector3d> inRadarRotation;
+      detail::makeGates(frames.data(), frames.size(), gates);
 
-    const std::shared_ptr<const std::list<rpr_fom::PhysicalEntity>> inEnvironmentEntities;
+      // Without an up to date spatial index (e.g. no SpatialIndexModel is running), every entity is tested
+      const EntityStore& entities = *inEnvironmentEntities;
+      const SpatialGrid& entityIndex = *inEntityIndex;
+      if (entityIndex.getSynchronisedRevision() != entities.getRevision()) {
+        detail::detectAll(frames.data(), gates.data(), frames.size(), entities, emit);
+      }
+      else {
+        // The union of the candidates of all radars is tested, each radar's own gates reject the others
+        detail::queryCandidates(frames.data(), frames.size(), entities, entityIndex, candidateHandles,
+                                candidateIndices);
+        detail::detectAll(frames.data(), gates.data(), frames.size(), entities, candidateIndices, emit);
+      }
 
-    const double* inHorizontalFieldOfView;
+      for (const auto& sensor : sensors) {
+        sensor->endFrame();
+      }
+      return true;
+    }
 
-    const double* inVerticalFieldOfView;
+    /// \see RadarModel::getEchoes
+    ///
+    /// \param radar an index returned by addRadar
+    /// \return the echoes produced by the radar in the latest run
+    [[nodiscard]] const std::vector<Echo>& getEchoes(const size_t radar) const {
+      return sensors[radar]->getEchoes();
+    }
 
-    const double* inPower;
+    /// \see RadarModel::recordEchoes
+    ///
+    /// \param radar an index returned by addRadar
+    /// \param buffer the buffer to append the echoes to
+    void recordEchoes(const size_t radar, std::vector<uint8_t>& buffer) {
+      sensors[radar]->recordEchoes(buffer);
+    }
+
+  private:
+    std::vector<std::unique_ptr<RadarSensor>> sensors;
+
+    /// per frame state, kept to avoid allocating every frame
+    std::vector<RadarDetectionFrame> frames;
 
-    const double* inGain;
+    std::vector<detail::BlockGates> gates;
 
-    const double* inEffectiveArea;
+    std::vector<EntityHandle> candidateHandles;
+
+    std::vector<uint32_t> candidateIndices;
+
+  private:
+    const ReadHandle<EntityStore> inEnvironmentEntities;
 
-    const double* inMinimumDetectableSignal;
+    const ReadHandle<SpatialGrid> inEntityIndex;
 
-    std::queue<Echo>* outEchos;
+    const ReadHandle<RadarCrossSectionLibrary> inRadarCrossSections;
   };
 }
@@ -0,0 +1,27 @@
+#pragma once
+#include <TT/model.h>
+#include <TT/spatial_grid.h>
+#include "data.h"
+
+namespace tt::simship {
+  /// Keeps the spatial index of the environment channel up to date with its entities. Add this model after all models
+  /// which write entities and before the sensors which query the index.
+  class SpatialIndexModel final : public Model {
+  public:
+    explicit SpatialIndexModel(EnvironmentChannel& environmentChannel) :
+      Model("SpatialIndex", 0),
+      inEnvironmentEntities(environmentChannel.physicalEntities.getReadHandle(this)),
+      outEntityIndex(environmentChannel.entityIndex.getWriteHandle(this)) {
+    }
+
+    bool run() override {
+      outEntityIndex->synchronise(*inEnvironmentEntities);
+      return true;
+    }
+
+  private:
+    const ReadHandle<EntityStore> inEnvironmentEntities;
+
+    const WriteHandle<SpatialGrid> outEntityIndex;
+  };
+}
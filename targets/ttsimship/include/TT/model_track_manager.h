@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <TT/model.h>
+#include <TT/transform.h>
+#include <Eigen/Core>
+#include "data.h"
+#include "tracker.h"
+
+namespace tt::simship {
+  /// Maintains tracks from the echoes of a radar and publishes them on a track channel. Each run consumes the echoes
+  /// the radar has produced since the previous run as one scan, so add this model after the RadarModel and at the
+  /// same rate. Reading the scan count of the radar channel orders it after the radar in Parallel mode as well.
+  class TrackManagerModel final : public Model {
+  public:
+    TrackManagerModel(const OwnshipChannel& ownshipChannel, RadarChannel& radarChannel, TrackChannel& trackChannel,
+                      const TrackerParameters& parameters = {}) :
+      Model("TrackManager", 100),
+      tracker(parameters),
+      inAircraftPosition(ownshipChannel.aircraftPosition.getReadHandle(this)),
+      inAircraftRotation(ownshipChannel.aircraftRotation.getReadHandle(this)),
+      inRadarOffset(ownshipChannel.radarOffset.getReadHandle(this)),
+      inRadarRotation(ownshipChannel.radarRotation.getReadHandle(this)),
+      inEchoes(&radarChannel.echoes),
+      inScanCount(radarChannel.scanCount.getReadHandle(this)),
+      outTracks(trackChannel.tracks.getWriteHandle(this)) {
+    }
+
+    bool load() override {
+      ownshipXform = tt::Transform(*inAircraftPosition, *inAircraftRotation);
+      radarXform = tt::Transform(*inRadarOffset, *inRadarRotation);
+      radarXform.setParent(&ownshipXform);
+      echoes.resize(inEchoes->capacity());
+      return true;
+    }
+
+    bool init() override {
+      tracker.clear();
+      outTracks->clear();
+      return true;
+    }
+
+    bool run() override {
+      // The radar is where it was when it produced the echoes, as it reads the same inputs in the same frame
+      ownshipXform.setLocalTranslation(*inAircraftPosition);
+      ownshipXform.setLocalRotationEuler(*inAircraftRotation);
+      radarXform.setLocalTranslation(*inRadarOffset);
+      radarXform.setLocalRotationEuler(*inRadarRotation);
+      const Eigen::Matrix3d radarRotation = radarXform.getWorldRotationMatrix();
+      const Eigen::Vector3d radarPosition = radarXform.getWorldTranslation();
+
+      positions.clear();
+      size_t echoCount;
+      while ((echoCount = inEchoes->pop(echoes.data(), echoes.size())) > 0) {
+        for (size_t i = 0; i < echoCount; ++i) {
+          positions.push_back(Tracker::toWorldPosition(echoes[i], radarRotation, radarPosition));
+        }
+      }
+
+      tracker.update(positions, getDeltaTime());
+      *outTracks = tracker.getTracks();
+      return true;
+    }
+
+    bool saveState(std::vector<uint8_t>& buffer) const override {
+      appendBytes(buffer, tracker.getNextId());
+      Serialiser<std::vector<Track>>::write(tracker.getTracks(), buffer);
+      return true;
+    }
+
+    bool restoreState(ByteReader& reader) override {
+      uint32_t nextId;
+      std::vector<Track> tracks;
+      if (!reader.read(nextId) || !Serialiser<std::vector<Track>>::read(reader, tracks)) {
+        return false;
+      }
+      tracker.setTracks(std::move(tracks), nextId);
+      return true;
+    }
+
+  private:
+    Tracker tracker;
+
+    tt::Transform ownshipXform;
+
+    tt::Transform radarXform;
+
+    /// echoes and their world space positions, kept to avoid allocating every frame
+    std::vector<Echo> echoes;
+
+    std::vector<Eigen::Vector3d> positions;
+
+  private:
+    const ReadHandle<Eigen::Vector3d> inAircraftPosition;
+
+    const ReadHandle<Eigen::Vector3d> inAircraftRotation;
+
+    const ReadHandle<Eigen::Vector3d> inRadarOffset;
+
+    const ReadHandle<Eigen::Vector3d> inRadarRotation;
+
+    RingBuffer<Echo>* inEchoes;
+
+    /// only read to make the radar a predecessor of this model in the dependency graph
+    const ReadHandle<uint64_t> inScanCount;
+
+    const WriteHandle<std::vector<Track>> outTracks;
+  };
+}
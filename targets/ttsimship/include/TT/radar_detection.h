@@ -0,0 +1,316 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <Eigen/Core>
+
+#include "TT/entity_store.h"
+#include "TT/radar_cross_section.h"
+#include "data.h"
+
+namespace tt::simship {
+  /// Everything the detection kernel needs to know about a radar, computed once per frame.
+  struct RadarDetectionFrame {
+    /// rotation from world space into radar space, i.e. the transpose of the radar world rotation
+    Eigen::Matrix3d worldToRadar = Eigen::Matrix3d::Identity();
+
+    /// radar position in world space
+    Eigen::Vector3d radarPosition = Eigen::Vector3d::Zero();
+
+    /// velocity of the radar platform, in radar space
+    Eigen::Vector3d radarVelocity = Eigen::Vector3d::Zero();
+
+    double halfHorizontalFieldOfView = 0; // radian
+
+    double halfVerticalFieldOfView = 0; // radian
+
+    double power = 0; // watt
+
+    double gain = 0; // scalar
+
+    double effectiveArea = 0; // meters squared
+
+    double minimumDetectableSignal = 0; // watt
+
+    /// radar cross section of entities without a signature table, in meters squared
+    double radarCrossSection = 0;
+
+    /// aspect dependent radar cross sections by RadarCrossSectionSignatureIndex, optional
+    const RadarCrossSectionLibrary* signatures = nullptr;
+
+    /// \return the largest radar cross section any entity can have, in meters squared
+    [[nodiscard]] double getLargestRadarCrossSection() const {
+      return signatures == nullptr ? radarCrossSection : std::max<double>(radarCrossSection, signatures->getMaximum());
+    }
+
+    /// Distance beyond which the return power of a target with the largest radar cross section falls below the
+    /// minimum detectable signal, i.e. the radar equation solved for the distance.
+    [[nodiscard]] double getMaximumRange() const {
+      return std::pow((power * gain * getLargestRadarCrossSection() * effectiveArea) /
+                      (M_PI_4 * M_PI_4 * minimumDetectableSignal), 0.25);
+    }
+
+    /// Half angle of the cone around the boresight which encloses the field of view.
+    [[nodiscard]] double getConeHalfAngle() const {
+      if (halfHorizontalFieldOfView >= M_PI_2 || halfVerticalFieldOfView >= M_PI_2) {
+        return M_PI;
+      }
+      const double horizontal = std::tan(halfHorizontalFieldOfView);
+      const double vertical = std::tan(halfVerticalFieldOfView);
+      return std::atan(std::sqrt(horizontal * horizontal + vertical * vertical));
+    }
+
+    /// Builds the frame from the world space transform of a radar, assuming the transform is a pure rotation and
+    /// translation so that its inverse rotation is its transpose.
+    static RadarDetectionFrame fromWorldTransform(const Eigen::Matrix3d& radarRotation,
+                                                  const Eigen::Vector3d& radarTranslation,
+                                                  const Eigen::Vector3d& platformVelocity) {
+      RadarDetectionFrame frame;
+      frame.worldToRadar = radarRotation.transpose();
+      frame.radarPosition = radarTranslation;
+      frame.radarVelocity = frame.worldToRadar * platformVelocity;
+      return frame;
+    }
+  };
+
+  namespace detail {
+    /// Gates of a RadarDetectionFrame, evaluated in bulk for a block of entities.
+    struct BlockGates {
+      explicit BlockGates(const RadarDetectionFrame& frame) :
+        horizontalGated(frame.halfHorizontalFieldOfView < M_PI_2),
+        verticalGated(frame.halfVerticalFieldOfView < M_PI_2),
+        horizontalSlope(horizontalGated ? std::tan(frame.halfHorizontalFieldOfView) * (1 + slack) : 0),
+        verticalSlope(verticalGated ? std::tan(frame.halfVerticalFieldOfView) * (1 + slack) : 0),
+        maximumRangeSquared(frame.getMaximumRange() * frame.getMaximumRange() * (1 + slack)) {
+      }
+
+      /// Relative slack applied to the block gates, far larger than the rounding difference between both code paths
+      static constexpr double slack = 1e-9;
+
+      // Outside of +/- 90 degrees the angle gate cannot reject anything in front of the radar
+      const bool horizontalGated;
+
+      const bool verticalGated;
+
+      const double horizontalSlope;
+
+      const double verticalSlope;
+
+      const double maximumRangeSquared;
+    };
+
+    constexpr Eigen::Index blockSize = 256;
+
+    /// Detects the entities of one block, whose world positions have been loaded into worldX, worldY and worldZ.
+    /// The entity of block element i is entityAt(i).
+    template <typename EntityAt, typename EchoSink>
+    void detectBlock(const RadarDetectionFrame& frame, const BlockGates& gates, const EntityStore& entities,
+                     const double* worldX, const double* worldY, const double* worldZ, const Eigen::Index count,
+                     EntityAt&& entityAt, EchoSink&& sink) {
+      using Block = Eigen::Array<double, blockSize, 1>;
+      using BlockMask = Eigen::Array<bool, blockSize, 1>;
+      using Column = Eigen::Map<const Eigen::ArrayXd, Eigen::Aligned64>;
+
+      const Eigen::Matrix3d& m = frame.worldToRadar;
+      const Column columnX(worldX, count);
+      const Column columnY(worldY, count);
+      const Column columnZ(worldZ, count);
+      const auto dx = columnX - frame.radarPosition.x();
+      const auto dy = columnY - frame.radarPosition.y();
+      const auto dz = columnZ - frame.radarPosition.z();
+
+      Block localX;
+      Block localY;
+      Block localZ;
+      localX.head(count) = m(0, 0) * dx + m(0, 1) * dy + m(0, 2) * dz;
+      localY.head(count) = m(1, 0) * dx + m(1, 1) * dy + m(1, 2) * dz;
+      localZ.head(count) = m(2, 0) * dx + m(2, 1) * dy + m(2, 2) * dz;
+
+      const auto x = localX.head(count);
+      const auto y = localY.head(count);
+      const auto z = localZ.head(count);
+      BlockMask candidates;
+      candidates.head(count) = (x >= 0) && ((x * x + y * y + z * z) <= gates.maximumRangeSquared);
+      if (gates.horizontalGated) {
+        candidates.head(count) = candidates.head(count) && (y.abs() <= x * gates.horizontalSlope);
+      }
+      if (gates.verticalGated) {
+        candidates.head(count) = candidates.head(count) && (z.abs() <= x * gates.verticalSlope);
+      }
+
+      const auto velocities = entities.getVelocities();
+      const auto orientations = entities.getOrientations();
+      const int16_t* signatureIndices = entities.getRadarCrossSectionSignatureIndices();
+      for (Eigen::Index i = 0; i < count; ++i) {
+        if (!candidates(i)) {
+          continue;
+        }
+        const Eigen::Vector3d otherOffset(localX(i), localY(i), localZ(i));
+
+        const double horizontalAngle = std::atan2(otherOffset.y(), otherOffset.x());
+        const double verticalAngle = std::atan2(otherOffset.z(), otherOffset.x());
+        if (std::abs(horizontalAngle) > frame.halfHorizontalFieldOfView ||
+            std::abs(verticalAngle) > frame.halfVerticalFieldOfView) {
+          continue;
+        }
+
+        // Only the few entities within the field of view pay for the aspect lookup
+        const size_t entity = entityAt(i);
+        double radarCrossSection = frame.radarCrossSection;
+        const RadarCrossSectionTable* signature =
+          frame.signatures == nullptr ? nullptr : frame.signatures->find(signatureIndices[entity]);
+        if (signature != nullptr) {
+          radarCrossSection = signature->lookup(orientations.x[entity], orientations.y[entity], orientations.z[entity],
+                                                frame.radarPosition.x() - worldX[i],
+                                                frame.radarPosition.y() - worldY[i],
+                                                frame.radarPosition.z() - worldZ[i]);
+        }
+
+        const double distance = otherOffset.norm();
+        const double returnPower = ((frame.power * frame.gain) / (M_PI_4 * (distance * distance)))
+          * radarCrossSection
+          * (1.0 / (M_PI_4 * (distance * distance)))
+          * frame.effectiveArea;
+        if (returnPower < frame.minimumDetectableSignal) {
+          continue;
+        }
+
+        const Eigen::Vector3d entityWorldVelocity(velocities.x[entity], velocities.y[entity], velocities.z[entity]);
+        const Eigen::Vector3d entityVelocityRelativeToRadar(m * entityWorldVelocity - frame.radarVelocity);
+
+        Echo radarEcho;
+        radarEcho.range = distance;
+        radarEcho.horizontalAngle = horizontalAngle;
+        radarEcho.verticalAngle = verticalAngle;
+        radarEcho.radialVelocity = entityVelocityRelativeToRadar.x();
+        radarEcho.returnPower = returnPower;
+        sink(radarEcho);
+      }
+    }
+
+    /// Computes the block gates of every frame into a buffer owned by the caller, which only allocates while the
+    /// number of radars grows.
+    inline void makeGates(const RadarDetectionFrame* frames, const size_t frameCount, std::vector<BlockGates>& gates) {
+      gates.clear();
+      for (size_t radar = 0; radar < frameCount; ++radar) {
+        gates.emplace_back(frames[radar]);
+      }
+    }
+
+    /// Detects the entities of the store against every frame, one block of entities at a time. The positions of a
+    /// block are loaded once and stay in the cache while every radar is tested against them.
+    ///
+    /// \param gates the gates of every frame, see makeGates
+    template <typename EchoSink>
+    void detectAll(const RadarDetectionFrame* frames, const BlockGates* gates, const size_t frameCount,
+                   const EntityStore& entities, EchoSink&& sink) {
+      const auto positions = entities.getPositions();
+      const auto entityCount = static_cast<Eigen::Index>(entities.size());
+
+      for (Eigen::Index begin = 0; begin < entityCount; begin += blockSize) {
+        const auto entityAt = [begin](const Eigen::Index i) { return static_cast<size_t>(begin + i); };
+        for (size_t radar = 0; radar < frameCount; ++radar) {
+          detectBlock(frames[radar], gates[radar], entities, positions.x + begin, positions.y + begin,
+                      positions.z + begin, std::min(blockSize, entityCount - begin), entityAt,
+                      [&sink, radar](const Echo& echo) { sink(radar, echo); });
+        }
+      }
+    }
+
+    /// \see detectAll(const RadarDetectionFrame*, const BlockGates*, size_t, const EntityStore&, EchoSink&&)
+    template <typename EchoSink>
+    void detectAll(const RadarDetectionFrame* frames, const BlockGates* gates, const size_t frameCount,
+                   const EntityStore& entities, const std::vector<uint32_t>& indices, EchoSink&& sink) {
+      const auto positions = entities.getPositions();
+      const auto indexCount = static_cast<Eigen::Index>(indices.size());
+
+      alignas(64) double worldX[blockSize];
+      alignas(64) double worldY[blockSize];
+      alignas(64) double worldZ[blockSize];
+      for (Eigen::Index begin = 0; begin < indexCount; begin += blockSize) {
+        const Eigen::Index count = std::min(blockSize, indexCount - begin);
+        for (Eigen::Index i = 0; i < count; ++i) {
+          const uint32_t entity = indices[begin + i];
+          worldX[i] = positions.x[entity];
+          worldY[i] = positions.y[entity];
+          worldZ[i] = positions.z[entity];
+        }
+        const auto entityAt = [&indices, begin](const Eigen::Index i) { return indices[begin + i]; };
+        for (size_t radar = 0; radar < frameCount; ++radar) {
+          detectBlock(frames[radar], gates[radar], entities, worldX, worldY, worldZ, count, entityAt,
+                      [&sink, radar](const Echo& echo) { sink(radar, echo); });
+        }
+      }
+    }
+  }
+
+  /// Tests all entities of the store against the radar and passes an Echo for every detected entity to the sink.
+  ///
+  /// Entities are processed in blocks. For each block, the offsets to the radar, the field of view gates and a range
+  /// gate derived from the radar equation are evaluated with Eigen array expressions, which are vectorised for the
+  /// instruction set the library is compiled for (see TTSIM_ARCH). The gates are deliberately a little wider than the
+  /// exact tests, so that only the few entities which pass them are checked again with the scalar arithmetic of the per
+  /// entity model. The results only differ from it by the rounding of the transposed rather than inverted rotation.
+  /// The range gate assumes the largest radar cross section of the frame, the aspect dependent radar cross section of
+  /// an entity with a signature table is only looked up once it is known to be within the field of view.
+  ///
+  /// \param frame the radar parameters of this frame
+  /// \param entities the entities to test
+  /// \param sink a callable invoked as sink(const Echo&) for every detection, in entity order
+  template <typename EchoSink>
+  void detectEchoes(const RadarDetectionFrame& frame, const EntityStore& entities, EchoSink&& sink) {
+    const detail::BlockGates gates(frame);
+    detail::detectAll(&frame, &gates, 1, entities, [&sink](size_t, const Echo& echo) { sink(echo); });
+  }
+
+  /// Tests a subset of the entities of the store against the radar, e.g. the candidates returned by a spatial index.
+  ///
+  /// \see detectEchoes(const RadarDetectionFrame&, const EntityStore&, EchoSink&&)
+  ///
+  /// \param frame the radar parameters of this frame
+  /// \param entities the entities to test
+  /// \param indices dense indices of the entities to test. Sorted indices give the best memory access pattern.
+  /// \param sink a callable invoked as sink(const Echo&) for every detection, in the order of indices
+  template <typename EchoSink>
+  void detectEchoes(const RadarDetectionFrame& frame, const EntityStore& entities,
+                    const std::vector<uint32_t>& indices, EchoSink&& sink) {
+    const detail::BlockGates gates(frame);
+    detail::detectAll(&frame, &gates, 1, entities, indices, [&sink](size_t, const Echo& echo) { sink(echo); });
+  }
+
+  /// Tests all entities of the store against several radars in a single pass over the entities, so the memory traffic
+  /// does not grow with the number of radars. Each radar sees the same echoes as it would on its own.
+  ///
+  /// The gates of the radars are allocated on every call. Models which evaluate the radars every frame keep them with
+  /// detail::makeGates and call detail::detectAll instead.
+  ///
+  /// \see detectEchoes(const RadarDetectionFrame&, const EntityStore&, EchoSink&&)
+  ///
+  /// \param frames the parameters of every radar in this frame
+  /// \param entities the entities to test
+  /// \param sink a callable invoked as sink(size_t radar, const Echo&) for every detection, where radar indexes
+  /// frames. The echoes of each radar are in entity order.
+  template <typename EchoSink>
+  void detectEchoes(const std::vector<RadarDetectionFrame>& frames, const EntityStore& entities, EchoSink&& sink) {
+    std::vector<detail::BlockGates> gates;
+    detail::makeGates(frames.data(), frames.size(), gates);
+    detail::detectAll(frames.data(), gates.data(), frames.size(), entities, sink);
+  }
+
+  /// Tests a subset of the entities of the store against several radars in a single pass, e.g. the union of the
+  /// candidates of every radar returned by a spatial index.
+  ///
+  /// \see detectEchoes(const std::vector<RadarDetectionFrame>&, const EntityStore&, EchoSink&&)
+  ///
+  /// \param frames the parameters of every radar in this frame
+  /// \param entities the entities to test
+  /// \param indices dense indices of the entities to test. Sorted indices give the best memory access pattern.
+  /// \param sink a callable invoked as sink(size_t radar, const Echo&) for every detection, in the order of indices
+  template <typename EchoSink>
+  void detectEchoes(const std::vector<RadarDetectionFrame>& frames, const EntityStore& entities,
+                    const std::vector<uint32_t>& indices, EchoSink&& sink) {
+    std::vector<detail::BlockGates> gates;
+    detail::makeGates(frames.data(), frames.size(), gates);
+    detail::detectAll(frames.data(), gates.data(), frames.size(), entities, indices, sink);
+  }
+}
@@ -0,0 +1,231 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <Eigen/Core>
+#include "data.h"
+
+namespace tt::simship {
+  struct TrackerParameters {
+    /// largest distance between the predicted position of a track and an echo associated with it, in meters
+    double gateDistance = 500;
+
+    /// share of the residual added to the predicted position of a track
+    double alpha = 0.5;
+
+    /// share of the residual, divided by the scan interval, added to the velocity of a track
+    double beta = 0.2;
+
+    /// number of associated scans after which a track is confirmed
+    uint16_t confirmationHitCount = 3;
+
+    /// number of consecutive scans without an associated echo after which a confirmed track is dropped. Tentative
+    /// tracks are dropped on their first miss.
+    uint16_t maximumMissCount = 3;
+  };
+
+  /// Track-while-scan: associates the echoes of each scan with tracks and smooths the tracks with alpha-beta filters.
+  ///
+  /// Association is global nearest neighbour within a distance gate. The predicted tracks are binned into a sorted
+  /// grid of cells as large as the gate, so each echo is only compared with the tracks of its 27 neighbouring cells and
+  /// a scan costs O((echoes + tracks) log tracks) rather than O(echoes * tracks).
+  class Tracker {
+  public:
+    explicit Tracker(const TrackerParameters& parameters = {}) :
+      parameters(parameters) {
+    }
+
+    /// Converts an echo into a world space position.
+    ///
+    /// \param echo the echo, relative to the radar which produced it
+    /// \param radarRotation world space rotation of the radar when it produced the echo
+    /// \param radarPosition world space position of the radar when it produced the echo
+    /// \return the world space position of the echo
+    static Eigen::Vector3d toWorldPosition(const Echo& echo, const Eigen::Matrix3d& radarRotation,
+                                           const Eigen::Vector3d& radarPosition) {
+      // The angles of an echo are measured in the horizontal and vertical plane of the radar, in front of it
+      const Eigen::Vector3d direction =
+        Eigen::Vector3d(1, std::tan(echo.horizontalAngle), std::tan(echo.verticalAngle)).normalized();
+      return radarPosition + radarRotation * (direction * echo.range);
+    }
+
+    /// Predicts all tracks to the time of the scan, associates the echoes of the scan with them and starts tentative
+    /// tracks for the echoes which were not associated.
+    ///
+    /// \param positions world space positions of the echoes of the scan
+    /// \param deltaTime seconds since the previous scan
+    void update(const std::vector<Eigen::Vector3d>& positions, const double deltaTime) {
+      const double inverseDeltaTime = deltaTime > 0 ? 1 / deltaTime : 0;
+      const double gateSquared = parameters.gateDistance * parameters.gateDistance;
+      const double inverseCellSize = 1 / parameters.gateDistance;
+
+      // Predict and bin the tracks
+      cells.clear();
+      for (uint32_t i = 0; i < tracks.size(); ++i) {
+        Track& track = tracks[i];
+        track.x += track.velocityX * deltaTime;
+        track.y += track.velocityY * deltaTime;
+        track.z += track.velocityZ * deltaTime;
+        cells.emplace_back(getCellKey(getCell(track.x, inverseCellSize), getCell(track.y, inverseCellSize),
+                                      getCell(track.z, inverseCellSize)), i);
+      }
+      std::sort(cells.begin(), cells.end());
+
+      // Every pair within the gate, found through the neighbouring cells of each echo
+      candidates.clear();
+      for (uint32_t echo = 0; echo < positions.size(); ++echo) {
+        const Eigen::Vector3d& position = positions[echo];
+        const int64_t cellX = getCell(position.x(), inverseCellSize);
+        const int64_t cellY = getCell(position.y(), inverseCellSize);
+        const int64_t cellZ = getCell(position.z(), inverseCellSize);
+        for (int64_t offsetX = -1; offsetX <= 1; ++offsetX) {
+          for (int64_t offsetY = -1; offsetY <= 1; ++offsetY) {
+            for (int64_t offsetZ = -1; offsetZ <= 1; ++offsetZ) {
+              const uint64_t key = getCellKey(cellX + offsetX, cellY + offsetY, cellZ + offsetZ);
+              auto cell = std::lower_bound(cells.begin(), cells.end(), std::make_pair(key, uint32_t(0)));
+              for (; cell != cells.end() && cell->first == key; ++cell) {
+                const Track& track = tracks[cell->second];
+                const double distanceSquared = (position - Eigen::Vector3d(track.x, track.y, track.z)).squaredNorm();
+                if (distanceSquared <= gateSquared) {
+                  candidates.push_back({distanceSquared, echo, cell->second});
+                }
+              }
+            }
+          }
+        }
+      }
+
+      // Closest pairs first, each echo and each track is associated at most once
+      std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return std::tie(a.distanceSquared, a.echo, a.track) < std::tie(b.distanceSquared, b.echo, b.track);
+      });
+      echoAssociated.assign(positions.size(), false);
+      trackAssociated.assign(tracks.size(), false);
+      for (const Candidate& candidate : candidates) {
+        if (echoAssociated[candidate.echo] || trackAssociated[candidate.track]) {
+          continue;
+        }
+        echoAssociated[candidate.echo] = true;
+        trackAssociated[candidate.track] = true;
+        correct(tracks[candidate.track], positions[candidate.echo], inverseDeltaTime);
+      }
+
+      // Misses drop tentative tracks right away and confirmed tracks once they have been lost for too long
+      size_t kept = 0;
+      for (size_t i = 0; i < tracks.size(); ++i) {
+        Track& track = tracks[i];
+        if (!trackAssociated[i]) {
+          ++track.missCount;
+          if (!track.confirmed || track.missCount > parameters.maximumMissCount) {
+            continue;
+          }
+        }
+        tracks[kept++] = track;
+      }
+      tracks.resize(kept);
+
+      for (uint32_t echo = 0; echo < positions.size(); ++echo) {
+        if (!echoAssociated[echo]) {
+          Track track;
+          track.id = nextId++;
+          track.hitCount = 1;
+          track.confirmed = parameters.confirmationHitCount <= 1;
+          track.x = positions[echo].x();
+          track.y = positions[echo].y();
+          track.z = positions[echo].z();
+          tracks.push_back(track);
+        }
+      }
+    }
+
+    /// \return the tentative and confirmed tracks, ordered by id
+    [[nodiscard]] const std::vector<Track>& getTracks() const {
+      return tracks;
+    }
+
+    /// Replaces all tracks, e.g. to restore a snapshot.
+    ///
+    /// \param restoredTracks tracks ordered by id
+    /// \param restoredNextId the id of the next track, larger than all ids of restoredTracks
+    void setTracks(std::vector<Track> restoredTracks, const uint32_t restoredNextId) {
+      tracks = std::move(restoredTracks);
+      nextId = restoredNextId;
+    }
+
+    /// \return the id of the next track
+    [[nodiscard]] uint32_t getNextId() const {
+      return nextId;
+    }
+
+    void clear() {
+      tracks.clear();
+      nextId = 1;
+    }
+
+  private:
+    struct Candidate {
+      double distanceSquared;
+
+      uint32_t echo;
+
+      uint32_t track;
+    };
+
+    static int64_t getCell(const double coordinate, const double inverseCellSize) {
+      return static_cast<int64_t>(std::floor(coordinate * inverseCellSize));
+    }
+
+    /// Packs 21 bits of each cell coordinate. Cells which wrap onto the same key only cost extra distance tests.
+    static uint64_t getCellKey(const int64_t x, const int64_t y, const int64_t z) {
+      constexpr uint64_t mask = (uint64_t(1) << 21) - 1;
+      return ((static_cast<uint64_t>(x) & mask) << 42) | ((static_cast<uint64_t>(y) & mask) << 21) |
+        (static_cast<uint64_t>(z) & mask);
+    }
+
+    void correct(Track& track, const Eigen::Vector3d& position, const double inverseDeltaTime) const {
+      const double residualX = position.x() - track.x;
+      const double residualY = position.y() - track.y;
+      const double residualZ = position.z() - track.z;
+      if (track.hitCount == 1) {
+        // The second echo initialises the velocity of the track from the two positions
+        track.x = position.x();
+        track.y = position.y();
+        track.z = position.z();
+        track.velocityX = residualX * inverseDeltaTime;
+        track.velocityY = residualY * inverseDeltaTime;
+        track.velocityZ = residualZ * inverseDeltaTime;
+      }
+      else {
+        const double velocityGain = parameters.beta * inverseDeltaTime;
+        track.x += parameters.alpha * residualX;
+        track.y += parameters.alpha * residualY;
+        track.z += parameters.alpha * residualZ;
+        track.velocityX += velocityGain * residualX;
+        track.velocityY += velocityGain * residualY;
+        track.velocityZ += velocityGain * residualZ;
+      }
+      track.hitCount = static_cast<uint16_t>(std::min<int>(track.hitCount + 1, UINT16_MAX));
+      track.missCount = 0;
+      track.confirmed = track.confirmed || track.hitCount >= parameters.confirmationHitCount;
+    }
+
+    const TrackerParameters parameters;
+
+    /// tracks ordered by id
+    std::vector<Track> tracks;
+
+    uint32_t nextId = 1;
+
+    /// per scan state, kept to avoid allocating every scan
+    std::vector<std::pair<uint64_t, uint32_t>> cells;
+
+    std::vector<Candidate> candidates;
+
+    std::vector<bool> echoAssociated;
+
+    std::vector<bool> trackAssociated;
+  };
+}
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <TT/logging.h>
+
+#include "TT/batch_runner.h"
+
+/// Runs a Monte Carlo batch of engagements, varying the radar parameters of each run, and writes the results to a
+/// binary file in the format of tt::simship::BatchRunner.
+///
+/// Usage: simshipBatch <output file> [run count] [batch seed]
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <output file> [run count] [batch seed]\n", argv[0]);
+        return 1;
+    }
+    const uint32_t runCount = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 1000;
+    const uint64_t batchSeed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1;
+
+    // Every run requests bus data handles, which would otherwise flood the log
+    tt::log::setLevel(tt::log::Warning);
+
+    std::FILE* output = std::fopen(argv[1], "wb");
+    if (output == nullptr) {
+        std::fprintf(stderr, "Failed to open %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<tt::simship::EngagementRun> runs(runCount);
+    for (uint32_t i = 0; i < runCount; ++i) {
+        tt::simship::EngagementRun& run = runs[i];
+        run.index = i;
+        run.seed = tt::simship::BatchRunner::getRunSeed(batchSeed, i);
+
+        // Drawn from a seed derived from the run seed, so the parameters do not correlate with the target placement
+        std::mt19937_64 random(tt::simship::BatchRunner::getRunSeed(run.seed, 0));
+        std::uniform_real_distribution<double> unit(0, 1);
+        run.power = 500 + unit(random) * 4500;
+        run.gain = 1 + unit(random) * 3;
+        run.minimumDetectableSignal = std::pow(10.0, -14 + unit(random) * 2);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    tt::simship::BatchRunner runner;
+    const std::vector<tt::simship::EngagementResult> results =
+        runner.run(tt::simship::EngagementScenario(), runs, output);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const bool closed = std::fclose(output) == 0;
+
+    size_t failed = 0;
+    for (const auto& result : results) {
+        failed += result.succeeded ? 0 : 1;
+    }
+    std::printf("%u runs (%zu failed) in %.2f s\n", runCount, failed, elapsed.count());
+    tt::log::flush();
+    return failed == 0 && closed ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <set>
+#include <vector>
+
+#include "TT/batch_runner.h"
+
+namespace {
+  tt::simship::EngagementScenario getShortScenario() {
+    tt::simship::EngagementScenario scenario;
+    scenario.duration = std::chrono::seconds(10);
+    scenario.targetCount = 20;
+    return scenario;
+  }
+
+  std::vector<tt::simship::EngagementRun> getRuns(const uint32_t count, const uint64_t batchSeed) {
+    std::vector<tt::simship::EngagementRun> runs(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      runs[i].index = i;
+      runs[i].seed = tt::simship::BatchRunner::getRunSeed(batchSeed, i);
+    }
+    return runs;
+  }
+}
+
+TEST(BatchRunner, RunSeedsDiffer) {
+  std::set<uint64_t> seeds;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    seeds.insert(tt::simship::BatchRunner::getRunSeed(1, i));
+  }
+  ASSERT_EQ(1000, seeds.size());
+  ASSERT_EQ(tt::simship::BatchRunner::getRunSeed(1, 7), tt::simship::BatchRunner::getRunSeed(1, 7));
+  ASSERT_NE(tt::simship::BatchRunner::getRunSeed(1, 7), tt::simship::BatchRunner::getRunSeed(2, 7));
+}
+
+TEST(BatchRunner, EngagementIsReproducible) {
+  const auto scenario = getShortScenario();
+  tt::simship::EngagementRun run;
+  run.seed = 42;
+
+  const auto first = tt::simship::runEngagement(scenario, run);
+  const auto second = tt::simship::runEngagement(scenario, run);
+  ASSERT_TRUE(first.succeeded);
+  ASSERT_GT(first.detectionCount, 0);
+  ASSERT_EQ(first.detectionCount, second.detectionCount);
+  ASSERT_EQ(first.firstDetectionTime, second.firstDetectionTime);
+  ASSERT_EQ(first.firstDetectionRange, second.firstDetectionRange);
+  ASSERT_EQ(first.maximumDetectionRange, second.maximumDetectionRange);
+}
+
+TEST(BatchRunner, MorePowerDetectsFurther) {
+  const auto scenario = getShortScenario();
+  tt::simship::EngagementRun weak;
+  weak.seed = 42;
+  weak.power = 100;
+  tt::simship::EngagementRun strong = weak;
+  strong.power = 10000;
+
+  const auto weakResult = tt::simship::runEngagement(scenario, weak);
+  const auto strongResult = tt::simship::runEngagement(scenario, strong);
+  ASSERT_GT(strongResult.detectionCount, weakResult.detectionCount);
+  ASSERT_GT(strongResult.maximumDetectionRange, weakResult.maximumDetectionRange);
+}
+
+TEST(BatchRunner, NoTargetsNoDetections) {
+  auto scenario = getShortScenario();
+  scenario.targetCount = 0;
+
+  const auto result = tt::simship::runEngagement(scenario, tt::simship::EngagementRun());
+  ASSERT_TRUE(result.succeeded);
+  ASSERT_EQ(0, result.detectionCount);
+  ASSERT_TRUE(std::isnan(result.firstDetectionRange));
+}
+
+TEST(BatchRunner, ParallelRunsMatchSequentialRuns) {
+  const auto scenario = getShortScenario();
+  const auto runs = getRuns(16, 3);
+
+  tt::simship::BatchRunner runner(4);
+  const auto results = runner.run(scenario, runs);
+  ASSERT_EQ(runs.size(), results.size());
+  for (size_t i = 0; i < runs.size(); ++i) {
+    const auto expected = tt::simship::runEngagement(scenario, runs[i]);
+    ASSERT_TRUE(results[i].succeeded);
+    ASSERT_EQ(runs[i].index, results[i].run.index);
+    ASSERT_EQ(expected.detectionCount, results[i].detectionCount);
+    ASSERT_EQ(expected.maximumDetectionRange, results[i].maximumDetectionRange);
+  }
+}
+
+TEST(BatchRunner, WritesResultFile) {
+  const auto scenario = getShortScenario();
+  auto runs = getRuns(8, 5);
+  runs[3].power = 2500;
+
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(nullptr, file);
+  tt::simship::BatchRunner runner(2);
+  const auto results = runner.run(scenario, runs, file);
+
+  ASSERT_EQ(tt::simship::BatchRunner::headerSize + runs.size() * tt::simship::BatchRunner::recordSize,
+            std::ftell(file));
+  std::rewind(file);
+  std::vector<tt::simship::EngagementResult> read;
+  ASSERT_TRUE(tt::simship::BatchRunner::readResults(file, read));
+  std::fclose(file);
+
+  // Records are written in the order the runs complete
+  ASSERT_EQ(runs.size(), read.size());
+  for (const auto& record : read) {
+    const auto& expected = results[record.run.index];
+    ASSERT_EQ(expected.run.seed, record.run.seed);
+    ASSERT_EQ(expected.run.power, record.run.power);
+    ASSERT_EQ(expected.run.minimumDetectableSignal, record.run.minimumDetectableSignal);
+    ASSERT_EQ(expected.detectionCount, record.detectionCount);
+    ASSERT_EQ(expected.firstDetectionTime, record.firstDetectionTime);
+    ASSERT_EQ(expected.maximumDetectionRange, record.maximumDetectionRange);
+    ASSERT_TRUE(record.succeeded);
+  }
+}
+
+TEST(BatchRunner, RejectsForeignFile) {
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(nullptr, file);
+  std::fputs("not a result file", file);
+  std::rewind(file);
+  std::vector<tt::simship::EngagementResult> read;
+  ASSERT_FALSE(tt::simship::BatchRunner::readResults(file, read));
+  std::fclose(file);
+}
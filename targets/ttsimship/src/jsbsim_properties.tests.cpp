@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include "TT/jsbsim_properties.h"
+
+TEST(PropertyBindings, CopiesBetweenBusDataAndProperties) {
+  JSBSim::FGPropertyManager properties;
+  properties.GetNode("fcs/aileron-cmd-norm", true)->setDoubleValue(0);
+  properties.GetNode("position/h-sl-meters", true)->setDoubleValue(1200);
+
+  tt::BusData<double> aileron(0.25, "Aileron");
+  tt::BusData<double> altitude(0, "Altitude");
+  tt::simship::PropertyBindings bindings;
+  bindings.addInput("fcs/aileron-cmd-norm", aileron.getReadHandle());
+  bindings.addOutput("position/h-sl-meters", altitude.getWriteHandle());
+  ASSERT_TRUE(bindings.resolve(properties));
+
+  bindings.writeInputs();
+  ASSERT_EQ(0.25, properties.GetNode("fcs/aileron-cmd-norm")->getDoubleValue());
+  bindings.readOutputs();
+  ASSERT_EQ(1200, *altitude.getReadHandle());
+
+  // Changes after resolving are seen through the bound nodes
+  properties.GetNode("position/h-sl-meters")->setDoubleValue(1300);
+  bindings.readOutputs();
+  ASSERT_EQ(1300, *altitude.getReadHandle());
+}
+
+TEST(PropertyBindings, FailsOnUnknownProperty) {
+  JSBSim::FGPropertyManager properties;
+  tt::BusData<double> rudder(0, "Rudder");
+  tt::simship::PropertyBindings bindings;
+  bindings.addInput("fcs/no-such-property", rudder.getReadHandle());
+  ASSERT_FALSE(bindings.resolve(properties));
+
+  tt::simship::PropertyBinding binding("fcs/no-such-property");
+  ASSERT_FALSE(binding.resolve(properties));
+}
@@ -1,8 +1,14 @@
 #include <thread>
+#include <TT/recorder.h>
 #include <TT/simulation.h>
 
 #include "TT/model_radar.h"
 #include "TT/model_flight_dynamics.h"
+#include "TT/model_dead_reckoning.h"
+#include "TT/model_dis_ingest.h"
+#include "TT/model_interest_management.h"
+#include "TT/model_spatial_index.h"
+#include "TT/model_track_manager.h"
 
 #include <JSBSim/initialization/FGInitialCondition.h>
 
@@ -11,14 +17,58 @@ int main(int argc, char* argv[]) {
 
     tt::simship::OwnshipChannel ownshipChannel;
     tt::simship::EnvironmentChannel environmentChannel;
+    tt::simship::RadarChannel radarChannel;
+    tt::simship::TrackChannel trackChannel;
 
     tt::simship::AircraftModel flightDynamics(ownshipChannel);
-    tt::simship::RadarModel shipRadar(ownshipChannel, environmentChannel);
+    tt::simship::DisIngestModel disIngest(environmentChannel, 3000);
+    tt::simship::DeadReckoningModel deadReckoning(environmentChannel);
+    tt::simship::SpatialIndexModel spatialIndex(environmentChannel);
+    tt::simship::RadarModel shipRadar(ownshipChannel, environmentChannel, radarChannel);
+    // The views are only read by the radar, so they are updated at its rate
+    tt::simship::InterestManagementModel interestManagement(environmentChannel, shipRadar.getTargetFrameInterval());
+    shipRadar.setInterest(interestManagement.subscribeRadar(ownshipChannel, radarChannel));
+    tt::simship::TrackManagerModel trackManager(ownshipChannel, radarChannel, trackChannel);
 
     simulation.addModel(flightDynamics);
+    simulation.addModel(disIngest);
+    simulation.addModel(deadReckoning);
+    simulation.addModel(spatialIndex);
+    simulation.addModel(interestManagement);
     simulation.addModel(shipRadar);
+    simulation.addModel(trackManager);
+    simulation.setTimingReport(std::chrono::seconds(10));
+
+    // simship [recording [signatures]] loads the radar cross section tables of the platforms
+    if (argc > 2 && !environmentChannel.radarCrossSections.getWriteHandle()->load(argv[2])) {
+        return 1;
+    }
+
+    // simship [recording] records every frame for offline replay. The entity index is rebuilt from the entities.
+    tt::Recorder recorder;
+    if (argc > 1) {
+        for (const tt::BusDataBase* busData : std::initializer_list<const tt::BusDataBase*>{
+                 &ownshipChannel.aircraftPosition, &ownshipChannel.aircraftRotation, &ownshipChannel.aircraftVelocity,
+                 &ownshipChannel.aircraftAltitude, &ownshipChannel.radarOffset, &ownshipChannel.radarRotation,
+                 &ownshipChannel.aileronCommand, &ownshipChannel.elevatorCommand, &ownshipChannel.rudderCommand,
+                 &ownshipChannel.throttleCommand, &environmentChannel.physicalEntities,
+                 &radarChannel.horizontalFieldOfView, &radarChannel.verticalFieldOfView, &radarChannel.power,
+                 &radarChannel.gain, &radarChannel.effectiveArea, &radarChannel.minimumDetectableSignal,
+                 &trackChannel.tracks}) {
+            recorder.addBusData(*busData);
+        }
+        recorder.addStream("Radar.Echoes", [&shipRadar](std::vector<uint8_t>& buffer) {
+            shipRadar.recordEchoes(buffer);
+        });
+        if (!recorder.open(argv[1])) {
+            return 1;
+        }
+        simulation.addFrameListener([&recorder](const std::chrono::nanoseconds simulationTime) {
+            recorder.recordFrame(simulationTime);
+        });
+    }
     simulation.setTargetState(tt::Simulation::Running);
-    std::thread mainThread(&tt::Simulation::main, simulation);
+    std::thread mainThread(&tt::Simulation::main, &simulation);
 
     // TODO: Write command input code here.
 
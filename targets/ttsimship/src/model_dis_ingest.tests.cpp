@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "TT/model_dis_ingest.h"
+
+namespace {
+  /// Sends Entity State PDUs to the ingest model over loopback and waits until they were received
+  class PduGenerator {
+  public:
+    explicit PduGenerator(const tt::simship::DisIngestModel& model) :
+      model_(model),
+      socket_(socket(AF_INET, SOCK_DGRAM, 0)) {
+      destination_.sin_family = AF_INET;
+      destination_.sin_port = htons(model.getReceiver().getPort());
+      inet_pton(AF_INET, "127.0.0.1", &destination_.sin_addr);
+    }
+
+    ~PduGenerator() {
+      close(socket_);
+    }
+
+    void send(const uint16_t entityNumber, const double x, const bool deactivated = false) {
+      tt::dis::EntityState state;
+      state.entity.EntityIdentifier = {{1, 1}, entityNumber};
+      state.entity.Spatial.SpatialRVW.WorldLocation.X = x;
+      state.deactivated = deactivated;
+      uint8_t pdu[tt::dis::entityStatePduSize];
+      tt::dis::encodeEntityState(state, pdu, sizeof(pdu));
+      sendto(socket_, pdu, sizeof(pdu), 0, reinterpret_cast<const sockaddr*>(&destination_), sizeof(destination_));
+      ++sent_;
+
+      const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (model_.getReceiver().getEntityStateCount() < sent_ && std::chrono::steady_clock::now() < timeout) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+
+  private:
+    const tt::simship::DisIngestModel& model_;
+
+    int socket_;
+
+    sockaddr_in destination_{};
+
+    uint64_t sent_ = 0;
+  };
+}
+
+TEST(DisIngest, AppliesEntityStateUpdates) {
+  tt::simship::EnvironmentChannel environmentChannel;
+  tt::simship::DisIngestModel disIngest(environmentChannel, 0, "127.0.0.1");
+  ASSERT_TRUE(disIngest.init());
+  PduGenerator generator(disIngest);
+  const auto entities = environmentChannel.physicalEntities.getReadHandle();
+
+  generator.send(1, 100);
+  generator.send(2, 200);
+  ASSERT_TRUE(disIngest.run());
+  ASSERT_EQ(2, entities->size());
+
+  generator.send(1, 150);
+  generator.send(2, 0, true);
+  ASSERT_TRUE(disIngest.run());
+  ASSERT_EQ(1, entities->size());
+  const auto entity = entities->get(entities->handleAt(0));
+  ASSERT_EQ(1, entity.EntityIdentifier.EntityNumber);
+  ASSERT_EQ(150, entity.Spatial.SpatialRVW.WorldLocation.X);
+
+  ASSERT_TRUE(disIngest.unload());
+}
+
+TEST(DisIngest, RestoredStateUpdatesKnownEntities) {
+  tt::simship::EnvironmentChannel environmentChannel;
+  tt::simship::DisIngestModel disIngest(environmentChannel, 0, "127.0.0.1");
+  ASSERT_TRUE(disIngest.init());
+  PduGenerator generator(disIngest);
+  const auto entities = environmentChannel.physicalEntities.getReadHandle();
+
+  generator.send(1, 100);
+  ASSERT_TRUE(disIngest.run());
+  std::vector<uint8_t> entitiesState;
+  std::vector<uint8_t> modelState;
+  entities->serialise(entitiesState);
+  ASSERT_TRUE(disIngest.saveState(modelState));
+
+  // After restoring, entity 1 is updated rather than added a second time, and entity 2 is unknown again
+  generator.send(2, 200);
+  ASSERT_TRUE(disIngest.run());
+  tt::ByteReader entitiesReader(entitiesState.data(), entitiesState.size());
+  ASSERT_TRUE(environmentChannel.physicalEntities.getWriteHandle()->deserialise(entitiesReader));
+  tt::ByteReader modelReader(modelState.data(), modelState.size());
+  ASSERT_TRUE(disIngest.restoreState(modelReader));
+
+  generator.send(1, 150);
+  generator.send(2, 250);
+  ASSERT_TRUE(disIngest.run());
+  ASSERT_EQ(2, entities->size());
+  ASSERT_EQ(150, entities->get(entities->handleAt(0)).Spatial.SpatialRVW.WorldLocation.X);
+  ASSERT_EQ(250, entities->get(entities->handleAt(1)).Spatial.SpatialRVW.WorldLocation.X);
+
+  ASSERT_TRUE(disIngest.unload());
+}
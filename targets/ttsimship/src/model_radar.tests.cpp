@@ -1,13 +1,19 @@
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <vector>
+
 #include <Eigen/Core>
 
+#include "TT/model_interest_management.h"
 #include "TT/model_radar.h"
+#include "TT/model_spatial_index.h"
 
 TEST(Radar, DefaultConstructor) {
   tt::simship::OwnshipChannel ownshipChannel;
   tt::simship::EnvironmentChannel environmentChannel;
-  tt::simship::RadarModel radar(ownshipChannel, environmentChannel);
+  tt::simship::RadarChannel radarChannel;
+  tt::simship::RadarModel radar(ownshipChannel, environmentChannel, radarChannel);
   ASSERT_TRUE(radar.load());
   ASSERT_TRUE(radar.init());
   ASSERT_TRUE(radar.reinit());
@@ -24,16 +30,17 @@ TEST(Radar, EnemyInView) {
 
   tt::simship::OwnshipChannel ownshipChannel;
   tt::simship::EnvironmentChannel environmentChannel;
-  environmentChannel.physicalEntities.getWriteHandle()->push_back(anEnemy);
-  tt::simship::RadarModel radar(ownshipChannel, environmentChannel);
+  tt::simship::RadarChannel radarChannel;
+  environmentChannel.physicalEntities.getWriteHandle()->add(anEnemy);
+  tt::simship::RadarModel radar(ownshipChannel, environmentChannel, radarChannel);
   ASSERT_TRUE(radar.load());
   ASSERT_TRUE(radar.init());
   ASSERT_TRUE(radar.reinit());
   ASSERT_TRUE(radar.run());
 
-  ASSERT_EQ(1, radarChannel::echos.size());
-  auto echo = radarChannel::echos.front();
-  radarChannel::echos.pop();
+  ASSERT_EQ(1, radarChannel.echoes.size());
+  Echo echo;
+  ASSERT_TRUE(radarChannel.echoes.pop(echo));
 
   ASSERT_TRUE(radar.hold());
   ASSERT_TRUE(radar.unload());
@@ -45,15 +52,202 @@ TEST(Radar, EnemyOutOfRange) {
 
   tt::simship::OwnshipChannel ownshipChannel;
   tt::simship::EnvironmentChannel environmentChannel;
-  environmentChannel.physicalEntities.getWriteHandle()->push_back(anEnemy);
-  tt::simship::RadarModel radar(ownshipChannel, environmentChannel);
+  tt::simship::RadarChannel radarChannel;
+  environmentChannel.physicalEntities.getWriteHandle()->add(anEnemy);
+  tt::simship::RadarModel radar(ownshipChannel, environmentChannel, radarChannel);
   ASSERT_TRUE(radar.load());
   ASSERT_TRUE(radar.init());
   ASSERT_TRUE(radar.reinit());
   ASSERT_TRUE(radar.run());
 
-  ASSERT_EQ(0, radarChannel::echos.size());
+  ASSERT_EQ(0, radarChannel.echoes.size());
 
   ASSERT_TRUE(radar.hold());
   ASSERT_TRUE(radar.unload());
 }
+
+TEST(Radar, EnemyInViewWithSpatialIndex) {
+  tt::rpr_fom::PhysicalEntity anEnemy;
+  anEnemy.Spatial.SpatialRVW.WorldLocation.X = 10000;
+  anEnemy.Spatial.SpatialRVW.WorldLocation.Y = 2;
+  anEnemy.Spatial.SpatialRVW.WorldLocation.Z = 2;
+  tt::rpr_fom::PhysicalEntity aFarEnemy;
+  aFarEnemy.Spatial.SpatialRVW.WorldLocation.X = 20000;
+
+  tt::simship::OwnshipChannel ownshipChannel;
+  tt::simship::EnvironmentChannel environmentChannel;
+  tt::simship::RadarChannel radarChannel;
+  environmentChannel.physicalEntities.getWriteHandle()->add(anEnemy);
+  environmentChannel.physicalEntities.getWriteHandle()->add(aFarEnemy);
+  tt::simship::SpatialIndexModel spatialIndex(environmentChannel);
+  tt::simship::RadarModel radar(ownshipChannel, environmentChannel, radarChannel);
+  ASSERT_TRUE(radar.load());
+  ASSERT_TRUE(spatialIndex.run());
+  ASSERT_TRUE(radar.run());
+
+  Echo echo;
+  ASSERT_TRUE(radarChannel.echoes.pop(echo));
+  ASSERT_NEAR(10000, echo.range, 1);
+  ASSERT_TRUE(radarChannel.echoes.empty());
+}
+
+TEST(Radar, EchoOverflowIsCounted) {
+  tt::simship::OwnshipChannel ownshipChannel;
+  tt::simship::EnvironmentChannel environmentChannel;
+  for (int i = 0; i < 3; ++i) {
+    tt::rpr_fom::PhysicalEntity anEnemy;
+    anEnemy.Spatial.SpatialRVW.WorldLocation.X = 9000 + i * 100;
+    environmentChannel.physicalEntities.getWriteHandle()->add(anEnemy);
+  }
+  tt::simship::RadarChannel radarChannel(2);
+  tt::simship::RadarChannel otherRadarChannel;
+  tt::simship::RadarModel radar(ownshipChannel, environmentChannel, radarChannel);
+  tt::simship::RadarModel otherRadar(ownshipChannel, environmentChannel, otherRadarChannel);
+  ASSERT_TRUE(radar.load());
+  ASSERT_TRUE(otherRadar.load());
+  ASSERT_TRUE(radar.run());
+  ASSERT_TRUE(otherRadar.run());
+
+  // Each radar has its own echoes, the full one drops and counts what does not fit
+  ASSERT_EQ(2, radarChannel.echoes.size());
+  ASSERT_EQ(1, radarChannel.echoes.getOverflowCount());
+  ASSERT_EQ(3, otherRadarChannel.echoes.size());
+  ASSERT_EQ(0, otherRadarChannel.echoes.getOverflowCount());
+}
+
+TEST(Radar, BatchMatchesSeparateRadars) {
+  tt::simship::EnvironmentChannel environmentChannel;
+  for (int i = 0; i < 200; ++i) {
+    tt::rpr_fom::PhysicalEntity anEnemy;
+    anEnemy.Spatial.SpatialRVW.WorldLocation.X = (i % 2 == 0 ? 1 : -1) * (1000 + i * 50);
+    anEnemy.Spatial.SpatialRVW.WorldLocation.Y = i * 10 - 1000;
+    environmentChannel.physicalEntities.getWriteHandle()->add(anEnemy);
+  }
+  tt::simship::SpatialIndexModel spatialIndex(environmentChannel);
+
+  // One ownship looking ahead, the other one looking back with a second, narrower antenna
+  tt::simship::OwnshipChannel ownshipChannel;
+  tt::simship::OwnshipChannel otherOwnshipChannel;
+  *otherOwnshipChannel.aircraftPosition.getWriteHandle() = Eigen::Vector3d(0, 500, 0);
+  *otherOwnshipChannel.aircraftRotation.getWriteHandle() = Eigen::Vector3d(0, 0, M_PI);
+  otherOwnshipChannel.aircraftPosition.publish();
+  otherOwnshipChannel.aircraftRotation.publish();
+  std::vector<std::unique_ptr<tt::simship::RadarChannel>> radarChannels;
+  std::vector<std::unique_ptr<tt::simship::RadarChannel>> batchRadarChannels;
+  for (int i = 0; i < 3; ++i) {
+    radarChannels.push_back(std::make_unique<tt::simship::RadarChannel>());
+    batchRadarChannels.push_back(std::make_unique<tt::simship::RadarChannel>());
+    if (i == 2) {
+      *radarChannels.back()->horizontalFieldOfView.getWriteHandle() = 0.3;
+      *batchRadarChannels.back()->horizontalFieldOfView.getWriteHandle() = 0.3;
+    }
+  }
+
+  tt::simship::RadarModel radar(ownshipChannel, environmentChannel, *radarChannels[0]);
+  tt::simship::RadarModel otherRadar(otherOwnshipChannel, environmentChannel, *radarChannels[1]);
+  tt::simship::RadarModel narrowRadar(otherOwnshipChannel, environmentChannel, *radarChannels[2]);
+  tt::simship::RadarBatchModel batch(environmentChannel);
+  ASSERT_EQ(0, batch.addRadar(ownshipChannel, *batchRadarChannels[0]));
+  ASSERT_EQ(1, batch.addRadar(otherOwnshipChannel, *batchRadarChannels[1]));
+  ASSERT_EQ(2, batch.addRadar(otherOwnshipChannel, *batchRadarChannels[2]));
+  ASSERT_EQ(3, batch.getRadarCount());
+  ASSERT_TRUE(radar.load());
+  ASSERT_TRUE(otherRadar.load());
+  ASSERT_TRUE(narrowRadar.load());
+  ASSERT_TRUE(batch.load());
+
+  // Once scanning every entity, once with the spatial index
+  for (const bool indexed : {false, true}) {
+    if (indexed) {
+      ASSERT_TRUE(spatialIndex.run());
+    }
+    ASSERT_TRUE(radar.run());
+    ASSERT_TRUE(otherRadar.run());
+    ASSERT_TRUE(narrowRadar.run());
+    ASSERT_TRUE(batch.run());
+
+    const tt::simship::RadarModel* separate[] = {&radar, &otherRadar, &narrowRadar};
+    for (size_t i = 0; i < 3; ++i) {
+      const std::vector<Echo>& expected = separate[i]->getEchoes();
+      const std::vector<Echo>& actual = batch.getEchoes(i);
+      ASSERT_FALSE(expected.empty());
+      ASSERT_EQ(expected.size(), actual.size());
+      for (size_t echo = 0; echo < expected.size(); ++echo) {
+        ASSERT_EQ(expected[echo].range, actual[echo].range);
+        ASSERT_EQ(expected[echo].horizontalAngle, actual[echo].horizontalAngle);
+      }
+      ASSERT_EQ(expected.size(), batchRadarChannels[i]->echoes.size());
+      batchRadarChannels[i]->echoes.clear();
+      radarChannels[i]->echoes.clear();
+    }
+    ASSERT_LT(batch.getEchoes(2).size(), batch.getEchoes(1).size());
+  }
+}
+
+TEST(Radar, InterestViewMatchesSpatialIndex) {
+  tt::simship::EnvironmentChannel environmentChannel;
+  for (int i = 0; i < 400; ++i) {
+    tt::rpr_fom::PhysicalEntity anEnemy;
+    anEnemy.EntityType.EntityKind = 1;
+    anEnemy.EntityType.Domain = i % 3 == 0 ? 1 : 2;
+    anEnemy.Spatial.SpatialRVW.WorldLocation.X = (i % 2 == 0 ? 1 : -1) * (1000 + i * 25);
+    anEnemy.Spatial.SpatialRVW.WorldLocation.Y = i * 10 - 2000;
+    anEnemy.Spatial.SpatialRVW.WorldLocation.Z = i % 3 * 500;
+    environmentChannel.physicalEntities.getWriteHandle()->add(anEnemy);
+  }
+  tt::simship::OwnshipChannel ownshipChannel;
+  tt::simship::RadarChannel radarChannel;
+  tt::simship::RadarChannel interestRadarChannel;
+  tt::simship::RadarChannel airRadarChannel;
+  for (tt::simship::RadarChannel* channel : {&radarChannel, &interestRadarChannel, &airRadarChannel}) {
+    *channel->horizontalFieldOfView.getWriteHandle() = 1;
+    *channel->verticalFieldOfView.getWriteHandle() = 1;
+  }
+  tt::simship::SpatialIndexModel spatialIndex(environmentChannel);
+  tt::simship::InterestManagementModel interestManagement(environmentChannel);
+  tt::simship::RadarModel radar(ownshipChannel, environmentChannel, radarChannel);
+  tt::simship::RadarModel interestRadar(ownshipChannel, environmentChannel, interestRadarChannel);
+  tt::simship::RadarModel airRadar(ownshipChannel, environmentChannel, airRadarChannel);
+  interestRadar.setInterest(interestManagement.subscribeRadar(ownshipChannel, interestRadarChannel));
+  airRadar.setInterest(interestManagement.subscribeRadar(ownshipChannel, airRadarChannel, {{1, 2}}));
+  const auto nearby = interestManagement.subscribeAroundOwnship(ownshipChannel, 3000);
+  // The views are updated at the rate of the radars reading them
+  ASSERT_EQ(radar.getTargetFrameInterval(), interestManagement.getTargetFrameInterval());
+  // Building the frames of the radars does not make the interest management a writer of their outputs
+  ASSERT_EQ(std::vector<const tt::BusDataBase*>{&environmentChannel.interest}, interestManagement.getWrites());
+  ASSERT_TRUE(radar.load());
+  ASSERT_TRUE(interestRadar.load());
+  ASSERT_TRUE(airRadar.load());
+  ASSERT_TRUE(interestManagement.load());
+
+  // Turning the ownship around, so the view follows the radar volume
+  for (const double heading : {0.0, M_PI}) {
+    *ownshipChannel.aircraftRotation.getWriteHandle() = Eigen::Vector3d(0, 0, heading);
+    ownshipChannel.aircraftRotation.publish();
+    ASSERT_TRUE(spatialIndex.run());
+    ASSERT_TRUE(interestManagement.run());
+    ASSERT_TRUE(radar.run());
+    ASSERT_TRUE(interestRadar.run());
+    ASSERT_TRUE(airRadar.run());
+
+    const std::vector<Echo>& expected = radar.getEchoes();
+    const std::vector<Echo>& actual = interestRadar.getEchoes();
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t echo = 0; echo < expected.size(); ++echo) {
+      ASSERT_EQ(expected[echo].range, actual[echo].range);
+      ASSERT_EQ(expected[echo].horizontalAngle, actual[echo].horizontalAngle);
+    }
+
+    // The view holds fewer entities than the store, and a third of the detected ones are not airborne
+    const tt::InterestManager& interest = *environmentChannel.interest.getReadHandle();
+    ASSERT_LT(interest.getView(0)->size(), environmentChannel.physicalEntities.getReadHandle()->size());
+    ASSERT_LT(airRadar.getEchoes().size(), expected.size());
+    ASSERT_GT(airRadar.getEchoes().size(), expected.size() / 2);
+    ASSERT_EQ(interest.getView(nearby)->size(), interest.getView(nearby)->getHandles().size());
+    ASSERT_GT(interest.getView(nearby)->size(), 0);
+    radarChannel.echoes.clear();
+    interestRadarChannel.echoes.clear();
+    airRadarChannel.echoes.clear();
+  }
+}
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "TT/radar_detection.h"
+#include "TT/transform.h"
+
+namespace {
+  /// The per entity detection as originally implemented by RadarModel, used as the reference for the batch kernel.
+  std::vector<Echo> referenceDetection(const tt::Transform& radarXform, const Eigen::Vector3d& platformVelocity,
+                                       const tt::simship::RadarDetectionFrame& frame, const tt::EntityStore& entities) {
+    std::vector<Echo> echoes;
+    const auto positions = entities.getPositions();
+    const auto orientations = entities.getOrientations();
+    const auto velocities = entities.getVelocities();
+    for (size_t entity = 0; entity < entities.size(); ++entity) {
+      const tt::Transform entityWorldXform(positions.x[entity], positions.y[entity], positions.z[entity],
+                                           orientations.z[entity], orientations.y[entity], orientations.x[entity]);
+      const auto otherOffset = radarXform.toLocalTransform(entityWorldXform).getLocalTranslation();
+      if (otherOffset.x() < 0) {
+        continue;
+      }
+      const double horizontalAngle = std::atan2(otherOffset.y(), otherOffset.x());
+      const double verticalAngle = std::atan2(otherOffset.z(), otherOffset.x());
+      if (std::abs(horizontalAngle) > frame.halfHorizontalFieldOfView ||
+          std::abs(verticalAngle) > frame.halfVerticalFieldOfView) {
+        continue;
+      }
+      const double distance = otherOffset.norm();
+      const double returnPower = ((frame.power * frame.gain) / (M_PI_4 * (distance * distance)))
+        * frame.radarCrossSection
+        * (1.0 / (M_PI_4 * (distance * distance)))
+        * frame.effectiveArea;
+      if (returnPower < frame.minimumDetectableSignal) {
+        continue;
+      }
+      const Eigen::Vector3d velocity(velocities.x[entity], velocities.y[entity], velocities.z[entity]);
+      Echo echo;
+      echo.range = distance;
+      echo.horizontalAngle = horizontalAngle;
+      echo.verticalAngle = verticalAngle;
+      echo.radialVelocity = (radarXform.toLocalVector(velocity) - radarXform.toLocalVector(platformVelocity)).x();
+      echo.returnPower = returnPower;
+      echoes.push_back(echo);
+    }
+    return echoes;
+  }
+}
+
+TEST(RadarDetection, MatchesPerEntityReference) {
+  std::mt19937 random(42);
+  std::uniform_real_distribution<double> position(-30000, 30000);
+  std::uniform_real_distribution<float> velocity(-300, 300);
+
+  tt::EntityStore entities;
+  for (int i = 0; i < 5000; ++i) {
+    tt::rpr_fom::PhysicalEntity entity;
+    entity.Spatial.SpatialRVW.WorldLocation = {position(random), position(random), position(random)};
+    entity.Spatial.SpatialRVW.VelocityVector = {velocity(random), velocity(random), velocity(random)};
+    entities.add(entity);
+  }
+
+  const tt::Transform radarXform(100, -200, 50, 0.1, -0.2, 0.7);
+  const Eigen::Vector3d platformVelocity(200, 10, -5);
+  tt::simship::RadarDetectionFrame frame = tt::simship::RadarDetectionFrame::fromWorldTransform(
+    radarXform.getLocalRotationMatrix(), radarXform.getLocalTranslation(), platformVelocity);
+  frame.halfHorizontalFieldOfView = 0.6;
+  frame.halfVerticalFieldOfView = 0.4;
+  frame.power = 1500;
+  frame.gain = 1;
+  frame.effectiveArea = 1;
+  frame.minimumDetectableSignal = 9.0e-14;
+  frame.radarCrossSection = 3.5;
+
+  const std::vector<Echo> expected = referenceDetection(radarXform, platformVelocity, frame, entities);
+  std::vector<Echo> actual;
+  tt::simship::detectEchoes(frame, entities, [&actual](const Echo& echo) {
+    actual.push_back(echo);
+  });
+
+  ASSERT_FALSE(expected.empty());
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_NEAR(expected[i].range, actual[i].range, 1e-6);
+    ASSERT_NEAR(expected[i].horizontalAngle, actual[i].horizontalAngle, 1e-12);
+    ASSERT_NEAR(expected[i].verticalAngle, actual[i].verticalAngle, 1e-12);
+    ASSERT_NEAR(expected[i].radialVelocity, actual[i].radialVelocity, 1e-9);
+    ASSERT_NEAR(expected[i].returnPower, actual[i].returnPower, expected[i].returnPower * 1e-12);
+  }
+}
+
+TEST(RadarDetection, UsesAspectOfSignature) {
+  // Only visible from the front half, 100 square meters nose on
+  tt::RadarCrossSectionLibrary signatures;
+  ASSERT_TRUE(signatures.add(4, 4, 2, {0, 0, 100, 0, 0, 0, 100, 0}));
+
+  // Two targets 30 km ahead, one heading towards and one away from the radar, and one without a signature
+  tt::EntityStore entities;
+  for (const float psi : {static_cast<float>(M_PI), 0.0f, 0.0f}) {
+    tt::rpr_fom::PhysicalEntity entity;
+    entity.Spatial.SpatialRVW.WorldLocation = {30000, 0, 0};
+    entity.Spatial.SpatialRVW.Orientation.Psi = psi;
+    entity.RadarCrossSectionSignatureIndex = entities.size() < 2 ? 4 : -1;
+    entities.add(entity);
+  }
+
+  tt::simship::RadarDetectionFrame frame = tt::simship::RadarDetectionFrame::fromWorldTransform(
+    Eigen::Matrix3d::Identity(), Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero());
+  frame.halfHorizontalFieldOfView = 0.6;
+  frame.halfVerticalFieldOfView = 0.4;
+  frame.power = 1500;
+  frame.gain = 1;
+  frame.effectiveArea = 1;
+  frame.minimumDetectableSignal = 9.0e-14;
+  frame.radarCrossSection = 3.5;
+  frame.signatures = &signatures;
+
+  // The range gate covers the largest radar cross section, far beyond the range for the default
+  ASSERT_DOUBLE_EQ(100, frame.getLargestRadarCrossSection());
+  ASSERT_GT(frame.getMaximumRange(), 30000);
+
+  std::vector<Echo> echoes;
+  tt::simship::detectEchoes(frame, entities, [&echoes](const Echo& echo) {
+    echoes.push_back(echo);
+  });
+  ASSERT_EQ(1, echoes.size());
+  const double distance = 30000;
+  ASSERT_NEAR(1500 * 100 / (M_PI_4 * M_PI_4 * distance * distance * distance * distance), echoes[0].returnPower,
+              echoes[0].returnPower * 1e-6);
+
+  // Without signatures every entity has the default radar cross section, which is out of range
+  frame.signatures = nullptr;
+  echoes.clear();
+  tt::simship::detectEchoes(frame, entities, [&echoes](const Echo& echo) {
+    echoes.push_back(echo);
+  });
+  ASSERT_TRUE(echoes.empty());
+}
+
+TEST(RadarDetection, BatchMatchesSingleRadars) {
+  std::mt19937 random(7);
+  std::uniform_real_distribution<double> position(-30000, 30000);
+  std::uniform_real_distribution<double> angle(-3, 3);
+
+  tt::EntityStore entities;
+  for (int i = 0; i < 3000; ++i) {
+    tt::rpr_fom::PhysicalEntity entity;
+    entity.Spatial.SpatialRVW.WorldLocation = {position(random), position(random), position(random)};
+    entities.add(entity);
+  }
+
+  std::vector<tt::simship::RadarDetectionFrame> frames;
+  for (int radar = 0; radar < 4; ++radar) {
+    const tt::Transform radarXform(position(random) / 10, position(random) / 10, position(random) / 10,
+                                   angle(random), angle(random) / 2, angle(random));
+    tt::simship::RadarDetectionFrame frame = tt::simship::RadarDetectionFrame::fromWorldTransform(
+      radarXform.getLocalRotationMatrix(), radarXform.getLocalTranslation(), Eigen::Vector3d(100, 0, 0));
+    frame.halfHorizontalFieldOfView = 0.4 + 0.2 * radar;
+    frame.halfVerticalFieldOfView = 0.4;
+    frame.power = 1500;
+    frame.gain = 1;
+    frame.effectiveArea = 1;
+    frame.minimumDetectableSignal = 9.0e-14;
+    frame.radarCrossSection = 3.5 * (radar + 1);
+    frames.push_back(frame);
+  }
+
+  std::vector<uint32_t> indices;
+  for (uint32_t i = 0; i < entities.size(); i += 3) {
+    indices.push_back(i);
+  }
+
+  std::vector<std::vector<Echo>> batch(frames.size());
+  std::vector<std::vector<Echo>> batchSubset(frames.size());
+  tt::simship::detectEchoes(frames, entities, [&batch](const size_t radar, const Echo& echo) {
+    batch[radar].push_back(echo);
+  });
+  tt::simship::detectEchoes(frames, entities, indices, [&batchSubset](const size_t radar, const Echo& echo) {
+    batchSubset[radar].push_back(echo);
+  });
+
+  for (size_t radar = 0; radar < frames.size(); ++radar) {
+    std::vector<Echo> single;
+    tt::simship::detectEchoes(frames[radar], entities, [&single](const Echo& echo) {
+      single.push_back(echo);
+    });
+    std::vector<Echo> singleSubset;
+    tt::simship::detectEchoes(frames[radar], entities, indices, [&singleSubset](const Echo& echo) {
+      singleSubset.push_back(echo);
+    });
+
+    ASSERT_FALSE(single.empty());
+    ASSERT_EQ(single.size(), batch[radar].size());
+    for (size_t i = 0; i < single.size(); ++i) {
+      ASSERT_EQ(single[i].range, batch[radar][i].range);
+      ASSERT_EQ(single[i].returnPower, batch[radar][i].returnPower);
+    }
+    ASSERT_EQ(singleSubset.size(), batchSubset[radar].size());
+    for (size_t i = 0; i < singleSubset.size(); ++i) {
+      ASSERT_EQ(singleSubset[i].range, batchSubset[radar][i].range);
+    }
+  }
+}
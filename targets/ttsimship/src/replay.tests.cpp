@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <TT/recorder.h>
+#include <TT/replayer.h>
+#include <TT/simulation.h>
+
+#include "TT/model_dead_reckoning.h"
+#include "TT/model_radar.h"
+#include "TT/model_spatial_index.h"
+
+namespace {
+  tt::rpr_fom::PhysicalEntity inboundTarget(const double x, const double y) {
+    tt::rpr_fom::PhysicalEntity target;
+    target.Spatial.DeadReckoningAlgorithm = tt::rpr_fom::DeadReckoningAlgorithmEnum8::DRM_FVW;
+    target.Spatial.SpatialRVW.WorldLocation = {x, y, 0};
+    target.Spatial.SpatialRVW.VelocityVector = {-250, 0, 0};
+    return target;
+  }
+}
+
+TEST(Replay, RadarSeesRecordedTraffic) {
+  const std::string path = testing::TempDir() + "RadarSeesRecordedTraffic.ttrec";
+  std::vector<std::vector<Echo>> recordedEchoes;
+
+  // Live: dead reckoned targets observed by the radar, recording the entities and echoes of every frame
+  {
+    tt::simship::OwnshipChannel ownshipChannel;
+    tt::simship::EnvironmentChannel environmentChannel;
+    tt::simship::RadarChannel radarChannel;
+    for (int i = 0; i < 10; ++i) {
+      environmentChannel.physicalEntities.getWriteHandle()->add(inboundTarget(12000 + 1000 * i, 100 * i));
+    }
+    tt::simship::DeadReckoningModel deadReckoning(environmentChannel);
+    tt::simship::SpatialIndexModel spatialIndex(environmentChannel);
+    tt::simship::RadarModel radar(ownshipChannel, environmentChannel, radarChannel);
+
+    tt::Recorder recorder;
+    ASSERT_TRUE(recorder.addBusData(environmentChannel.physicalEntities));
+    ASSERT_TRUE(recorder.addStream("Radar.Echoes", [&radar](std::vector<uint8_t>& buffer) {
+      radar.recordEchoes(buffer);
+    }));
+    ASSERT_TRUE(recorder.open(path));
+
+    tt::Simulation simulation;
+    simulation.setClockMode(tt::Simulation::FreeRunning);
+    simulation.setBaseFrameInterval(std::chrono::milliseconds(100));
+    simulation.addModel(deadReckoning);
+    simulation.addModel(spatialIndex);
+    simulation.addModel(radar);
+    simulation.addFrameListener([&](const std::chrono::nanoseconds simulationTime) {
+      recorder.recordFrame(simulationTime);
+      recordedEchoes.push_back(radar.getEchoes());
+    });
+    ASSERT_TRUE(simulation.runFor(std::chrono::seconds(10)));
+    ASSERT_TRUE(recorder.close());
+  }
+
+  // Replay: the recorded entities feed a new radar, without dead reckoning
+  tt::Replayer replayer;
+  ASSERT_TRUE(replayer.open(path));
+  ASSERT_EQ(recordedEchoes.size(), replayer.getFrameCount());
+
+  tt::simship::OwnshipChannel ownshipChannel;
+  tt::simship::EnvironmentChannel environmentChannel;
+  tt::simship::RadarChannel radarChannel;
+  tt::ReplayModel replay(replayer, 100);
+  ASSERT_TRUE(replay.bind(environmentChannel.physicalEntities));
+  tt::simship::SpatialIndexModel spatialIndex(environmentChannel);
+  tt::simship::RadarModel radar(ownshipChannel, environmentChannel, radarChannel);
+
+  tt::Simulation simulation;
+  simulation.setClockMode(tt::Simulation::FreeRunning);
+  simulation.setBaseFrameInterval(std::chrono::milliseconds(100));
+  simulation.addModel(replay);
+  simulation.addModel(spatialIndex);
+  simulation.addModel(radar);
+
+  size_t echoStream;
+  ASSERT_TRUE(replayer.findStream("Radar.Echoes", echoStream));
+  size_t echoCount = 0;
+  for (size_t frame = 0; frame < replayer.getFrameCount(); ++frame) {
+    ASSERT_TRUE(simulation.runFor(std::chrono::milliseconds(100)));
+    const auto [data, size] = replayer.getData(frame, echoStream);
+    tt::ByteReader reader(data, size);
+    std::vector<Echo> echoes;
+    ASSERT_TRUE(tt::Serialiser<std::vector<Echo>>::read(reader, echoes));
+    ASSERT_EQ(recordedEchoes[frame].size(), echoes.size());
+    ASSERT_EQ(echoes.size(), radar.getEchoes().size());
+    for (size_t i = 0; i < echoes.size(); ++i) {
+      ASSERT_EQ(echoes[i].range, radar.getEchoes()[i].range);
+      ASSERT_EQ(echoes[i].radialVelocity, radar.getEchoes()[i].radialVelocity);
+    }
+    echoCount += echoes.size();
+  }
+  ASSERT_GT(echoCount, 0);
+  replayer.close();
+  std::remove(path.c_str());
+}
+
+TEST(Replay, RecordsEachEchoOnce) {
+  const std::string path = testing::TempDir() + "RecordsEachEchoOnce.ttrec";
+  size_t emittedEchoCount = 0;
+  uint64_t radarRuns = 0;
+
+  // The simulation is recorded every 10 ms base frame, while the radar runs every 100 ms
+  {
+    tt::simship::OwnshipChannel ownshipChannel;
+    tt::simship::EnvironmentChannel environmentChannel;
+    tt::simship::RadarChannel radarChannel;
+    for (int i = 0; i < 10; ++i) {
+      environmentChannel.physicalEntities.getWriteHandle()->add(inboundTarget(12000 + 1000 * i, 100 * i));
+    }
+    tt::simship::DeadReckoningModel deadReckoning(environmentChannel);
+    tt::simship::RadarModel radar(ownshipChannel, environmentChannel, radarChannel);
+
+    tt::Recorder recorder;
+    ASSERT_TRUE(recorder.addStream("Radar.Echoes", [&radar](std::vector<uint8_t>& buffer) {
+      radar.recordEchoes(buffer);
+    }));
+    ASSERT_TRUE(recorder.open(path));
+
+    tt::Simulation simulation;
+    simulation.setClockMode(tt::Simulation::FreeRunning);
+    simulation.setBaseFrameInterval(std::chrono::milliseconds(10));
+    simulation.addModel(deadReckoning);
+    simulation.addModel(radar);
+    simulation.addFrameListener([&](const std::chrono::nanoseconds simulationTime) {
+      recorder.recordFrame(simulationTime);
+      // Each echo is consumed from the channel exactly once
+      Echo echo;
+      while (radarChannel.echoes.pop(echo)) {
+        ++emittedEchoCount;
+      }
+    });
+    ASSERT_TRUE(simulation.runFor(std::chrono::seconds(1)));
+    ASSERT_TRUE(recorder.close());
+    radarRuns = radar.getFrameCount();
+  }
+  ASSERT_EQ(10, radarRuns);
+  ASSERT_GT(emittedEchoCount, 0);
+
+  tt::Replayer replayer;
+  ASSERT_TRUE(replayer.open(path));
+  ASSERT_EQ(100, replayer.getFrameCount());
+  size_t echoStream;
+  ASSERT_TRUE(replayer.findStream("Radar.Echoes", echoStream));
+  size_t recordedEchoCount = 0;
+  size_t framesWithEchoes = 0;
+  for (size_t frame = 0; frame < replayer.getFrameCount(); ++frame) {
+    const auto [data, size] = replayer.getData(frame, echoStream);
+    tt::ByteReader reader(data, size);
+    std::vector<Echo> echoes;
+    ASSERT_TRUE(tt::Serialiser<std::vector<Echo>>::read(reader, echoes));
+    recordedEchoCount += echoes.size();
+    framesWithEchoes += echoes.empty() ? 0 : 1;
+  }
+  ASSERT_EQ(emittedEchoCount, recordedEchoCount);
+  ASSERT_LE(framesWithEchoes, radarRuns);
+  replayer.close();
+  std::remove(path.c_str());
+}
@@ -0,0 +1,250 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "TT/model_radar.h"
+#include "TT/model_track_manager.h"
+#include "TT/radar_detection.h"
+#include "TT/simulation.h"
+#include "TT/tracker.h"
+#include "TT/transform.h"
+
+namespace {
+  /// Moves every target by its velocity and returns the positions, one scan each deltaTime seconds
+  std::vector<Eigen::Vector3d> advance(std::vector<Eigen::Vector3d>& targets,
+                                       const std::vector<Eigen::Vector3d>& velocities, const double deltaTime) {
+    for (size_t i = 0; i < targets.size(); ++i) {
+      targets[i] += velocities[i] * deltaTime;
+    }
+    return targets;
+  }
+}
+
+TEST(Tracker, EchoesConvertBackToEntityPositions) {
+  std::mt19937 random(42);
+  std::uniform_real_distribution<double> position(-15000, 15000);
+  tt::EntityStore entities;
+  for (int i = 0; i < 2000; ++i) {
+    tt::rpr_fom::PhysicalEntity entity;
+    entity.Spatial.SpatialRVW.WorldLocation = {position(random), position(random), position(random)};
+    entities.add(entity);
+  }
+
+  const tt::Transform radarXform(100, -200, 50, 0.1, -0.2, 0.7);
+  tt::simship::RadarDetectionFrame frame = tt::simship::RadarDetectionFrame::fromWorldTransform(
+    radarXform.getLocalRotationMatrix(), radarXform.getLocalTranslation(), Eigen::Vector3d::Zero());
+  frame.halfHorizontalFieldOfView = 0.6;
+  frame.halfVerticalFieldOfView = 0.4;
+  frame.power = 1500;
+  frame.gain = 1;
+  frame.effectiveArea = 1;
+  frame.minimumDetectableSignal = 9.0e-14;
+  frame.radarCrossSection = 3.5;
+
+  std::vector<Eigen::Vector3d> detected;
+  tt::simship::detectEchoes(frame, entities, [&](const Echo& echo) {
+    detected.push_back(tt::simship::Tracker::toWorldPosition(echo, radarXform.getLocalRotationMatrix(),
+                                                             radarXform.getLocalTranslation()));
+  });
+
+  // Echoes are produced in entity order, so match every detection with the closest entity
+  ASSERT_FALSE(detected.empty());
+  const auto positions = entities.getPositions();
+  for (const Eigen::Vector3d& detection : detected) {
+    double closest = 1e9;
+    for (size_t entity = 0; entity < entities.size(); ++entity) {
+      closest = std::min(closest, (detection - Eigen::Vector3d(positions.x[entity], positions.y[entity],
+                                                               positions.z[entity])).norm());
+    }
+    ASSERT_LT(closest, 1e-6);
+  }
+}
+
+TEST(Tracker, ConfirmsAndFollowsConstantVelocityTarget) {
+  tt::simship::Tracker tracker;
+  std::vector<Eigen::Vector3d> targets = {Eigen::Vector3d(10000, 500, -2000)};
+  const std::vector<Eigen::Vector3d> velocities = {Eigen::Vector3d(-200, 30, 5)};
+
+  tracker.update(targets, 0.1);
+  ASSERT_EQ(1, tracker.getTracks().size());
+  ASSERT_FALSE(tracker.getTracks()[0].confirmed);
+  tracker.update(advance(targets, velocities, 0.1), 0.1);
+  ASSERT_FALSE(tracker.getTracks()[0].confirmed);
+  tracker.update(advance(targets, velocities, 0.1), 0.1);
+  ASSERT_TRUE(tracker.getTracks()[0].confirmed);
+
+  for (int scan = 0; scan < 20; ++scan) {
+    tracker.update(advance(targets, velocities, 0.1), 0.1);
+  }
+  ASSERT_EQ(1, tracker.getTracks().size());
+  const Track& track = tracker.getTracks()[0];
+  ASSERT_EQ(1, track.id);
+  ASSERT_EQ(23, track.hitCount);
+  ASSERT_NEAR(targets[0].x(), track.x, 1e-6);
+  ASSERT_NEAR(targets[0].y(), track.y, 1e-6);
+  ASSERT_NEAR(targets[0].z(), track.z, 1e-6);
+  ASSERT_NEAR(-200, track.velocityX, 1e-6);
+  ASSERT_NEAR(30, track.velocityY, 1e-6);
+  ASSERT_NEAR(5, track.velocityZ, 1e-6);
+}
+
+TEST(Tracker, DropsLostTracks) {
+  tt::simship::TrackerParameters parameters;
+  parameters.confirmationHitCount = 2;
+  parameters.maximumMissCount = 2;
+  tt::simship::Tracker tracker(parameters);
+
+  // A confirmed track and a tentative one from clutter
+  tracker.update({Eigen::Vector3d(0, 0, 0)}, 0.1);
+  tracker.update({Eigen::Vector3d(10, 0, 0), Eigen::Vector3d(50000, 0, 0)}, 0.1);
+  ASSERT_EQ(2, tracker.getTracks().size());
+  ASSERT_TRUE(tracker.getTracks()[0].confirmed);
+  ASSERT_FALSE(tracker.getTracks()[1].confirmed);
+
+  // The tentative track is dropped on its first miss, the confirmed one coasts along its velocity
+  tracker.update({}, 0.1);
+  ASSERT_EQ(1, tracker.getTracks().size());
+  ASSERT_EQ(1, tracker.getTracks()[0].missCount);
+  ASSERT_NEAR(20, tracker.getTracks()[0].x, 1e-9);
+  tracker.update({}, 0.1);
+  ASSERT_EQ(1, tracker.getTracks().size());
+
+  // Found again within the gate of its prediction
+  tracker.update({Eigen::Vector3d(45, 0, 0)}, 0.1);
+  ASSERT_EQ(1, tracker.getTracks().size());
+  ASSERT_EQ(1, tracker.getTracks()[0].id);
+  ASSERT_EQ(0, tracker.getTracks()[0].missCount);
+
+  for (int scan = 0; scan < 3; ++scan) {
+    tracker.update({}, 0.1);
+  }
+  ASSERT_TRUE(tracker.getTracks().empty());
+
+  // Ids are not reused
+  tracker.update({Eigen::Vector3d(0, 0, 0)}, 0.1);
+  ASSERT_EQ(3, tracker.getTracks()[0].id);
+}
+
+TEST(Tracker, AssociatesDenseTargets) {
+  // Thousands of targets 600 m apart, so every echo has several tracks of its neighbouring cells to choose from
+  std::vector<Eigen::Vector3d> targets;
+  std::vector<Eigen::Vector3d> velocities;
+  std::mt19937 random(3);
+  std::uniform_real_distribution<double> speed(-250, 250);
+  for (int x = 0; x < 20; ++x) {
+    for (int y = 0; y < 20; ++y) {
+      for (int z = 0; z < 10; ++z) {
+        targets.emplace_back(x * 600, y * 600, z * 600);
+        velocities.emplace_back(speed(random), speed(random), speed(random) / 10);
+      }
+    }
+  }
+
+  tt::simship::Tracker tracker;
+  tracker.update(targets, 0.1);
+  for (int scan = 0; scan < 10; ++scan) {
+    // Echoes arrive in a different order every scan
+    std::vector<Eigen::Vector3d> echoes = advance(targets, velocities, 0.1);
+    std::shuffle(echoes.begin(), echoes.end(), random);
+    tracker.update(echoes, 0.1);
+  }
+
+  // Every target kept its own track
+  const std::vector<Track>& tracks = tracker.getTracks();
+  ASSERT_EQ(targets.size(), tracks.size());
+  for (size_t i = 0; i < tracks.size(); ++i) {
+    ASSERT_EQ(i + 1, tracks[i].id);
+    ASSERT_TRUE(tracks[i].confirmed);
+    ASSERT_EQ(11, tracks[i].hitCount);
+  }
+}
+
+TEST(TrackManager, TracksRadarEchoes) {
+  tt::simship::OwnshipChannel ownshipChannel;
+  tt::simship::EnvironmentChannel environmentChannel;
+  tt::simship::RadarChannel radarChannel;
+  tt::simship::TrackChannel trackChannel;
+  for (int i = 0; i < 5; ++i) {
+    tt::rpr_fom::PhysicalEntity anEnemy;
+    anEnemy.Spatial.SpatialRVW.WorldLocation.X = 8000 + i * 1000;
+    anEnemy.Spatial.SpatialRVW.WorldLocation.Y = i * 1000 - 2000;
+    environmentChannel.physicalEntities.getWriteHandle()->add(anEnemy);
+  }
+
+  tt::simship::RadarModel radar(ownshipChannel, environmentChannel, radarChannel);
+  tt::simship::TrackManagerModel trackManager(ownshipChannel, radarChannel, trackChannel);
+  ASSERT_TRUE(radar.load());
+  ASSERT_TRUE(trackManager.load());
+  ASSERT_TRUE(trackManager.init());
+  trackManager.setDeltaTime(0.1);
+
+  const auto tracks = trackChannel.tracks.getReadHandle();
+  for (int scan = 0; scan < 3; ++scan) {
+    ASSERT_TRUE(radar.run());
+    ASSERT_TRUE(trackManager.run());
+  }
+  ASSERT_TRUE(radarChannel.echoes.empty());
+  ASSERT_EQ(radar.getEchoes().size(), tracks->size());
+  ASSERT_FALSE(tracks->empty());
+  for (const Track& track : *tracks) {
+    ASSERT_TRUE(track.confirmed);
+    ASSERT_NEAR(0, track.z, 1e-6);
+  }
+
+  // The tracks survive a snapshot of the model state
+  std::vector<uint8_t> state;
+  ASSERT_TRUE(trackManager.saveState(state));
+  ASSERT_TRUE(trackManager.init());
+  ASSERT_TRUE(trackManager.run());
+  tt::ByteReader reader(state.data(), state.size());
+  ASSERT_TRUE(trackManager.restoreState(reader));
+  ASSERT_TRUE(radar.run());
+  ASSERT_TRUE(trackManager.run());
+  ASSERT_EQ(radar.getEchoes().size(), tracks->size());
+  ASSERT_EQ(1, tracks->front().id);
+  ASSERT_EQ(4, tracks->front().hitCount);
+}
+
+TEST(TrackManager, RunsAfterRadarInParallelMode) {
+  tt::simship::OwnshipChannel ownshipChannel;
+  tt::simship::EnvironmentChannel environmentChannel;
+  tt::simship::RadarChannel radarChannel;
+  tt::simship::TrackChannel trackChannel;
+  for (int i = 0; i < 5; ++i) {
+    tt::rpr_fom::PhysicalEntity anEnemy;
+    anEnemy.Spatial.SpatialRVW.WorldLocation.X = 8000 + i * 1000;
+    anEnemy.Spatial.SpatialRVW.WorldLocation.Y = i * 1000 - 2000;
+    environmentChannel.physicalEntities.getWriteHandle()->add(anEnemy);
+  }
+
+  tt::simship::RadarModel radar(ownshipChannel, environmentChannel, radarChannel);
+  tt::simship::TrackManagerModel trackManager(ownshipChannel, radarChannel, trackChannel);
+  tt::Simulation simulation;
+  simulation.setClockMode(tt::Simulation::FreeRunning);
+  simulation.setBaseFrameInterval(std::chrono::milliseconds(10));
+  simulation.setExecutionMode(tt::Simulation::Parallel, 2);
+  simulation.addModel(radar);
+  simulation.addModel(trackManager);
+
+  // After every frame the tracker has processed the whole scan the radar produced in that frame, rather than running
+  // before or alongside the radar
+  const auto tracks = trackChannel.tracks.getReadHandle();
+  const auto scanCount = radarChannel.scanCount.getReadHandle();
+  size_t checkedFrames = 0;
+  simulation.addFrameListener([&](std::chrono::nanoseconds) {
+    ASSERT_TRUE(radarChannel.echoes.empty());
+    ASSERT_EQ(radar.getFrameCount(), *scanCount);
+    ASSERT_EQ(radar.getEchoes().size(), tracks->size());
+    for (const Track& track : *tracks) {
+      ASSERT_EQ(*scanCount, track.hitCount);
+    }
+    ++checkedFrames;
+  });
+  ASSERT_TRUE(simulation.runFor(std::chrono::seconds(1)));
+  ASSERT_EQ(10, checkedFrames);
+  ASSERT_EQ(10, *scanCount);
+  ASSERT_FALSE(tracks->empty());
+}